@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/cjson_thread_pool.hpp"
+#include "../include/detail/input/cjson_batch_parser.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+template <typename Run>
+auto measure(const std::string& name, const std::size_t documents, Run run) -> void {
+    const auto start = std::chrono::steady_clock::now();
+    const auto checksum = run();
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() << " ms, "
+              << static_cast<double>(documents) / (elapsed.count() / 1000.0) << " documents/s (checksum " << checksum
+              << ")\n";
+}
+
+int main() {
+    constexpr auto documents = 500'000;
+    auto texts = std::vector<std::string>{};
+    texts.reserve(documents);
+    for (int i = 0; i < documents; ++i) {
+        texts.push_back(R"({"method": "GET", "path": "/items/)" + std::to_string(i) + R"(", "ok": true, "n": )"
+            + std::to_string(i % 100) + "}");
+    }
+    const auto inputs = std::vector<std::string_view>(texts.begin(), texts.end());
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+    // keeps every result alive, like parse_many does
+    measure("new parser per document", documents, [&] {
+        auto results = std::vector<cjson::json>{};
+        results.reserve(inputs.size());
+        for (const auto input : inputs) {
+            results.push_back(cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{
+                std::string_view{input}}.parse());
+        }
+        auto count = std::size_t{0};
+        for (const auto& result : results) {
+            count += result.size();
+        }
+        return count;
+    });
+    measure("parse_many", documents, [&] {
+        auto count = std::size_t{0};
+        for (const auto& js : cjson::detail::input::parse_many<cjson::json>(inputs).values) {
+            count += js.size();
+        }
+        return count;
+    });
+    measure("parse_many, shared shapes", documents, [&] {
+        auto count = std::size_t{0};
+        for (const auto& js : cjson::detail::input::parse_many<cjson::json>(inputs, {.shared_shapes = true}).values) {
+            count += js.size();
+        }
+        return count;
+    });
+    for (const auto threads : {std::size_t{2}, std::size_t{4}}) {
+        auto pool = cjson::detail::thread_pool{threads};
+        measure("parse_many, " + std::to_string(threads) + " threads", documents, [&] {
+            auto count = std::size_t{0};
+            for (const auto& js : cjson::detail::input::parse_many<cjson::json>(inputs, pool).values) {
+                count += js.size();
+            }
+            return count;
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_cbor_parser.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+#include "../include/detail/output/cjson_cbor_encoder.hpp"
+
+auto make_document(const int records) -> cjson::json {
+    auto rows = cjson::json::array{};
+    for (int i = 0; i < records; ++i) {
+        auto row = cjson::json::object{};
+        row.emplace("id", cjson::json{i});
+        row.emplace("name", cjson::json{"record number " + std::to_string(i)});
+        row.emplace("active", cjson::json{bool{i % 3 == 0}});
+        row.emplace("scores", cjson::json{cjson::json{i * 0.25}, cjson::json{i * 0.5}, cjson::json{nullptr}});
+        row.emplace("position", cjson::json{cjson::json{i * 1.5}, cjson::json{-i * 0.75}});
+        rows.emplace_back(std::move(row));
+    }
+    return cjson::json{std::move(rows)};
+}
+
+template <typename Run>
+auto measure(const char* name, Run run) -> void {
+    constexpr auto rounds = 5;
+    auto checksum = std::size_t{0};
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        checksum += run();
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() / rounds << " ms (checksum " << checksum / rounds << ")\n";
+}
+
+int main() {
+    const auto js = make_document(200'000);
+    const auto text = js.dump();
+    auto packed = std::string{};
+    auto sink = cjson::detail::output::string_sink{packed};
+    cjson::detail::output::cbor_encoder{sink}.dump(js);
+    auto canonical = std::string{};
+    auto canonical_sink = cjson::detail::output::string_sink{canonical};
+    cjson::detail::output::cbor_encoder{canonical_sink, {.canonical = true}}.dump(js);
+    std::cout << "text: " << text.size() / 1024 << " KiB, cbor: " << packed.size() / 1024
+              << " KiB, canonical cbor: " << canonical.size() / 1024 << " KiB\n";
+
+    measure("text dump", [&] {
+        return js.dump().size();
+    });
+    measure("cbor encode", [&] {
+        auto bytes = std::string{};
+        auto sink = cjson::detail::output::string_sink{bytes};
+        cjson::detail::output::cbor_encoder{sink}.dump(js);
+        return bytes.size();
+    });
+    measure("canonical cbor encode", [&] {
+        auto bytes = std::string{};
+        auto sink = cjson::detail::output::string_sink{bytes};
+        cjson::detail::output::cbor_encoder{sink, {.canonical = true}}.dump(js);
+        return bytes.size();
+    });
+    measure("text parse", [&] {
+        auto parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{
+            std::string_view{text}};
+        return parser.parse().size();
+    });
+    measure("cbor decode", [&] {
+        return cjson::detail::input::cbor_parser<cjson::json>{packed}.parse().size();
+    });
+    return 0;
+}
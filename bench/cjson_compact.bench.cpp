@@ -0,0 +1,42 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include "../include/cjson_fwd.hpp"
+
+template <typename Json>
+auto iterate(const char* name, const Json& values) -> void {
+    const auto start = std::chrono::steady_clock::now();
+    auto total = 0.0;
+    for (int round = 0; round < 10; ++round) {
+        for (const auto& value : values) {
+            if (value.is_number()) {
+                total += static_cast<double>(value);
+            } else if (value.is_boolean() and static_cast<bool>(value)) {
+                total += 1.0;
+            }
+        }
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << values.size() * sizeof(Json) / 1024 << " KiB of elements, "
+              << elapsed.count() / 10 << " ms per pass (checksum " << total << ")\n";
+}
+
+int main() {
+    constexpr auto count = std::size_t{2'000'000};
+    auto elements = cjson::json::array{};
+    elements.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i % 8 == 0) {
+            elements.emplace_back(bool{i % 16 == 0});
+        } else {
+            elements.emplace_back(static_cast<double>(i) * 0.5);
+        }
+    }
+    const auto js = cjson::json{std::move(elements)};
+    const auto compact = cjson::compact_json{js};
+    iterate("basic_json", js);
+    iterate("compact_json", compact);
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_document_stream.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+template <typename Run>
+auto measure(const char* name, const std::size_t documents, Run run) -> void {
+    const auto start = std::chrono::steady_clock::now();
+    const auto checksum = run();
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() << " ms, "
+              << static_cast<double>(documents) / (elapsed.count() / 1000.0) << " documents/s (checksum " << checksum
+              << ")\n";
+}
+
+int main() {
+    constexpr auto documents = 300'000;
+    auto text = std::string{};
+    auto boundaries = std::vector<std::size_t>{0};
+    for (int i = 0; i < documents; ++i) {
+        text += R"({"event": "click", "user": )" + std::to_string(i) + R"(, "payload": {"x": 0.5, "label": ")"
+            + std::string(static_cast<std::size_t>(i % 64), 'l') + R"("}})";
+        boundaries.push_back(text.size());
+    }
+
+    // what a consumer had to do before: find the boundaries itself and build a parser per document
+    measure("parser per document", documents, [&] {
+        auto count = std::size_t{0};
+        for (std::size_t i = 0; i + 1 < boundaries.size(); ++i) {
+            count += cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{
+                std::string_view{text}.substr(boundaries[i], boundaries[i + 1] - boundaries[i])}.parse().size();
+        }
+        return count;
+    });
+    measure("document stream", documents, [&] {
+        auto count = std::size_t{0};
+        auto stream = cjson::detail::input::json_document_stream<cjson::detail::input::string_reader, cjson::json>{
+            std::string_view{text}};
+        for (const auto& js : stream) {
+            count += js.size();
+        }
+        return count;
+    });
+    measure("document stream, batches of 256", documents, [&] {
+        auto count = std::size_t{0};
+        auto stream = cjson::detail::input::json_document_stream<cjson::detail::input::string_reader, cjson::json>{
+            std::string_view{text}};
+        while (not stream.at_end()) {
+            for (const auto& js : stream.next_batch(256)) {
+                count += js.size();
+            }
+        }
+        return count;
+    });
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <chrono>
+#include <cstddef>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/output/cjson_fd_sink.hpp"
+#include "../include/detail/output/cjson_iovec_sink.hpp"
+
+auto make_document(const int records) -> cjson::json {
+    auto rows = cjson::json::array{};
+    for (int i = 0; i < records; ++i) {
+        auto row = cjson::json::object{};
+        row.emplace("id", cjson::json{i});
+        row.emplace("name", cjson::json{"record number " + std::to_string(i)});
+        row.emplace("active", cjson::json{bool{i % 3 == 0}});
+        row.emplace("scores", cjson::json{cjson::json{i * 0.25}, cjson::json{i * 0.5}, cjson::json{nullptr}});
+        auto nested = cjson::json{cjson::json::object{}};
+        nested.emplace("depth", cjson::json{cjson::json{cjson::json{i}}});
+        row.emplace("nested", std::move(nested));
+        rows.emplace_back(std::move(row));
+    }
+    return cjson::json{std::move(rows)};
+}
+
+auto make_long_strings(const int count, const std::size_t length, const bool escapes = true) -> cjson::json {
+    auto strings = cjson::json::array{};
+    for (int i = 0; i < count; ++i) {
+        auto str = std::string(length, 'a' + static_cast<char>(i % 26));
+        for (auto pos = static_cast<std::size_t>(i % 97); escapes and pos < length; pos += 997) {
+            str[pos] = (pos % 2 == 0) ? '"' : '\n';
+        }
+        strings.emplace_back(std::move(str));
+    }
+    return cjson::json{std::move(strings)};
+}
+
+template <typename Dump>
+auto measure(const char* name, Dump dump) -> void {
+    constexpr auto rounds = 5;
+    auto bytes = std::size_t{0};
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        bytes += dump();
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << static_cast<double>(bytes) / 1048576.0 / elapsed << " MiB/s, "
+              << elapsed * 1000 / rounds << " ms per document\n";
+}
+
+int main() {
+    const auto js = make_document(200'000);
+    const auto size = js.dump().size();
+    measure("string_sink", [&] {
+        return js.dump().size();
+    });
+    measure("serialized_size + dump_into", [&] {
+        const auto buffer = std::make_unique_for_overwrite<char[]>(js.serialized_size());
+        return js.dump_into({buffer.get(), size});
+    });
+    const auto reused = std::make_unique_for_overwrite<char[]>(size);
+    measure("dump_into reused buffer", [&] {
+        return js.dump_into({reused.get(), size});
+    });
+    measure("serialized_size only", [&] {
+        return js.serialized_size();
+    });
+    measure("stream_sink", [&] {
+        auto os = std::ostringstream{};
+        os << js;
+        return os.str().size();
+    });
+    measure("fd_sink", [&] {
+        const auto fd = ::open("/dev/null", O_WRONLY);
+        {
+            auto sink = cjson::detail::output::fd_sink{fd};
+            js.dump_to(sink);
+        }
+        ::close(fd);
+        return size;
+    });
+
+    const auto strings = make_long_strings(2'000, 64 * 1024);
+    measure("long strings", [&] {
+        return strings.dump().size();
+    });
+    measure("long strings, serialized_size + dump_into", [&] {
+        const auto length = strings.serialized_size();
+        const auto buffer = std::make_unique_for_overwrite<char[]>(length);
+        return strings.dump_into({buffer.get(), length});
+    });
+    const auto strings_size = strings.serialized_size();
+    measure("long strings, fd_sink", [&] {
+        const auto fd = ::open("/dev/null", O_WRONLY);
+        {
+            auto sink = cjson::detail::output::fd_sink{fd};
+            strings.dump_to(sink);
+        }
+        ::close(fd);
+        return strings_size;
+    });
+    measure("long strings, iovec_sink + writev", [&] {
+        const auto fd = ::open("/dev/null", O_WRONLY);
+        auto sink = cjson::detail::output::iovec_sink{};
+        strings.dump_to(sink);
+        cjson::detail::output::write_iovecs(fd, sink.iovecs());
+        ::close(fd);
+        return strings_size;
+    });
+    const auto payloads = make_long_strings(2'000, 64 * 1024, false);
+    const auto payloads_size = payloads.serialized_size();
+    measure("clean payloads, fd_sink", [&] {
+        const auto fd = ::open("/dev/null", O_WRONLY);
+        {
+            auto sink = cjson::detail::output::fd_sink{fd};
+            payloads.dump_to(sink);
+        }
+        ::close(fd);
+        return payloads_size;
+    });
+    measure("clean payloads, iovec_sink + writev", [&] {
+        const auto fd = ::open("/dev/null", O_WRONLY);
+        auto sink = cjson::detail::output::iovec_sink{};
+        payloads.dump_to(sink);
+        cjson::detail::output::write_iovecs(fd, sink.iovecs());
+        ::close(fd);
+        return payloads_size;
+    });
+    measure("long strings, ascii only", [&] {
+        auto str = std::string{};
+        strings.dump_to(cjson::detail::output::string_sink{str}, {.ascii_only = true});
+        return str.size();
+    });
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_event_parser.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+using cjson::detail::input::async_event_reader;
+
+template <typename Run>
+auto measure(const char* name, const std::size_t bytes, Run run) -> void {
+    const auto start = std::chrono::steady_clock::now();
+    const auto checksum = run();
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() << " ms, "
+              << static_cast<double>(bytes) / (1024.0 * 1024.0) / (elapsed.count() / 1000.0) << " MiB/s (checksum "
+              << checksum << ")\n";
+}
+
+struct task {
+    struct promise_type {
+        auto get_return_object() const noexcept -> task {
+            return {};
+        }
+
+        auto initial_suspend() const noexcept -> std::suspend_never {
+            return {};
+        }
+
+        auto final_suspend() const noexcept -> std::suspend_never {
+            return {};
+        }
+
+        auto return_void() const noexcept -> void {}
+
+        auto unhandled_exception() const noexcept -> void {
+            std::terminate();
+        }
+    };
+};
+
+auto count_events(async_event_reader& reader, std::size_t& count) -> task {
+    while (const auto event = co_await reader.next()) {
+        ++count;
+    }
+}
+
+auto make_document(const int records) -> std::string {
+    auto text = std::string{"["};
+    for (int i = 0; i < records; ++i) {
+        text += (i == 0 ? "" : ", ") + std::string{R"({"id": )"} + std::to_string(i)
+            + R"(, "name": "record name", "tags": ["a", "b"], "score": 0.75, "ok": true})";
+    }
+    return text + "]";
+}
+
+int main() {
+    const auto big = make_document(200'000);
+    std::cout << "document: " << big.size() / 1024 << " KiB\n";
+
+    measure("tree parse", big.size(), [&] {
+        return cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{
+            std::string_view{big}}.parse().size();
+    });
+    measure("event generator", big.size(), [&] {
+        auto count = std::size_t{0};
+        for (const auto& event : cjson::detail::input::parse_events<cjson::detail::input::string_reader>(
+                 std::string_view{big})) {
+            count += event.spelling_.size();
+        }
+        return count;
+    });
+    measure("async, 4 KiB chunks", big.size(), [&] {
+        auto count = std::size_t{0};
+        auto reader = async_event_reader{};
+        count_events(reader, count);
+        for (std::size_t first = 0; first < big.size(); first += 4096) {
+            reader.feed(std::string_view{big}.substr(first, 4096));
+        }
+        reader.finish();
+        return count;
+    });
+
+    // many connections, each trickling in a small document, served round-robin by one thread
+    constexpr auto connections = 2000;
+    const auto small = make_document(20);
+    measure("2000 interleaved async parses, 64 byte chunks", small.size() * connections, [&] {
+        auto count = std::size_t{0};
+        auto readers = std::vector<std::unique_ptr<async_event_reader>>{};
+        for (int i = 0; i < connections; ++i) {
+            readers.push_back(std::make_unique<async_event_reader>());
+            count_events(*readers.back(), count);
+        }
+        for (std::size_t first = 0; first < small.size(); first += 64) {
+            for (auto& reader : readers) {
+                reader->feed(std::string_view{small}.substr(first, 64));
+            }
+        }
+        for (auto& reader : readers) {
+            reader->finish();
+        }
+        return count;
+    });
+    return 0;
+}
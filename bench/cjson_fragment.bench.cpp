@@ -0,0 +1,51 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include "../include/cjson_fwd.hpp"
+
+auto make_state(const int sections, const int records) -> cjson::tracked_json {
+    auto state = cjson::tracked_json{cjson::tracked_json::object{}};
+    for (int s = 0; s < sections; ++s) {
+        auto rows = cjson::tracked_json{cjson::tracked_json::array{}};
+        for (int i = 0; i < records; ++i) {
+            auto row = cjson::tracked_json{cjson::tracked_json::object{}};
+            row.emplace("id", cjson::tracked_json{i});
+            row.emplace("name", cjson::tracked_json{"record number " + std::to_string(i)});
+            row.emplace("scores", cjson::tracked_json{cjson::tracked_json{i * 0.25}, cjson::tracked_json{i * 0.5}});
+            rows.push_back(std::move(row));
+        }
+        state.emplace("section " + std::to_string(s), std::move(rows));
+    }
+    return state;
+}
+
+template <typename Poll>
+auto measure(const char* name, cjson::tracked_json& state, Poll poll) -> void {
+    constexpr auto rounds = 20;
+    auto bytes = std::size_t{0};
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        state.at("section 7").at(static_cast<std::size_t>(round)).at("id") = cjson::tracked_json{-round};
+        bytes += poll().size();
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() / rounds << " ms per poll (" << bytes / rounds << " bytes)\n";
+}
+
+int main() {
+    auto state = make_state(64, 2'000);
+    measure("full dump", state, [&] {
+        return state.dump();
+    });
+    auto cache = cjson::detail::output::fragment_cache{};
+    const auto warm_start = std::chrono::steady_clock::now();
+    state.dump(cache);
+    const auto warm = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - warm_start);
+    std::cout << "first cached dump: " << warm.count() << " ms (" << cache.size() << " fragments)\n";
+    measure("cached dump, one dirty record", state, [&] {
+        return state.dump(cache);
+    });
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <malloc.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+// glibc specific: bytes currently handed out by malloc
+auto live_bytes() -> std::size_t {
+    return mallinfo2().uordblks;
+}
+
+auto make_corpus(const std::size_t records) -> std::vector<std::string> {
+    auto corpus = std::vector<std::string>{};
+    for (std::size_t i = 0; i < records; ++i) {
+        corpus.push_back(R"({"timestamp_millis": )" + std::to_string(i) +
+            R"(, "service_name": "checkout", "severity_level": "info", "request_identifier": "r)" +
+            std::to_string(i) + R"(", "response_status_code": 200, "upstream_latency_micros": )" +
+            std::to_string(i % 977) + "}");
+    }
+    return corpus;
+}
+
+template <typename Json>
+auto run(const char* name, const std::vector<std::string>& corpus, const cjson::detail::input::parse_options& options)
+    -> void {
+    const auto baseline = live_bytes();
+    const auto start = std::chrono::steady_clock::now();
+    auto documents = std::vector<Json>{};
+    documents.reserve(corpus.size());
+    for (const auto& record : corpus) {
+        auto parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, Json>{
+            options, std::string_view{record}};
+        documents.push_back(parser.parse());
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << (live_bytes() - baseline) / 1024 << " KiB live, "
+              << elapsed.count() << " ms\n";
+}
+
+int main() {
+    const auto corpus = make_corpus(100000);
+    run<cjson::json>("std::string keys", corpus, {});
+    run<cjson::interned_json>("interned keys", corpus, {});
+    run<cjson::interned_json>("interned keys + shared shapes", corpus, {.shared_shapes = true});
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/cjson_thread_pool.hpp"
+#include "../include/detail/input/cjson_ndjson_parser.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+auto make_log(const int lines) -> std::string {
+    auto text = std::string{};
+    for (int i = 0; i < lines; ++i) {
+        text += R"({"ts": )" + std::to_string(1'700'000'000 + i) + R"(, "level": ")" + (i % 10 == 0 ? "warn" : "info")
+            + R"(", "message": "request )" + std::to_string(i) + R"( served", "latency": )"
+            + std::to_string(i % 1000 * 0.125) + R"(, "tags": ["edge", "eu-west"]})" + "\n";
+    }
+    return text;
+}
+
+template <typename Run>
+auto measure(const std::string& name, const std::size_t lines, Run run) -> double {
+    const auto start = std::chrono::steady_clock::now();
+    const auto checksum = run();
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() << " ms, " << static_cast<double>(lines) / (elapsed.count() / 1000.0)
+              << " lines/s (checksum " << checksum << ")\n";
+    return elapsed.count();
+}
+
+int main() {
+    constexpr auto lines = 300'000;
+    const auto text = make_log(lines);
+    std::cout << "input: " << text.size() / 1048576 << " MiB, hardware threads: "
+              << std::thread::hardware_concurrency() << "\n";
+
+    const auto sequential = measure("line by line", lines, [&] {
+        auto count = std::size_t{0};
+        for (std::size_t first = 0; first < text.size();) {
+            const auto last = text.find('\n', first);
+            count += cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{
+                std::string_view{text}.substr(first, last - first)}.parse().size();
+            first = last + 1;
+        }
+        return count;
+    });
+    for (const auto threads : {std::size_t{1}, std::size_t{2}, std::size_t{4}, std::size_t{8}, std::size_t{16}}) {
+        auto pool = cjson::detail::thread_pool{threads};
+        const auto elapsed = measure("parse_ndjson, " + std::to_string(threads) + " threads", lines, [&] {
+            auto count = std::size_t{0};
+            cjson::detail::input::parse_ndjson<cjson::json>(text, pool, [&](auto&& line) {
+                count += line.value.size();
+            });
+            return count;
+        });
+        std::cout << "  speedup: " << sequential / elapsed << "x\n";
+    }
+    return 0;
+}
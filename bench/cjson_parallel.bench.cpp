@@ -0,0 +1,54 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/cjson_thread_pool.hpp"
+#include "../include/detail/input/cjson_parallel_parser.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+auto make_text(const int records) -> std::string {
+    auto text = std::string{"["};
+    for (int i = 0; i < records; ++i) {
+        if (i > 0) {
+            text += ",\n";
+        }
+        text += R"({"id": )" + std::to_string(i) + R"(, "name": "record number )" + std::to_string(i)
+            + R"(", "active": )" + (i % 3 == 0 ? "true" : "false") + R"(, "scores": [)"
+            + std::to_string(i * 0.25) + ", " + std::to_string(i * 0.5) + R"(, null]})";
+    }
+    return text + "]";
+}
+
+template <typename Run>
+auto measure(const std::string& name, const std::size_t bytes, Run run) -> double {
+    const auto start = std::chrono::steady_clock::now();
+    const auto checksum = run();
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() << " ms, "
+              << static_cast<double>(bytes) / 1048576.0 / (elapsed.count() / 1000.0) << " MiB/s (checksum "
+              << checksum << ")\n";
+    return elapsed.count();
+}
+
+int main() {
+    const auto text = make_text(400'000);
+    std::cout << "input: " << text.size() / 1048576 << " MiB, hardware threads: "
+              << std::thread::hardware_concurrency() << "\n";
+
+    const auto sequential = measure("sequential", text.size(), [&] {
+        return cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{
+            std::string_view{text}}.parse().size();
+    });
+    for (const auto threads : {std::size_t{1}, std::size_t{2}, std::size_t{4}, std::size_t{8}, std::size_t{16}}) {
+        auto pool = cjson::detail::thread_pool{threads};
+        const auto elapsed = measure("parallel, " + std::to_string(threads) + " threads", text.size(), [&] {
+            return cjson::detail::input::parse_parallel<cjson::json>(text, pool).size();
+        });
+        std::cout << "  speedup: " << sequential / elapsed << "x\n";
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+using cjson::detail::input::parse_options;
+using parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>;
+
+// the best of a few runs, as allocator state left by one run skews the next
+template <typename Run>
+auto measure(const char* name, Run run) -> void {
+    auto best = std::chrono::duration<double, std::milli>::max();
+    auto checksum = std::size_t{0};
+    for (int round = 0; round < 3; ++round) {
+        const auto start = std::chrono::steady_clock::now();
+        checksum = run();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start));
+    }
+    std::cout << name << ": " << best.count() << " ms (checksum " << checksum << ")\n";
+}
+
+auto compare(const char* name, const std::string& text) -> void {
+    std::cout << name << ", " << text.size() / 1024 << " KiB\n";
+    auto presized = parse_options{};
+    presized.presize = true;
+    measure("  growing", [&] {
+        return parser{std::string_view{text}}.parse().size();
+    });
+    measure("  presized", [&] {
+        return parser{presized, std::string_view{text}}.parse().size();
+    });
+}
+
+int main() {
+    constexpr auto elements = 1'000'000;
+    auto strings = std::string{"["};
+    for (int i = 0; i < elements; ++i) {
+        strings += (i == 0 ? "\"item " : ", \"item ") + std::to_string(i) + "\"";
+    }
+    strings += "]";
+    compare("array of strings", strings);
+
+    auto rows = std::string{"["};
+    for (int i = 0; i < elements / 10; ++i) {
+        rows += (i == 0 ? "[" : ", [") + std::to_string(i) + ", \"name\", true, null, [1, 2, 3], \"x\", 7, 8, \"y\", false]";
+    }
+    rows += "]";
+    compare("array of mixed rows", rows);
+
+    // keys in order, as serializers of sorted maps write them
+    auto wide = std::string{"["};
+    for (int i = 0; i < 1'000; ++i) {
+        wide += i == 0 ? "{" : ", {";
+        for (int j = 0; j < 200; ++j) {
+            const auto digits = std::to_string(1000 + j);
+            wide += (j == 0 ? "\"key_" : ", \"key_") + digits + "\": " + std::to_string(j);
+        }
+        wide += "}";
+    }
+    wide += "]";
+    compare("wide objects, sorted keys", wide);
+    return 0;
+}
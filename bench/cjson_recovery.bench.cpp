@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+using parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>;
+
+template <typename Run>
+auto measure(const char* name, Run run) -> void {
+    const auto start = std::chrono::steady_clock::now();
+    const auto checksum = run();
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() << " ms (checksum " << checksum << ")\n";
+}
+
+int main() {
+    constexpr auto entries = 200'000;
+    constexpr auto broken_entries = 20;
+    auto clean = std::string{"{"};
+    for (int i = 0; i < entries; ++i) {
+        clean += (i == 0 ? "\n  \"service_" : ",\n  \"service_") + std::to_string(i) + R"(": {"enabled": true, "port": )"
+            + std::to_string(1000 + i % 5000) + R"(, "hosts": ["a.example", "b.example"], "weight": 0.5})";
+    }
+    clean += "\n}";
+    // the same config with a typo in a few entries, "true" -> "ture", keeping the length
+    auto broken = clean;
+    for (int i = 0; i < broken_entries; ++i) {
+        broken.replace(broken.find("true", clean.size() / broken_entries * static_cast<std::size_t>(i)), 4, "ture");
+    }
+    std::cout << "document: " << broken.size() / 1024 << " KiB, " << broken_entries << " errors\n";
+
+    measure("one pass, parse_recovering", [&] {
+        return parser{std::string_view{broken}}.parse_recovering().errors.size();
+    });
+    // what a user does without recovery: fix the first error reported, then parse again
+    measure("fix and re-run, try_parse", [&] {
+        auto text = broken;
+        auto found = std::size_t{0};
+        while (true) {
+            const auto result = parser{std::string_view{text}}.try_parse();
+            if (result) {
+                return found;
+            }
+            const auto offset = result.error().offset_;
+            text.replace(offset, 4, clean, offset, 4);
+            ++found;
+        }
+    });
+    measure("valid document, parse", [&] {
+        return parser{std::string_view{clean}}.parse().size();
+    });
+    measure("valid document, parse_recovering", [&] {
+        return parser{std::string_view{clean}}.parse_recovering().value.size();
+    });
+    return 0;
+}
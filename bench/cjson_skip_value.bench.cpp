@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+#include "../include/detail/input/cjson_scanner.hpp"
+
+using cjson::detail::input::parse_options;
+using cjson::detail::input::skip_mode;
+using cjson::detail::input::string_reader;
+using parser = cjson::detail::input::json_parser<string_reader, cjson::json>;
+using scanner = cjson::detail::input::json_scanner<string_reader>;
+
+template <typename Run>
+auto measure(const char* name, Run run) -> void {
+    const auto start = std::chrono::steady_clock::now();
+    const auto checksum = run();
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() << " ms (checksum " << checksum << ")\n";
+}
+
+int main() {
+    // wide records: two small fields that are wanted and many large ones that are not
+    constexpr auto records = 2'000;
+    constexpr auto wide_fields = 40;
+    auto text = std::string{"["};
+    for (int i = 0; i < records; ++i) {
+        text += (i == 0 ? "\n{\"id\": " : ",\n{\"id\": ") + std::to_string(i) + ", \"name\": \"record "
+            + std::to_string(i) + "\"";
+        for (int j = 0; j < wide_fields; ++j) {
+            text += ", \"field_" + std::to_string(j) + R"(": {"values": [1.5, 2.5, 3.5, 4.5], )"
+                R"("text": "a longer string value with \"escapes\" in it", "nested": [{"a": null}, {"b": true}]})";
+        }
+        text += "}";
+    }
+    text += "\n]";
+    std::cout << "document: " << text.size() / 1024 << " KiB, " << records << " records of "
+              << wide_fields + 2 << " members\n";
+
+    for (const auto& [name, mode] : {std::pair{"member filter, BALANCED", skip_mode::BALANCED},
+                                     std::pair{"member filter, MATCHED", skip_mode::MATCHED},
+                                     std::pair{"member filter, VALIDATED", skip_mode::VALIDATED}}) {
+        measure(name, [&, mode = mode] {
+            auto options = parse_options{};
+            options.member_filter = [](const std::string_view key, const std::size_t) {
+                return key == "id" or key == "name";
+            };
+            options.skip = mode;
+            return parser{options, std::string_view{text}}.parse().size();
+        });
+    }
+    measure("scanner, every token", [&] {
+        auto json_scanner = scanner{std::make_unique<string_reader>(std::string_view{text})};
+        auto token = cjson::detail::input::json_token{};
+        auto count = std::size_t{0};
+        for (json_scanner.get_token(token); token.tok_ != cjson::detail::input::token::END; json_scanner.get_token(token)) {
+            ++count;
+        }
+        return count;
+    });
+    measure("scanner, skip_value", [&] {
+        auto json_scanner = scanner{std::make_unique<string_reader>(std::string_view{text})};
+        return static_cast<std::size_t>(json_scanner.skip_value(skip_mode::MATCHED));
+    });
+    // last, as freeing the full tree slows down whatever runs right after it
+    measure("parse everything", [&] {
+        return parser{std::string_view{text}}.parse().size();
+    });
+    return 0;
+}
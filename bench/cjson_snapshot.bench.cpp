@@ -0,0 +1,71 @@
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_mapped_file.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+#include "../include/detail/input/cjson_snapshot_view.hpp"
+#include "../include/detail/output/cjson_snapshot_writer.hpp"
+
+auto make_document(const int records) -> cjson::json {
+    auto rows = cjson::json::array{};
+    for (int i = 0; i < records; ++i) {
+        auto row = cjson::json::object{};
+        row.emplace("id", cjson::json{i});
+        row.emplace("name", cjson::json{"record number " + std::to_string(i)});
+        row.emplace("active", cjson::json{bool{i % 3 == 0}});
+        row.emplace("scores", cjson::json{cjson::json{i * 0.25}, cjson::json{i * 0.5}, cjson::json{nullptr}});
+        row.emplace("position", cjson::json{cjson::json{i * 1.5}, cjson::json{-i * 0.75}});
+        rows.emplace_back(std::move(row));
+    }
+    return cjson::json{std::move(rows)};
+}
+
+template <typename Run>
+auto measure(const char* name, Run run) -> void {
+    constexpr auto rounds = 5;
+    auto checksum = std::size_t{0};
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        checksum += run();
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() / rounds << " ms (checksum " << checksum / rounds << ")\n";
+}
+
+int main() {
+    const auto js = make_document(200'000);
+    const auto text = js.dump();
+    auto bytes = std::string{};
+    cjson::detail::output::snapshot_writer{bytes}.dump(js);
+    const auto path = std::string{"/tmp/cjson_snapshot.bench"};
+    std::ofstream{path, std::ios::binary} << bytes;
+    std::cout << "text: " << text.size() / 1024 << " KiB, snapshot: " << bytes.size() / 1024 << " KiB\n";
+
+    measure("text parse", [&] {
+        auto parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{
+            std::string_view{text}};
+        return parser.parse().size();
+    });
+    measure("snapshot write", [&] {
+        auto buffer = std::string{};
+        cjson::detail::output::snapshot_writer{buffer}.dump(js);
+        return buffer.size();
+    });
+    measure("snapshot map and lookup", [&] {
+        const auto file = cjson::detail::input::mapped_file{path};
+        const auto root = cjson::detail::input::snapshot_view::root(file.bytes());
+        return root[199'999]["name"].string().size() + root.size();
+    });
+    measure("snapshot to_json", [&] {
+        const auto file = cjson::detail::input::mapped_file{path};
+        return cjson::detail::input::snapshot_view::root(file.bytes()).to_json<cjson::json>().size();
+    });
+    std::remove(path.c_str());
+    return 0;
+}
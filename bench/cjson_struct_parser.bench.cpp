@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+#include "../include/detail/input/cjson_struct_parser.hpp"
+
+namespace records {
+    struct address {
+        std::string street;
+        std::string city;
+        std::int32_t zip = 0;
+    };
+    CJSON_DESCRIBE(address, street, city, zip)
+
+    struct record {
+        std::int64_t id = 0;
+        std::string name;
+        double score = 0;
+        bool active = false;
+        std::vector<std::string> tags;
+        address home;
+        std::optional<std::string> nickname;
+        std::map<std::string, double> attributes;
+    };
+    CJSON_DESCRIBE(record, id, name, score, active, tags, home, nickname, attributes)
+}
+
+using cjson::detail::input::string_reader;
+using dom_parser = cjson::detail::input::json_parser<string_reader, cjson::json>;
+using struct_parser = cjson::detail::input::struct_parser<string_reader>;
+
+// what consumers write today: the whole tree first, then a pass copying it out
+auto extract(const cjson::json& json) -> std::vector<records::record> {
+    const auto string = [](const cjson::json& value) {
+        return static_cast<const std::string&>(value);
+    };
+    auto records = std::vector<records::record>{};
+    for (const auto& element : static_cast<const cjson::json::array&>(json)) {
+        auto& record = records.emplace_back();
+        record.id = static_cast<std::int64_t>(static_cast<double>(element.at("id")));
+        record.name = string(element.at("name"));
+        record.score = static_cast<double>(element.at("score"));
+        record.active = static_cast<bool>(element.at("active"));
+        for (const auto& tag : element.at("tags")) {
+            record.tags.push_back(string(tag));
+        }
+        const auto& home = element.at("home");
+        record.home.street = string(home.at("street"));
+        record.home.city = string(home.at("city"));
+        record.home.zip = static_cast<std::int32_t>(static_cast<double>(home.at("zip")));
+        if (element.contains("nickname") and not element.at("nickname").is_null()) {
+            record.nickname = string(element.at("nickname"));
+        }
+        for (const auto& [key, value] : static_cast<const cjson::json::object&>(element.at("attributes"))) {
+            record.attributes.emplace(key, static_cast<double>(value));
+        }
+    }
+    return records;
+}
+
+// the best of a few runs, as allocator state left by one run skews the next
+template <typename Run>
+auto measure(const char* name, Run run) -> void {
+    auto best = std::chrono::duration<double, std::milli>::max();
+    auto checksum = std::size_t{0};
+    for (int round = 0; round < 3; ++round) {
+        const auto start = std::chrono::steady_clock::now();
+        checksum = run();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start));
+    }
+    std::cout << name << ": " << best.count() << " ms (checksum " << checksum << ")\n";
+}
+
+int main() {
+    constexpr auto count = 100'000;
+    auto text = std::string{"["};
+    for (int i = 0; i < count; ++i) {
+        const auto n = std::to_string(i);
+        text += (i == 0 ? "" : ", ");
+        text += R"({"id": )" + n + R"(, "name": "user )" + n + R"(", "score": )" + n + R"(.25, "active": true, )"
+            + R"("tags": ["alpha", "beta", "gamma"], "home": {"street": ")" + n + R"( high st", "city": "leeds", )"
+            + R"("zip": )" + n + R"(}, "nickname": )" + (i % 2 == 0 ? R"("nick")" : "null")
+            + R"(, "attributes": {"height": 1.8, "weight": 70.5}, "created": "2024-01-01T00:00:00Z"})";
+    }
+    text += "]";
+    std::cout << count << " records, " << text.size() / 1024 << " KiB\n";
+
+    const auto checksum = [](const std::vector<records::record>& records) {
+        auto sum = std::size_t{0};
+        for (const auto& record : records) {
+            sum += static_cast<std::size_t>(record.id) + record.name.size() + record.tags.size()
+                + record.home.city.size() + record.nickname.has_value() + record.attributes.size();
+        }
+        return sum;
+    };
+    measure("basic_json + extraction", [&] {
+        return checksum(extract(dom_parser{std::string_view{text}}.parse()));
+    });
+    measure("struct_parser", [&] {
+        return checksum(struct_parser{std::string_view{text}}.parse<std::vector<records::record>>());
+    });
+}
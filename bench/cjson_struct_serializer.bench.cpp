@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/output/cjson_struct_serializer.hpp"
+
+namespace records {
+    struct address {
+        std::string street;
+        std::string city;
+        std::int32_t zip = 0;
+    };
+    CJSON_DESCRIBE(address, street, city, zip)
+
+    struct record {
+        std::int64_t id = 0;
+        std::string name;
+        double score = 0;
+        bool active = false;
+        std::vector<std::string> tags;
+        address home;
+        std::optional<std::string> nickname;
+        std::map<std::string, double> attributes;
+    };
+    CJSON_DESCRIBE(record, id, name, score, active, tags, home, nickname, attributes)
+}
+
+using cjson::detail::output::string_sink;
+
+// what the response path does today: a basic_json tree built from the structs, then dumped
+auto to_json(const std::vector<records::record>& records) -> cjson::json {
+    auto array = cjson::json::array{};
+    array.reserve(records.size());
+    for (const auto& record : records) {
+        auto tags = cjson::json::array{};
+        for (const auto& tag : record.tags) {
+            tags.emplace_back(tag);
+        }
+        auto attributes = cjson::json::object{};
+        for (const auto& [key, value] : record.attributes) {
+            attributes.emplace(key, cjson::json{value});
+        }
+        auto object = cjson::json::object{};
+        object.emplace("id", cjson::json{static_cast<double>(record.id)});
+        object.emplace("name", cjson::json{record.name});
+        object.emplace("score", cjson::json{record.score});
+        object.emplace("active", cjson::json{bool{record.active}});
+        object.emplace("tags", cjson::json{std::move(tags)});
+        object.emplace("home", cjson::json{cjson::json::object{
+            {"street", cjson::json{record.home.street}},
+            {"city", cjson::json{record.home.city}},
+            {"zip", cjson::json{static_cast<double>(record.home.zip)}},
+        }});
+        object.emplace("nickname", record.nickname ? cjson::json{*record.nickname} : cjson::json{nullptr});
+        object.emplace("attributes", cjson::json{std::move(attributes)});
+        array.emplace_back(std::move(object));
+    }
+    return cjson::json{std::move(array)};
+}
+
+// the best of a few runs, as allocator state left by one run skews the next
+template <typename Run>
+auto measure(const char* name, Run run) -> void {
+    auto best = std::chrono::duration<double, std::milli>::max();
+    auto checksum = std::size_t{0};
+    for (int round = 0; round < 3; ++round) {
+        const auto start = std::chrono::steady_clock::now();
+        checksum = run();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start));
+    }
+    std::cout << name << ": " << best.count() << " ms (checksum " << checksum << ")\n";
+}
+
+int main() {
+    constexpr auto count = 100'000;
+    auto records = std::vector<records::record>(count);
+    for (int i = 0; i < count; ++i) {
+        auto& record = records[static_cast<std::size_t>(i)];
+        record.id = i;
+        record.name = "user " + std::to_string(i);
+        record.score = i + 0.25;
+        record.active = true;
+        record.tags = {"alpha", "beta", "gamma"};
+        record.home = {std::to_string(i) + " high st", "leeds", i};
+        if (i % 2 == 0) {
+            record.nickname = "nick";
+        }
+        record.attributes = {{"height", 1.8}, {"weight", 70.5}};
+    }
+
+    // the output is kept between runs, as a server reuses its response buffer
+    auto out = std::string{};
+    measure("basic_json + dump", [&] {
+        out.clear();
+        to_json(records).dump_to(string_sink{out});
+        return out.size();
+    });
+    measure("struct_serializer", [&] {
+        out.clear();
+        auto sink = string_sink{out};
+        cjson::detail::output::struct_serializer<string_sink>{sink}.dump(records);
+        return out.size();
+    });
+}
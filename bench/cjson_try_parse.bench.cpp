@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+using parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>;
+
+template <typename Run>
+auto measure(const char* name, const std::size_t documents, Run run) -> void {
+    const auto start = std::chrono::steady_clock::now();
+    const auto checksum = run();
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << elapsed.count() << " ms, "
+              << static_cast<double>(documents) / (elapsed.count() / 1000.0) << " documents/s (checksum " << checksum
+              << ")\n";
+}
+
+int main() {
+    constexpr auto documents = 300'000;
+    // request bodies of the kind a fuzzer or an attacker sends, each broken in a different way
+    const auto broken = std::vector<std::string>{
+        R"({"user": "alice", "roles": ["admin", "ops"], "age": 3x})",
+        R"({"user": "bob", "roles": ["dev"] "age": 41})",
+        R"({"user": "carol", "bio": "unterminated)",
+        R"({"user": "dave", "tags": [1, 2, 3,]})",
+        R"({"user": "erin", "bio": "bad \q escape"})",
+        R"({user: "frank"})",
+        R"([1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, -])",
+    };
+    auto inputs = std::vector<std::string_view>{};
+    inputs.reserve(documents);
+    for (std::size_t i = 0; i < documents; ++i) {
+        inputs.emplace_back(broken[i % broken.size()]);
+    }
+    const auto valid = std::string{R"({"user": "alice", "roles": ["admin", "ops"], "age": 37, "active": true})"};
+
+    measure("invalid input, parse + catch", documents, [&] {
+        auto rejected = std::size_t{0};
+        for (const auto input : inputs) {
+            try {
+                parser{std::string_view{input}}.parse();
+            } catch (const cjson::detail::input::json_input_error&) {
+                ++rejected;
+            }
+        }
+        return rejected;
+    });
+    measure("invalid input, try_parse", documents, [&] {
+        auto rejected = std::size_t{0};
+        for (const auto input : inputs) {
+            rejected += not parser{std::string_view{input}}.try_parse();
+        }
+        return rejected;
+    });
+    measure("invalid input, try_parse + message", documents, [&] {
+        auto length = std::size_t{0};
+        for (const auto input : inputs) {
+            length += parser{std::string_view{input}}.try_parse().error().message().size();
+        }
+        return length;
+    });
+    measure("valid input, parse", documents, [&] {
+        auto size = std::size_t{0};
+        for (std::size_t i = 0; i < documents; ++i) {
+            size += parser{std::string_view{valid}}.parse().size();
+        }
+        return size;
+    });
+    measure("valid input, try_parse", documents, [&] {
+        auto size = std::size_t{0};
+        for (std::size_t i = 0; i < documents; ++i) {
+            size += parser{std::string_view{valid}}.try_parse()->size();
+        }
+        return size;
+    });
+    return 0;
+}
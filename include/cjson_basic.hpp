@@ -1,29 +1,87 @@
 #ifndef CJSON_HPP
 #define CJSON_HPP
 
+#include <algorithm>
+#include <array>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <initializer_list>
 #include <iterator>
 #include <map>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "detail/cjson_error.hpp"
 #include "detail/cjson_iterator.hpp"
+#include "detail/cjson_number_view.hpp"
+#include "detail/cjson_numbers.hpp"
+#include "detail/cjson_object_view.hpp"
+#include "detail/cjson_reference.hpp"
+#include "detail/cjson_revision.hpp"
+#include "detail/cjson_shape.hpp"
+#include "detail/cjson_simd.hpp"
+#include "detail/output/cjson_serializer.hpp"
 
 namespace cjson {
+    namespace detail {
+        template <typename Types>
+        struct json_key_type {
+            using type = typename Types::string_type;
+        };
+
+        template <typename Types>
+        requires (requires { typename Types::key_type; })
+        struct json_key_type<Types> {
+            using type = typename Types::key_type;
+        };
+
+        // whether the json of Types carries a revision, see basic_json::revision
+        template <typename Types>
+        struct json_tracks_revisions: std::false_type {};
+
+        template <typename Types>
+        requires (requires { Types::track_revisions; })
+        struct json_tracks_revisions<Types>: std::bool_constant<Types::track_revisions> {};
+
+        // a key of another type than the object's, which an object with a transparent comparator
+        // can look up without making a key_type of it
+        template <typename Object, typename Key>
+        concept heterogeneous_key = requires { typename Object::key_compare::is_transparent; }
+            and std::convertible_to<const Key&, std::string_view>
+            and (not std::same_as<Key, typename Object::key_type>);
+    }
+
     template <typename Types, template<typename> class Alloc = std::allocator>
     class basic_json {
+        friend json_ref<basic_json>;
+        friend json_ref<const basic_json>;
+        friend detail::json_number_view<basic_json>;
+        friend detail::json_number_view<const basic_json>;
+
     public:
         using null = std::nullptr_t;
         using number = typename Types::number_type;
         using boolean = typename Types::boolean_type;
         using string = typename Types::string_type;
+        using key = typename detail::json_key_type<Types>::type;
         using object = typename Types::template object_type<
-            string, basic_json<Types, Alloc>, Alloc<std::pair<const string, basic_json<Types, Alloc>>>>;
+            key, basic_json<Types, Alloc>, Alloc<std::pair<const key, basic_json<Types, Alloc>>>>;
         using array = typename Types::template array_type<basic_json<Types, Alloc>,
             Alloc<basic_json<Types, Alloc>>>;
+        using number_array = typename Types::template array_type<number, Alloc<number>>;
+        using shape = detail::json_shape<key, typename object::key_compare>;
+        using shaped_object = detail::json_shaped_object<shape, array>;
+        using object_view = detail::json_object_view<basic_json>;
+        using number_view = detail::json_number_view<basic_json>;
+        using const_number_view = detail::json_number_view<const basic_json>;
 
         using value_type = basic_json;
         using reference = value_type&;
@@ -57,36 +115,48 @@ namespace cjson {
         template <typename STRING>
         requires std::convertible_to<std::remove_cvref_t<STRING>, string>
         explicit basic_json(STRING&& s)
-            : m_json_value{string{s}}, m_value_t{value_t::_STRING} {}
+            : m_json_value{string{std::forward<STRING>(s)}}, m_value_t{value_t::_STRING} {}
 
         explicit basic_json(const object& o)
-            : m_json_value{o}, m_value_t{value_t::_OBJECT} {}
+            : m_json_value{o}, m_value_t{value_t::_OBJECT}, m_revision{revision_type::fresh()} {}
 
         explicit basic_json(object&& o)
-            : m_json_value{o}, m_value_t{value_t::_OBJECT} {}
+            : m_json_value{std::move(o)}, m_value_t{value_t::_OBJECT}, m_revision{revision_type::fresh()} {}
 
         explicit basic_json(const array& a)
-            : m_json_value{a}, m_value_t{value_t::_ARRAY} {}
+            : m_json_value{a}, m_value_t{value_t::_ARRAY}, m_revision{revision_type::fresh()} {}
 
         explicit basic_json(array&& a)
-            : m_json_value{a}, m_value_t{value_t::_ARRAY} {}
+            : m_json_value{std::move(a)}, m_value_t{value_t::_ARRAY}, m_revision{revision_type::fresh()} {}
+
+        explicit basic_json(const number_array& a)
+            : m_json_value{a}, m_value_t{value_t::_NUMBER_ARRAY}, m_revision{revision_type::fresh()} {}
+
+        explicit basic_json(number_array&& a)
+            : m_json_value{std::move(a)}, m_value_t{value_t::_NUMBER_ARRAY}, m_revision{revision_type::fresh()} {}
+
+        explicit basic_json(const shaped_object& o)
+            : m_json_value{o}, m_value_t{value_t::_SHAPED_OBJECT}, m_revision{revision_type::fresh()} {}
+
+        explicit basic_json(shaped_object&& o)
+            : m_json_value{std::move(o)}, m_value_t{value_t::_SHAPED_OBJECT}, m_revision{revision_type::fresh()} {}
 
         basic_json(size_type count, const value_type& val)
-            : m_value_t{value_t::_ARRAY} {
+            : m_value_t{value_t::_ARRAY}, m_revision{revision_type::fresh()} {
             m_json_value.m_array = construct_heap_object<Alloc<array>, array>(count, val);
         }
 
         template <std::input_iterator InputIterator>
         requires std::is_convertible_v<std::iter_value_t<InputIterator>, typename array::value_type>
         basic_json(InputIterator first, InputIterator last)
-            : m_value_t{value_t::_ARRAY} {
+            : m_value_t{value_t::_ARRAY}, m_revision{revision_type::fresh()} {
             m_json_value.m_array = construct_heap_object<Alloc<array>, array>(first, last);
         }
 
         template <std::input_iterator InputIterator>
         requires std::is_convertible_v<std::iter_value_t<InputIterator>, typename object::value_type>
         basic_json(InputIterator first, InputIterator last)
-            : m_value_t{value_t::_OBJECT} {
+            : m_value_t{value_t::_OBJECT}, m_revision{revision_type::fresh()} {
             m_json_value.m_object = construct_heap_object<Alloc<object>, object>(first, last);
         }
 
@@ -97,7 +167,7 @@ namespace cjson {
             : basic_json(il.begin(), il.end()) {}
 
         basic_json(const basic_json& other) noexcept
-            : m_value_t{other.m_value_t} {
+            : m_value_t{other.m_value_t}, m_revision{revision_type::fresh()} {
             switch (m_value_t) {
                 case value_t::_NULL:
                     m_json_value = {};
@@ -117,18 +187,26 @@ namespace cjson {
                 case value_t::_ARRAY:
                     m_json_value = *other.m_json_value.m_array;
                     break;
+                case value_t::_NUMBER_ARRAY:
+                    m_json_value = other.m_json_value.m_number_array->numbers();
+                    break;
+                case value_t::_SHAPED_OBJECT:
+                    m_json_value = *other.m_json_value.m_shaped_object;
+                    break;
             }
         }
 
         basic_json(basic_json&& other) noexcept
             : m_json_value{std::exchange(other.m_json_value, {})}
-            , m_value_t{std::exchange(other.m_value_t, {})} {}
+            , m_value_t{std::exchange(other.m_value_t, {})}
+            , m_revision{std::exchange(other.m_revision, revision_type::fresh())} {}
 
         auto operator=(const basic_json& other) noexcept -> basic_json& {
             if (this != &other) {
                 auto other_copy = other;
                 std::swap(m_json_value, other_copy.m_json_value);
                 std::swap(m_value_t, other_copy.m_value_t);
+                std::swap(m_revision, other_copy.m_revision);
             }
             return *this;
         }
@@ -137,12 +215,18 @@ namespace cjson {
             auto other = basic_json(il);
             std::swap(m_json_value, other.m_json_value);
             std::swap(m_value_t, other.m_value_t);
+            std::swap(m_revision, other.m_revision);
+            return *this;
         }
 
+        // the value replaced is destroyed before this returns, with the temporary it is swapped
+        // into; other is left null
         auto operator=(basic_json&& other) noexcept -> basic_json& {
             if (this != &other) {
-                m_json_value = std::exchange(other.m_json_value, {});
-                m_value_t = std::exchange(other.m_value_t, {});
+                auto moved = basic_json(std::move(other));
+                std::swap(m_json_value, moved.m_json_value);
+                std::swap(m_value_t, moved.m_value_t);
+                revise();
             }
             return *this;
         }
@@ -158,6 +242,12 @@ namespace cjson {
                 case value_t::_ARRAY:
                     destroy_heap_object<Alloc<array>, array>(m_json_value.m_array);
                     break;
+                case value_t::_NUMBER_ARRAY:
+                    destroy_heap_object<Alloc<number_storage>, number_storage>(m_json_value.m_number_array);
+                    break;
+                case value_t::_SHAPED_OBJECT:
+                    destroy_heap_object<Alloc<shaped_object>, shaped_object>(m_json_value.m_shaped_object);
+                    break;
                 default:
                     break;
             }
@@ -169,23 +259,41 @@ namespace cjson {
             return allocator_type{};
         }
 
+        // changes whenever this value is modified, by its own members, by assigning to it or by
+        // moving out of it. a change to a nested value changes only the revision of that value,
+        // which is why fragment_cache looks at every revision under a container. casting to
+        // string&, object& or array& counts as a change at the time of the cast. only a json
+        // whose types set track_revisions has one, see tracked_json_types
+        auto revision() const noexcept -> std::uint64_t
+            requires detail::json_tracks_revisions<Types>::value {
+            return m_revision.value();
+        }
+
+        // a number array has no json elements to refer to, so it is promoted to its generic form
+        // here and by the other non-const element access. read it through numbers() to keep it
         auto begin() -> iterator {
+            promote_numbers();
             switch (m_value_t) {
                 case value_t::_OBJECT:
                     return iterator{m_json_value.m_object->begin()};
                 case value_t::_ARRAY:
                     return iterator{m_json_value.m_array->begin()};
+                case value_t::_SHAPED_OBJECT:
+                    return iterator{m_json_value.m_shaped_object->values_.begin(), iter_value_t::_SHAPED_OBJECT};
                 default:
                     return iterator{this};
             }
         }
 
         auto end() -> iterator {
+            promote_numbers();
             switch (m_value_t) {
                 case value_t::_OBJECT:
                     return iterator{m_json_value.m_object->end()};
                 case value_t::_ARRAY:
                     return iterator{m_json_value.m_array->end()};
+                case value_t::_SHAPED_OBJECT:
+                    return iterator{m_json_value.m_shaped_object->values_.end(), iter_value_t::_SHAPED_OBJECT};
                 default:
                     return iterator{this + 1};
             }
@@ -197,6 +305,10 @@ namespace cjson {
                     return const_iterator{m_json_value.m_object->begin()};
                 case value_t::_ARRAY:
                     return const_iterator{m_json_value.m_array->begin()};
+                case value_t::_NUMBER_ARRAY:
+                    return const_iterator{m_json_value.m_number_array->values().begin()};
+                case value_t::_SHAPED_OBJECT:
+                    return const_iterator{m_json_value.m_shaped_object->values_.begin(), iter_value_t::_SHAPED_OBJECT};
                 default:
                     return const_iterator{this};
             }
@@ -208,6 +320,10 @@ namespace cjson {
                     return const_iterator{m_json_value.m_object->end()};
                 case value_t::_ARRAY:
                     return const_iterator{m_json_value.m_array->end()};
+                case value_t::_NUMBER_ARRAY:
+                    return const_iterator{m_json_value.m_number_array->values().end()};
+                case value_t::_SHAPED_OBJECT:
+                    return const_iterator{m_json_value.m_shaped_object->values_.end(), iter_value_t::_SHAPED_OBJECT};
                 default:
                     return const_iterator{this + 1};
             }
@@ -219,6 +335,10 @@ namespace cjson {
                     return const_iterator{m_json_value.m_object->begin()};
                 case value_t::_ARRAY:
                     return const_iterator{m_json_value.m_array->begin()};
+                case value_t::_NUMBER_ARRAY:
+                    return const_iterator{m_json_value.m_number_array->values().begin()};
+                case value_t::_SHAPED_OBJECT:
+                    return const_iterator{m_json_value.m_shaped_object->values_.begin(), iter_value_t::_SHAPED_OBJECT};
                 default:
                     return const_iterator{this};
             }
@@ -230,6 +350,10 @@ namespace cjson {
                     return const_iterator{m_json_value.m_object->end()};
                 case value_t::_ARRAY:
                     return const_iterator{m_json_value.m_array->end()};
+                case value_t::_NUMBER_ARRAY:
+                    return const_iterator{m_json_value.m_number_array->values().end()};
+                case value_t::_SHAPED_OBJECT:
+                    return const_iterator{m_json_value.m_shaped_object->values_.end(), iter_value_t::_SHAPED_OBJECT};
                 default:
                     return const_iterator{this + 1};
             }
@@ -262,6 +386,8 @@ namespace cjson {
         auto swap(basic_json& other) noexcept -> void {
             std::swap(m_json_value, other.m_json_value);
             std::swap(m_value_t, other.m_value_t);
+            revise();
+            other.revise();
         }
 
         auto size() const noexcept -> size_type {
@@ -274,6 +400,10 @@ namespace cjson {
                     return m_json_value.m_object->size();
                 case value_t::_ARRAY:
                     return m_json_value.m_array->size();
+                case value_t::_NUMBER_ARRAY:
+                    return m_json_value.m_number_array->numbers().size();
+                case value_t::_SHAPED_OBJECT:
+                    return m_json_value.m_shaped_object->values_.size();
                 default:
                     return 1;
             }
@@ -289,6 +419,10 @@ namespace cjson {
                     return m_json_value.m_object->max_size();
                 case value_t::_ARRAY:
                     return m_json_value.m_array->max_size();
+                case value_t::_NUMBER_ARRAY:
+                    return m_json_value.m_number_array->numbers().max_size();
+                case value_t::_SHAPED_OBJECT:
+                    return m_json_value.m_shaped_object->values_.max_size();
                 default:
                     return 1;
             }
@@ -300,12 +434,16 @@ namespace cjson {
 
         template <typename... Args>
         auto emplace(const_iterator position, Args&& ...args) -> iterator {
+            revise();
+            to_generic(position);
             return iterator{m_json_value.m_array->emplace(position.m_iter_value.m_array_iter,
                 std::forward<Args>(args)...)};
         }
 
         template <typename... Args>
         auto emplace(Args&& ...args) -> std::pair<iterator, bool> {
+            revise();
+            to_generic();
             const auto &[iter, insert_success] = m_json_value.m_object->emplace(std::forward<Args>(args)...);
             return std::make_pair(iterator{iter}, insert_success);
         }
@@ -315,6 +453,8 @@ namespace cjson {
             {o.emplace_hint(hint, std::forward<Args>(args)...)} -> std::same_as<typename object::iterator>;
         })
         auto emplace_hint(const_iterator hint, Args&& ...args) -> iterator {
+            revise();
+            to_generic(hint);
             return iterator{m_json_value.m_object->emplace_hint(hint.m_iter_value.m_object_iter,
                 std::forward<Args>(args)...)};
         }
@@ -325,6 +465,8 @@ namespace cjson {
                 -> std::same_as<std::pair<typename object::iterator, bool>>;
         })
         auto try_emplace(const object::key_type& key, Args&& ...args) -> std::pair<iterator, bool> {
+            revise();
+            to_generic();
             const auto &[iter, insert_success] =
                 m_json_value.m_object->try_emplace(key, std::forward<Args>(args)...);
             return std::make_pair(iterator{iter}, insert_success);
@@ -336,6 +478,8 @@ namespace cjson {
                 -> std::same_as<std::pair<typename object::iterator, bool>>;
         })
         auto try_emplace(object::key_type&& key, Args&& ...args) -> std::pair<iterator, bool> {
+            revise();
+            to_generic();
             const auto &[iter, insert_success] =
                 m_json_value.m_object->try_emplace(std::move(key), std::forward<Args>(args)...);
             return std::make_pair(iterator{iter}, insert_success);
@@ -347,6 +491,8 @@ namespace cjson {
                 -> std::same_as<typename object::iterator>;
         })
         auto try_emplace(const_iterator hint, const object::key_type& key, Args&& ...args) -> iterator {
+            revise();
+            to_generic(hint);
             return iterator{m_json_value.m_object->try_emplace(hint.m_iter_value.m_object_iter,
                 key, std::forward<Args>(args)...)};
         }
@@ -357,68 +503,96 @@ namespace cjson {
                 -> std::same_as<typename object::iterator>;
         })
         auto try_emplace(const_iterator hint, object::key_type&& key, Args&& ...args) -> iterator {
+            revise();
+            to_generic(hint);
             return iterator{m_json_value.m_object->try_emplace(hint.m_iter_value.m_object_iter,
                 std::move(key), std::forward<Args>(args)...)};
         }
 
         auto insert(const_iterator position, const typename array::value_type& value) -> iterator {
+            revise();
+            to_generic(position);
             return iterator{m_json_value.m_array->insert(position.m_iter_value.m_array_iter, value)};
         }
 
         auto insert(const_iterator position, typename array::value_type&& value) -> iterator {
-            return iterator{m_json_value.m_array->insert(position.m_iter_value.m_array_iter, value)};
+            revise();
+            to_generic(position);
+            return iterator{m_json_value.m_array->insert(position.m_iter_value.m_array_iter, std::move(value))};
         }
 
         auto insert(const_iterator position, size_type n, const typename array::value_type& value) -> iterator {
+            revise();
+            to_generic(position);
             return iterator{m_json_value.m_array->insert(position.m_iter_value.m_array_iter, n, value)};
         }
 
         template <std::input_iterator InputIterator>
         requires std::is_same_v<std::iter_value_t<InputIterator>, typename array::value_type>
         auto insert(const_iterator position, InputIterator first, InputIterator last) -> iterator {
+            revise();
+            to_generic(position);
             return iterator{m_json_value.m_array->insert(position.m_iter_value.m_array_iter, first, last)};
         }
 
         auto insert(const_iterator position, std::initializer_list<typename array::value_type> il) -> iterator {
+            revise();
+            to_generic(position);
             return iterator{m_json_value.m_array->insert(position.m_iter_value.m_array_iter, il)};
         }
 
         auto insert(const object::value_type& value) -> std::pair<iterator, bool> {
+            revise();
+            to_generic();
             const auto &[iter, insert_success] = m_json_value.m_object->insert(value);
             return std::make_pair(iterator{iter}, insert_success);
         }
 
         auto insert(object::value_type&& value) -> std::pair<iterator, bool> {
+            revise();
+            to_generic();
             const auto &[iter, insert_success] = m_json_value.m_object->insert(std::move(value));
             return std::make_pair(iterator{iter}, insert_success);
         }
 
         template <class Pair>
         auto insert(Pair&& value) -> std::pair<iterator, bool> {
-            const auto &[iter, insert_success] = m_json_value.m_object->insert(std::move(value));
+            revise();
+            to_generic();
+            const auto &[iter, insert_success] = m_json_value.m_object->insert(std::forward<Pair>(value));
             return std::make_pair(iterator{iter}, insert_success);
         }
 
         auto insert(const_iterator hint, const object::value_type& value) -> iterator {
+            revise();
+            to_generic(hint);
             return iterator{m_json_value.m_object->insert(hint.m_iter_value.m_object_iter, value)};
         }
 
         auto insert(const_iterator hint, object::value_type&& value) -> iterator {
+            revise();
+            to_generic(hint);
             return iterator{m_json_value.m_object->insert(hint.m_iter_value.m_object_iter, std::move(value))};
         }
 
         template <class P>
         auto insert(const_iterator hint, P&& value) -> iterator {
-            return iterator{m_json_value.m_object->insert(hint.m_iter_value.m_object_iter, std::move(value))};
+            revise();
+            to_generic(hint);
+            return iterator{m_json_value.m_object->insert(hint.m_iter_value.m_object_iter, std::forward<P>(value))};
         }
 
         template <std::input_iterator InputIterator>
         requires std::is_same_v<std::iter_value_t<InputIterator>, typename object::value_type>
         auto insert(InputIterator first, InputIterator last) -> void {
+            revise();
+            to_generic();
             m_json_value.m_object->insert(first, last);
         }
 
         auto insert(std::initializer_list<typename object::value_type> il) -> void {
+            revise();
+            to_generic();
             m_json_value.m_object->insert(il);
         }
 
@@ -428,6 +602,8 @@ namespace cjson {
                 -> std::same_as<std::pair<typename object::iterator, bool>>;
         })
         auto insert_or_assign(const object::key_type& key, Json&& value) -> std::pair<iterator, bool> {
+            revise();
+            to_generic();
             const auto &[iter, insert_success] = m_json_value.m_object->insert_or_assign(key, std::forward<Json>(value));
             return std::make_pair(iterator{iter}, insert_success);
         }
@@ -438,6 +614,8 @@ namespace cjson {
                 -> std::same_as<std::pair<typename object::iterator, bool>>;
         })
         auto insert_or_assign(object::key_type&& key, Json&& value) -> std::pair<iterator, bool> {
+            revise();
+            to_generic();
             const auto &[iter, insert_success] = m_json_value.m_object->insert_or_assign(std::move(key), std::forward<Json>(value));
             return std::make_pair(iterator{iter}, insert_success);
         }
@@ -448,6 +626,8 @@ namespace cjson {
                 -> std::same_as<std::pair<typename object::iterator, bool>>;
         })
         auto insert_or_assign(const_iterator hint, const object::key_type& key, Json&& value) -> iterator {
+            revise();
+            to_generic(hint);
             const auto &[iter, insert_success] =
                 m_json_value.m_object->insert_or_assign(hint, std::move(key), std::forward<Json>(value));
             return std::make_pair(iterator{iter}, insert_success);
@@ -459,12 +639,16 @@ namespace cjson {
                 -> std::same_as<std::pair<typename object::iterator, bool>>;
         })
         auto insert_or_assign(const_iterator hint, object::key_type&& key, Json&& value) -> iterator {
+            revise();
+            to_generic(hint);
             const auto &[iter, insert_success] =
                 m_json_value.m_object->insert_or_assign(hint, std::move(key), std::forward<Json>(value));
             return std::make_pair(iterator{iter}, insert_success);
         }
 
         auto erase(const_iterator position) -> iterator {
+            revise();
+            to_generic(position);
             switch (position.m_iter_value_t) {
                 case iter_value_t::_OBJECT:
                     return iterator{m_json_value.m_object->erase(position.m_iter_value.m_object_iter)};
@@ -477,6 +661,8 @@ namespace cjson {
         }
 
         auto erase(const_iterator first, const_iterator last) -> iterator {
+            revise();
+            to_generic(first, last);
             switch (first.m_iter_value_t) {
                 case iter_value_t::_OBJECT:
                     return iterator{m_json_value.m_object->erase(first.m_iter_value.m_object_iter,
@@ -490,11 +676,79 @@ namespace cjson {
             }
         }
 
+        auto at(const object::key_type& key) -> reference {
+            if (m_value_t == value_t::_SHAPED_OBJECT) {
+                return m_json_value.m_shaped_object->values_[shaped_index(key)];
+            }
+            return m_json_value.m_object->at(key);
+        }
+
+        auto at(const object::key_type& key) const -> const_reference {
+            if (m_value_t == value_t::_SHAPED_OBJECT) {
+                return m_json_value.m_shaped_object->values_[shaped_index(key)];
+            }
+            return m_json_value.m_object->at(key);
+        }
+
+        auto contains(const object::key_type& key) const -> bool {
+            if (m_value_t == value_t::_SHAPED_OBJECT) {
+                return m_json_value.m_shaped_object->shape_->find(key).has_value();
+            }
+            return m_json_value.m_object->contains(key);
+        }
+
         auto erase(const object::key_type& key) -> size_type {
+            if (not contains(key)) {
+                return 0;
+            }
+            revise();
+            to_generic();
             return m_json_value.m_object->erase(key);
         }
 
+        // the lookups by key for other key types leave the query as it is, so that a lookup on
+        // interned keys neither interns the query nor takes the pool's lock
+        template <typename Key>
+        requires detail::heterogeneous_key<object, Key>
+        auto at(const Key& key) -> reference {
+            if (m_value_t == value_t::_SHAPED_OBJECT) {
+                return m_json_value.m_shaped_object->values_[shaped_index(std::string_view{key})];
+            }
+            return find_member(std::string_view{key})->second;
+        }
+
+        template <typename Key>
+        requires detail::heterogeneous_key<object, Key>
+        auto at(const Key& key) const -> const_reference {
+            if (m_value_t == value_t::_SHAPED_OBJECT) {
+                return m_json_value.m_shaped_object->values_[shaped_index(std::string_view{key})];
+            }
+            return find_member(std::string_view{key})->second;
+        }
+
+        template <typename Key>
+        requires detail::heterogeneous_key<object, Key>
+        auto contains(const Key& key) const -> bool {
+            if (m_value_t == value_t::_SHAPED_OBJECT) {
+                return m_json_value.m_shaped_object->shape_->find(std::string_view{key}).has_value();
+            }
+            return m_json_value.m_object->contains(std::string_view{key});
+        }
+
+        template <typename Key>
+        requires detail::heterogeneous_key<object, Key>
+        auto erase(const Key& key) -> size_type {
+            if (not contains(key)) {
+                return 0;
+            }
+            revise();
+            to_generic();
+            m_json_value.m_object->erase(m_json_value.m_object->find(std::string_view{key}));
+            return 1;
+        }
+
         auto clear() noexcept -> void {
+            revise();
             switch (m_value_t) {
                 case value_t::_STRING:
                     m_json_value.m_string->clear();
@@ -505,6 +759,17 @@ namespace cjson {
                 case value_t::_ARRAY:
                     m_json_value.m_array->clear();
                     break;
+                case value_t::_NUMBER_ARRAY:
+                    m_json_value.m_number_array->drop_values();
+                    m_json_value.m_number_array->numbers().clear();
+                    break;
+                case value_t::_SHAPED_OBJECT: {
+                    const auto shaped = m_json_value.m_shaped_object;
+                    m_json_value = object{};
+                    m_value_t = value_t::_OBJECT;
+                    destroy_heap_object<Alloc<shaped_object>, shaped_object>(shaped);
+                    break;
+                }
                 default:
                     m_json_value = {};
                     m_value_t = {};
@@ -515,14 +780,20 @@ namespace cjson {
         template <std::input_iterator InputIterator>
         requires std::is_same_v<std::iter_value_t<InputIterator>, typename array::value_type>
         auto assign(InputIterator first, InputIterator last) -> void {
+            revise();
+            to_generic();
             m_json_value.m_array->assign(first, last);
         }
 
         auto assign(std::initializer_list<typename array::value_type> il) -> void {
+            revise();
+            to_generic();
             m_json_value.m_array->assign(il);
         }
 
         auto assign(size_type n, const typename array::value_type& value) -> void {
+            revise();
+            to_generic();
             m_json_value.m_array->assign(n, value);
         }
 
@@ -540,74 +811,312 @@ namespace cjson {
         }
 
         auto back() const -> const_reference
-            requires (requires (array a) { {a.back()} -> std::same_as<typename array::const_reference>; }) {
+            requires (requires (const array a) { {a.back()} -> std::same_as<typename array::const_reference>; }) {
             return *(--cend());
         }
 
         template <typename ...Args>
         requires (requires (array a) { {a.emplace_front()} -> std::same_as<typename array::reference>; })
         auto emplace_front(Args&& ...args) -> reference {
+            revise();
+            to_generic();
             return m_json_value.m_array->emplace_front(std::forward<Args>(args)...);
         }
 
         template <typename ...Args>
         requires (requires (array a) { {a.emplace_back()} -> std::same_as<typename array::reference>; })
         auto emplace_back(Args&& ...args) -> reference {
+            revise();
+            to_generic();
             return m_json_value.m_array->emplace_back(std::forward<Args>(args)...);
         }
 
         auto push_front(const value_type& js) -> void
             requires (requires (array a) { {a.push_front(js)} -> std::same_as<void>; }) {
+            revise();
+            to_generic();
             m_json_value.m_array->push_front(js);
         }
 
         auto push_front(value_type&& js) -> void
             requires (requires (array a) { {a.push_front(js)} -> std::same_as<void>; }) {
+            revise();
+            to_generic();
             m_json_value.m_array->push_front(std::forward<value_type>(js));
         }
 
         auto push_back(const value_type& js) -> void
             requires (requires (array a) { {a.push_back(js)} -> std::same_as<void>; }) {
+            revise();
+            if (m_value_t == value_t::_NUMBER_ARRAY and js.m_value_t == value_t::_NUMBER) {
+                m_json_value.m_number_array->drop_values();
+                m_json_value.m_number_array->numbers().push_back(js.m_json_value.m_number);
+                return;
+            }
+            to_generic();
             m_json_value.m_array->push_back(js);
         }
 
         auto push_back(value_type&& js) -> void
             requires (requires (array a) { {a.push_back(js)} -> std::same_as<void>; }) {
+            revise();
+            if (m_value_t == value_t::_NUMBER_ARRAY and js.m_value_t == value_t::_NUMBER) {
+                m_json_value.m_number_array->drop_values();
+                m_json_value.m_number_array->numbers().push_back(js.m_json_value.m_number);
+                return;
+            }
+            to_generic();
             m_json_value.m_array->push_back(std::forward<value_type>(js));
         }
 
         auto pop_front() -> void
             requires (requires (array a) { {a.pop_front()} -> std::same_as<void>; }) {
+            revise();
+            to_generic();
             m_json_value.m_array->pop_front();
         }
 
         auto pop_back() -> void
             requires (requires (array a) { {a.pop_back()} -> std::same_as<void>; }) {
+            revise();
+            if (m_value_t == value_t::_NUMBER_ARRAY) {
+                m_json_value.m_number_array->drop_values();
+                m_json_value.m_number_array->numbers().pop_back();
+                return;
+            }
             m_json_value.m_array->pop_back();
         }
 
         auto operator[](size_type n) -> reference
             requires (requires (array a) { {a.operator[](n)} -> std::same_as<typename array::reference>; }) {
+            promote_numbers();
             return (*m_json_value.m_array)[n];
         }
 
         auto operator[](size_type n) const -> const_reference
             requires (requires (const array a) { {a.operator[](n)} -> std::same_as<typename array::const_reference>; }) {
-            return (*m_json_value.m_array)[n];
+            return elements()[n];
         }
 
         auto at(size_type n) -> reference
             requires (requires (array a) { {a.at(n)} -> std::same_as<typename array::reference>; }) {
+            promote_numbers();
             return m_json_value.m_array->at(n);
         }
 
         auto at(size_type n) const -> const_reference
             requires (requires (const array a) { {a.at(n)} -> std::same_as<typename array::const_reference>; }) {
-            return m_json_value.m_array->at(n);
+            return elements().at(n);
+        }
+
+        // the elements of a number array as json_refs, which read and write the numbers in place
+        auto numbers() -> number_view {
+            check_type(value_t::_NUMBER_ARRAY, "number array");
+            return number_view{*this};
+        }
+
+        auto numbers() const -> const_number_view {
+            check_type(value_t::_NUMBER_ARRAY, "number array");
+            return const_number_view{*this};
+        }
+
+        auto is_null() const noexcept -> bool {
+            return m_value_t == value_t::_NULL;
+        }
+
+        auto is_number() const noexcept -> bool {
+            return m_value_t == value_t::_NUMBER;
+        }
+
+        auto is_boolean() const noexcept -> bool {
+            return m_value_t == value_t::_BOOLEAN;
+        }
+
+        auto is_string() const noexcept -> bool {
+            return m_value_t == value_t::_STRING;
+        }
+
+        auto is_object() const noexcept -> bool {
+            return m_value_t == value_t::_OBJECT or m_value_t == value_t::_SHAPED_OBJECT;
+        }
+
+        auto is_array() const noexcept -> bool {
+            return m_value_t == value_t::_ARRAY or m_value_t == value_t::_NUMBER_ARRAY;
+        }
+
+        auto is_number_array() const noexcept -> bool {
+            return m_value_t == value_t::_NUMBER_ARRAY;
+        }
+
+        auto is_shaped_object() const noexcept -> bool {
+            return m_value_t == value_t::_SHAPED_OBJECT;
+        }
+
+        auto sum() const -> number {
+            return reduce_numbers([](const number* first, const size_type n) {
+                return detail::simd::sum(first, n);
+            }, [](const number acc, const number n) {
+                return acc + n;
+            });
+        }
+
+        auto min() const -> number {
+            return reduce_numbers([](const number* first, const size_type n) {
+                if (n == 0) {
+                    throw std::out_of_range("min() called on an empty json array");
+                }
+                return detail::simd::min(first, n);
+            }, [](const number acc, const number n) {
+                return std::min(acc, n);
+            });
+        }
+
+        auto max() const -> number {
+            return reduce_numbers([](const number* first, const size_type n) {
+                if (n == 0) {
+                    throw std::out_of_range("max() called on an empty json array");
+                }
+                return detail::simd::max(first, n);
+            }, [](const number acc, const number n) {
+                return std::max(acc, n);
+            });
+        }
+
+        explicit operator number() const {
+            check_type(value_t::_NUMBER, "number");
+            return m_json_value.m_number;
+        }
+
+        explicit operator boolean() const {
+            check_type(value_t::_BOOLEAN, "boolean");
+            return m_json_value.m_boolean;
+        }
+
+        explicit operator string&() {
+            revise();
+            check_type(value_t::_STRING, "string");
+            return *m_json_value.m_string;
+        }
+
+        explicit operator const string&() const {
+            check_type(value_t::_STRING, "string");
+            return *m_json_value.m_string;
+        }
+
+        explicit operator object&() {
+            revise();
+            to_generic();
+            check_type(value_t::_OBJECT, "object");
+            return *m_json_value.m_object;
+        }
+
+        // a shaped object has no generic object to refer to: read it through items(), its
+        // iterators, at() or visit, or convert it non-const
+        explicit operator const object&() const {
+            check_elements();
+            check_type(value_t::_OBJECT, "object");
+            return *m_json_value.m_object;
+        }
+
+        // the members of an object with their keys, in key order. shaped objects are read in
+        // place, so this works on any object through a const json
+        auto items() const -> object_view {
+            if (m_value_t == value_t::_SHAPED_OBJECT) {
+                return object_view{*m_json_value.m_shaped_object};
+            }
+            check_type(value_t::_OBJECT, "object");
+            return object_view{*m_json_value.m_object};
+        }
+
+        explicit operator array&() {
+            revise();
+            to_generic();
+            check_type(value_t::_ARRAY, "array");
+            return *m_json_value.m_array;
+        }
+
+        // a number array gives the json values made of its numbers, see detail::json_numbers
+        explicit operator const array&() const {
+            if (m_value_t != value_t::_NUMBER_ARRAY) {
+                check_type(value_t::_ARRAY, "array");
+            }
+            return elements();
+        }
+
+        // calls visitor with the stored value in its current representation: null, number, boolean,
+        // string, object, array, number_array or shaped_object
+        template <typename Visitor>
+        auto visit(Visitor&& visitor) const -> decltype(auto) {
+            switch (m_value_t) {
+                case value_t::_NUMBER:
+                    return std::forward<Visitor>(visitor)(m_json_value.m_number);
+                case value_t::_BOOLEAN:
+                    return std::forward<Visitor>(visitor)(m_json_value.m_boolean);
+                case value_t::_STRING:
+                    return std::forward<Visitor>(visitor)(std::as_const(*m_json_value.m_string));
+                case value_t::_OBJECT:
+                    return std::forward<Visitor>(visitor)(std::as_const(*m_json_value.m_object));
+                case value_t::_ARRAY:
+                    return std::forward<Visitor>(visitor)(std::as_const(*m_json_value.m_array));
+                case value_t::_NUMBER_ARRAY:
+                    return std::forward<Visitor>(visitor)(std::as_const(m_json_value.m_number_array->numbers()));
+                case value_t::_SHAPED_OBJECT:
+                    return std::forward<Visitor>(visitor)(std::as_const(*m_json_value.m_shaped_object));
+                case value_t::_NULL:
+                default:
+                    return std::forward<Visitor>(visitor)(null{});
+            }
+        }
+
+        auto dump(const std::size_t indent = 0) const -> std::string {
+            auto str = std::string{};
+            dump_to(detail::output::string_sink{str}, {.indent = indent});
+            return str;
+        }
+
+        // reuses the cached output of unchanged containers, see fragment_cache; only a json that
+        // tracks revisions can tell which those are
+        auto dump(detail::output::fragment_cache& cache) const -> std::string
+            requires detail::json_tracks_revisions<Types>::value {
+            auto str = std::string{};
+            dump_to(detail::output::string_sink{str}, cache);
+            return str;
+        }
+
+        // exact number of bytes dump_to and dump_into produce with the same options
+        auto serialized_size(const detail::output::dump_options& options = {}) const -> std::size_t {
+            auto sink = detail::output::counting_sink{};
+            dump_to(sink, options);
+            return sink.size();
+        }
+
+        // writes into buffer and returns the number of bytes written; throws std::length_error if
+        // buffer holds fewer than serialized_size(options) bytes
+        auto dump_into(const std::span<char> buffer, const detail::output::dump_options& options = {}) const
+            -> std::size_t {
+            auto sink = detail::output::span_sink{buffer.data(), buffer.data() + buffer.size()};
+            dump_to(sink, options);
+            return sink.size();
+        }
+
+        // streams the value into sink without building an intermediate string
+        template <detail::output::json_sink Sink>
+        auto dump_to(Sink&& sink, const detail::output::dump_options& options = {}) const -> void {
+            detail::output::json_serializer{sink, options}.dump(*this);
+        }
+
+        template <detail::output::json_sink Sink>
+        auto dump_to(Sink&& sink, detail::output::fragment_cache& cache) const -> void
+            requires detail::json_tracks_revisions<Types>::value {
+            detail::output::json_serializer{sink, cache}.dump(*this);
         }
 
         friend auto operator==(const basic_json& js1, const basic_json& js2) noexcept -> bool {
-            if (js1.m_value_t != js2.m_value_t) {
+            if (js1.m_value_t == value_t::_NUMBER_ARRAY or js2.m_value_t == value_t::_NUMBER_ARRAY) {
+                return number_arrays_equal(js1, js2);
+            } else if (js1.m_value_t == value_t::_SHAPED_OBJECT or js2.m_value_t == value_t::_SHAPED_OBJECT) {
+                return shaped_objects_equal(js1, js2);
+            } else if (js1.m_value_t != js2.m_value_t) {
                 return false;
             } else {
                 auto equal = false;
@@ -630,13 +1139,16 @@ namespace cjson {
                     case value_t::_ARRAY:
                         equal = *js1.m_json_value.m_array == *js2.m_json_value.m_array;
                         break;
+                    default:
+                        break;
                 }
                 return equal;
             }
         }
 
-        friend auto operator<<(std::ostream& os, const basic_json& js) noexcept -> std::ostream& {
-            os << js.do_dump(0, 1);
+        friend auto operator<<(std::ostream& os, const basic_json& js) -> std::ostream& {
+            auto sink = detail::output::stream_sink{os};
+            detail::output::json_serializer{sink}.dump(js);
             return os;
         }
 
@@ -645,48 +1157,198 @@ namespace cjson {
         }
 
     private:
-        auto do_dump(const std::size_t& indent, const std::size_t& level) const noexcept -> std::string {
-            const auto newline_str = std::string{(indent != 0) ? "\n" : ""};
-            const auto indent_level = std::string(level * indent, ' ');
-            auto str = std::string{};
-            auto i = 0u;
-            switch (m_value_t) {
-                case value_t::_NULL:
-                    str += "null";
-                    break;
-                case value_t::_NUMBER:
-                    str += std::to_string(m_json_value.m_number);
-                    break;
-                case value_t::_BOOLEAN:
-                    str += m_json_value.m_boolean ? "true" : "false";
-                    break;
-                case value_t::_STRING:
-                    str += "\"" + *m_json_value.m_string + "\"";
-                    break;
-                case value_t::_OBJECT:
-                    str += "{" + newline_str;
-                    for (const auto& [key, val] : *m_json_value.m_object) {
-                        str += indent_level + "\"" + key + "\": " + val.do_dump(indent, level + 1);
-                        if (++i < m_json_value.m_object->size()) {
-                            str += ", ";
-                        }
-                        str += newline_str;
-                    }
-                    str += std::string((level - 1) * indent, ' ') + "}";
-                    break;
-                case value_t::_ARRAY:
-                    str += "[" + newline_str;
-                    for (const auto& val : *m_json_value.m_array) {
-                        str += indent_level + val.do_dump(indent, level + 1);
-                        if (++i < m_json_value.m_array->size()) {
-                            str += ", ";
+        // called by everything that modifies the value, and by the casts that hand out its
+        // string, object or array for modification
+        auto revise() noexcept -> void {
+            m_revision.revise();
+        }
+
+        // number arrays and shaped objects are promoted to their generic form by the non-const
+        // accessors that need it, and never by reading. iterators given as positions are moved to
+        // the same element of the generic object; there are none into a number array, which
+        // gets promoted before it hands out any
+        template <typename ...Iterators>
+        auto to_generic(Iterators& ...positions) -> void {
+            if (m_value_t == value_t::_NUMBER_ARRAY) {
+                const auto numbers = m_json_value.m_number_array;
+                const auto values = numbers->release_values();
+                m_json_value.m_array = values ? values
+                    : construct_heap_object<Alloc<array>, array>(numbers->numbers().begin(), numbers->numbers().end());
+                m_value_t = value_t::_ARRAY;
+                destroy_heap_object<Alloc<number_storage>, number_storage>(numbers);
+            } else if (m_value_t == value_t::_SHAPED_OBJECT) {
+                const auto shaped = m_json_value.m_shaped_object;
+                [[maybe_unused]] const auto offsets = std::array<difference_type, sizeof...(Iterators)>{
+                    (positions.m_iter_value.m_array_iter - shaped->values_.begin())...};
+                const auto generic = construct_heap_object<Alloc<object>, object>();
+                for (size_type i = 0; i < shaped->values_.size(); ++i) {
+                    generic->emplace_hint(generic->end(), shaped->shape_->key(i), std::move(shaped->values_[i]));
+                }
+                m_json_value.m_object = generic;
+                m_value_t = value_t::_OBJECT;
+                destroy_heap_object<Alloc<shaped_object>, shaped_object>(shaped);
+                [[maybe_unused]] auto i = std::size_t{0};
+                ((positions = const_iterator{std::next(m_json_value.m_object->begin(), offsets[i++])}), ...);
+            }
+        }
+
+        auto promote_numbers() -> void {
+            if (m_value_t == value_t::_NUMBER_ARRAY) {
+                to_generic();
+            }
+        }
+
+        // the element at n of a number array, for json_ref. the array is looked at anew each
+        // time, since it may have been promoted through another json_ref in the meantime
+        auto element(const size_type n) const -> basic_json {
+            if (m_value_t == value_t::_NUMBER_ARRAY) {
+                return basic_json{m_json_value.m_number_array->numbers()[n]};
+            }
+            return (*m_json_value.m_array)[n];
+        }
+
+        auto number_element(const size_type n) const -> number {
+            if (m_value_t == value_t::_NUMBER_ARRAY) {
+                return m_json_value.m_number_array->numbers()[n];
+            }
+            return static_cast<number>((*m_json_value.m_array)[n]);
+        }
+
+        // assigns js to the element at n of a number array through a json_ref: in place if js is
+        // a number, otherwise after promoting the array
+        template <typename Json>
+        auto assign_element(const size_type n, Json&& js) -> void {
+            revise();
+            if (m_value_t == value_t::_NUMBER_ARRAY and js.m_value_t == value_t::_NUMBER) {
+                m_json_value.m_number_array->assign(n, js.m_json_value.m_number);
+                return;
+            }
+            to_generic();
+            (*m_json_value.m_array)[n] = std::forward<Json>(js);
+        }
+
+        auto check_index(const size_type n) const -> void {
+            if (n >= size()) {
+                throw std::out_of_range("json array index out of range");
+            }
+        }
+
+        // the generic elements of an array; a number array makes them of its numbers the first
+        // time they are asked for, without changing its representation
+        auto elements() const -> const array& {
+            if (m_value_t == value_t::_NUMBER_ARRAY) {
+                return m_json_value.m_number_array->values();
+            }
+            return *m_json_value.m_array;
+        }
+
+        // a const json has no generic members to refer to while it is a shaped object
+        auto check_elements() const -> void {
+            if (m_value_t == value_t::_SHAPED_OBJECT) {
+                throw detail::json_type_error(
+                    "json object holds its members in shaped form: read them through items()");
+            }
+        }
+
+        template <typename Key>
+        auto shaped_index(const Key& key) const -> size_type {
+            const auto index = m_json_value.m_shaped_object->shape_->find(key);
+            if (not index) {
+                throw std::out_of_range("key not found in json object");
+            }
+            return *index;
+        }
+
+        auto find_member(const std::string_view key) const -> typename object::iterator {
+            const auto iter = m_json_value.m_object->find(key);
+            if (iter == m_json_value.m_object->end()) {
+                throw std::out_of_range("key not found in json object");
+            }
+            return iter;
+        }
+
+        // reduce takes contiguous numbers and also decides what an empty array gives; the
+        // elements of a generic array, and of a number array that is not contiguous, are folded
+        // one at a time with fold instead
+        template <typename Reduce, typename Fold>
+        auto reduce_numbers(Reduce reduce, Fold fold) const -> number {
+            if (m_value_t == value_t::_NUMBER_ARRAY) {
+                const auto& numbers = m_json_value.m_number_array->numbers();
+                if constexpr (std::ranges::contiguous_range<number_array>) {
+                    return reduce(std::ranges::data(numbers), std::ranges::size(numbers));
+                } else {
+                    return numbers.empty() ? reduce(nullptr, 0)
+                        : std::accumulate(std::next(numbers.begin()), numbers.end(), numbers.front(), fold);
+                }
+            } else if (m_value_t != value_t::_ARRAY) {
+                throw detail::json_type_error("numeric reduction requires a json array");
+            }
+            const auto& values = *m_json_value.m_array;
+            if (values.empty()) {
+                return reduce(nullptr, 0);
+            }
+            auto acc = values.front().reduced_number();
+            for (auto iter = std::next(values.begin()); iter != values.end(); ++iter) {
+                acc = fold(acc, iter->reduced_number());
+            }
+            return acc;
+        }
+
+        auto reduced_number() const -> number {
+            if (m_value_t != value_t::_NUMBER) {
+                throw detail::json_type_error("numeric reduction requires an array of numbers");
+            }
+            return m_json_value.m_number;
+        }
+
+        static auto shaped_objects_equal(const basic_json& js1, const basic_json& js2) noexcept -> bool {
+            const auto is_object = [](const basic_json& js) {
+                return js.m_value_t == value_t::_OBJECT or js.m_value_t == value_t::_SHAPED_OBJECT;
+            };
+            if (not is_object(js1) or not is_object(js2) or js1.size() != js2.size()) {
+                return false;
+            } else if (js1.m_value_t == js2.m_value_t) {
+                const auto& shaped1 = *js1.m_json_value.m_shaped_object;
+                const auto& shaped2 = *js2.m_json_value.m_shaped_object;
+                if (shaped1.shape_ != shaped2.shape_) {
+                    for (size_type i = 0; i < shaped1.values_.size(); ++i) {
+                        if (shaped1.shape_->key(i) != shaped2.shape_->key(i)) {
+                            return false;
                         }
-                        str += newline_str;
                     }
-                    str += std::string((level - 1) * indent, ' ') + "]";
-                    break;
+                }
+                return shaped1.values_ == shaped2.values_;
             }
-            return str;
+            const auto& shaped = (js1.m_value_t == value_t::_SHAPED_OBJECT)
+                ? *js1.m_json_value.m_shaped_object : *js2.m_json_value.m_shaped_object;
+            const auto& generic = (js1.m_value_t == value_t::_OBJECT)
+                ? *js1.m_json_value.m_object : *js2.m_json_value.m_object;
+            auto i = size_type{0};
+            for (const auto& [key, val] : generic) {
+                if (key != shaped.shape_->key(i) or not (val == shaped.values_[i])) {
+                    return false;
+                }
+                ++i;
+            }
+            return true;
+        }
+
+        static auto number_arrays_equal(const basic_json& js1, const basic_json& js2) noexcept -> bool {
+            const auto is_array = [](const basic_json& js) {
+                return js.m_value_t == value_t::_ARRAY or js.m_value_t == value_t::_NUMBER_ARRAY;
+            };
+            if (not is_array(js1) or not is_array(js2) or js1.size() != js2.size()) {
+                return false;
+            } else if (js1.m_value_t == js2.m_value_t) {
+                return js1.m_json_value.m_number_array->numbers() == js2.m_json_value.m_number_array->numbers();
+            }
+            const auto& numbers = (js1.m_value_t == value_t::_NUMBER_ARRAY)
+                ? js1.m_json_value.m_number_array->numbers() : js2.m_json_value.m_number_array->numbers();
+            const auto& values = (js1.m_value_t == value_t::_ARRAY)
+                ? *js1.m_json_value.m_array : *js2.m_json_value.m_array;
+            return std::equal(numbers.begin(), numbers.end(), values.begin(), [](const number& n, const basic_json& js) {
+                return js.m_value_t == value_t::_NUMBER and js.m_json_value.m_number == n;
+            });
         }
 
         template<typename A, typename T, typename... Args>
@@ -712,9 +1374,19 @@ namespace cjson {
             _BOOLEAN,
             _STRING,
             _OBJECT,
-            _ARRAY
+            _ARRAY,
+            _NUMBER_ARRAY,
+            _SHAPED_OBJECT
         };
 
+        auto check_type(const value_t expected, const char* type_name) const -> void {
+            if (m_value_t != expected) {
+                throw detail::json_type_error(std::string{"json value is not a "} + type_name);
+            }
+        }
+
+        using number_storage = detail::json_numbers<number_array, array, Alloc<array>>;
+
         union json_value {
             null m_null;
             number m_number;
@@ -722,6 +1394,8 @@ namespace cjson {
             string* m_string;
             object* m_object;
             array* m_array;
+            number_storage* m_number_array;
+            shaped_object* m_shaped_object;
 
             json_value() noexcept
                 : json_value{null{}} {}
@@ -743,10 +1417,21 @@ namespace cjson {
                 : m_object(construct_heap_object<Alloc<object>, object>(std::move(o))) {}
             json_value(array&& a) noexcept
                 : m_array(construct_heap_object<Alloc<array>, array>(std::move(a))) {}
+            json_value(const number_array& a) noexcept
+                : m_number_array(construct_heap_object<Alloc<number_storage>, number_storage>(a)) {}
+            json_value(number_array&& a) noexcept
+                : m_number_array(construct_heap_object<Alloc<number_storage>, number_storage>(std::move(a))) {}
+            json_value(const shaped_object& o) noexcept
+                : m_shaped_object(construct_heap_object<Alloc<shaped_object>, shaped_object>(o)) {}
+            json_value(shaped_object&& o) noexcept
+                : m_shaped_object(construct_heap_object<Alloc<shaped_object>, shaped_object>(std::move(o))) {}
         };
 
+        using revision_type = detail::json_revision<detail::json_tracks_revisions<Types>::value>;
+
         json_value m_json_value;
-        value_t m_value_t;
+        value_t m_value_t{value_t::_NULL};
+        [[no_unique_address]] revision_type m_revision;
     };
 }
 
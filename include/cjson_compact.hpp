@@ -0,0 +1,629 @@
+#ifndef CJSON_COMPACT_HPP
+#define CJSON_COMPACT_HPP
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "cjson_basic.hpp"
+#include "detail/cjson_error.hpp"
+#include "detail/cjson_compact_iterator.hpp"
+#include "detail/output/cjson_serializer.hpp"
+
+namespace cjson {
+    // an 8-byte json value: numbers are stored as plain doubles, every other type lives in the
+    // payload of a negative quiet NaN with the type tag in the upper 16 bits
+    template <typename Types, template<typename> class Alloc = std::allocator>
+    class basic_compact_json {
+        static_assert(std::is_same_v<typename Types::number_type, double>, "NaN-boxing requires double numbers");
+        static_assert(sizeof(void*) == sizeof(std::uint64_t), "NaN-boxing requires 64-bit pointers");
+
+    public:
+        using null = std::nullptr_t;
+        using number = typename Types::number_type;
+        using boolean = typename Types::boolean_type;
+        using string = typename Types::string_type;
+        using key = typename detail::json_key_type<Types>::type;
+        using object = typename Types::template object_type<
+            key, basic_compact_json<Types, Alloc>, Alloc<std::pair<const key, basic_compact_json<Types, Alloc>>>>;
+        using array = typename Types::template array_type<basic_compact_json<Types, Alloc>,
+            Alloc<basic_compact_json<Types, Alloc>>>;
+
+        using value_type = basic_compact_json;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using difference_type = std::ptrdiff_t;
+        using size_type = std::size_t;
+        using allocator_type = Alloc<basic_compact_json>;
+        using iterator = compact_json_iter<basic_compact_json>;
+        using const_iterator = compact_json_iter<const basic_compact_json>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        constexpr basic_compact_json() noexcept
+            : m_bits{_NULL_TAG} {}
+
+        explicit basic_compact_json(std::nullptr_t) noexcept
+            : m_bits{_NULL_TAG} {}
+
+        template <typename NUMBER>
+        requires (std::convertible_to<std::remove_cvref_t<NUMBER>, number>
+            and not std::same_as<std::remove_cvref_t<NUMBER>, boolean>)
+        explicit basic_compact_json(NUMBER n) noexcept
+            : m_bits{box_number(number(n))} {}
+
+        explicit basic_compact_json(boolean b) noexcept
+            : m_bits{_BOOLEAN_TAG | static_cast<std::uint64_t>(b)} {}
+
+        template <typename STRING>
+        requires std::convertible_to<std::remove_cvref_t<STRING>, string>
+        explicit basic_compact_json(STRING&& s)
+            : m_bits{box_pointer(_STRING_TAG,
+                construct_heap_object<Alloc<string>, string>(std::forward<STRING>(s)))} {}
+
+        explicit basic_compact_json(const object& o)
+            : m_bits{box_pointer(_OBJECT_TAG, construct_heap_object<Alloc<object>, object>(o))} {}
+
+        explicit basic_compact_json(object&& o)
+            : m_bits{box_pointer(_OBJECT_TAG, construct_heap_object<Alloc<object>, object>(std::move(o)))} {}
+
+        explicit basic_compact_json(const array& a)
+            : m_bits{box_pointer(_ARRAY_TAG, construct_heap_object<Alloc<array>, array>(a))} {}
+
+        explicit basic_compact_json(array&& a)
+            : m_bits{box_pointer(_ARRAY_TAG, construct_heap_object<Alloc<array>, array>(std::move(a)))} {}
+
+        basic_compact_json(std::initializer_list<typename array::value_type> il)
+            : basic_compact_json(array(il.begin(), il.end())) {}
+
+        basic_compact_json(std::initializer_list<typename object::value_type> il)
+            : basic_compact_json(object(il.begin(), il.end())) {}
+
+        template <typename JsonTypes, template<typename> class JsonAlloc>
+        explicit basic_compact_json(const basic_json<JsonTypes, JsonAlloc>& js)
+            : m_bits{_NULL_TAG} {
+            using source = basic_json<JsonTypes, JsonAlloc>;
+            js.visit([this](const auto& value) {
+                using T = std::remove_cvref_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, typename source::null>) {
+                    m_bits = _NULL_TAG;
+                } else if constexpr (std::is_same_v<T, typename source::number>) {
+                    m_bits = box_number(number(value));
+                } else if constexpr (std::is_same_v<T, typename source::boolean>) {
+                    m_bits = _BOOLEAN_TAG | static_cast<std::uint64_t>(value);
+                } else if constexpr (std::is_same_v<T, typename source::string>) {
+                    m_bits = box_pointer(_STRING_TAG, construct_heap_object<Alloc<string>, string>(value));
+                } else if constexpr (std::is_same_v<T, typename source::object>) {
+                    auto o = object{};
+                    for (const auto& [k, v] : value) {
+                        o.emplace_hint(o.end(), key(std::string_view{k}), basic_compact_json(v));
+                    }
+                    m_bits = box_pointer(_OBJECT_TAG, construct_heap_object<Alloc<object>, object>(std::move(o)));
+                } else if constexpr (std::is_same_v<T, typename source::shaped_object>) {
+                    auto o = object{};
+                    for (size_type i = 0; i < value.values_.size(); ++i) {
+                        o.emplace_hint(o.end(), key(std::string_view{value.shape_->key(i)}),
+                            basic_compact_json(value.values_[i]));
+                    }
+                    m_bits = box_pointer(_OBJECT_TAG, construct_heap_object<Alloc<object>, object>(std::move(o)));
+                } else {
+                    auto a = array{};
+                    a.reserve(value.size());
+                    for (const auto& v : value) {
+                        a.emplace_back(v);
+                    }
+                    m_bits = box_pointer(_ARRAY_TAG, construct_heap_object<Alloc<array>, array>(std::move(a)));
+                }
+            });
+        }
+
+        basic_compact_json(const basic_compact_json& other)
+            : m_bits{other.m_bits} {
+            switch (tag()) {
+                case _STRING_TAG:
+                    m_bits = box_pointer(_STRING_TAG, construct_heap_object<Alloc<string>, string>(*other.as_string()));
+                    break;
+                case _OBJECT_TAG:
+                    m_bits = box_pointer(_OBJECT_TAG, construct_heap_object<Alloc<object>, object>(*other.as_object()));
+                    break;
+                case _ARRAY_TAG:
+                    m_bits = box_pointer(_ARRAY_TAG, construct_heap_object<Alloc<array>, array>(*other.as_array()));
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        basic_compact_json(basic_compact_json&& other) noexcept
+            : m_bits{std::exchange(other.m_bits, _NULL_TAG)} {}
+
+        auto operator=(const basic_compact_json& other) -> basic_compact_json& {
+            if (this != &other) {
+                auto other_copy = other;
+                swap(other_copy);
+            }
+            return *this;
+        }
+
+        auto operator=(basic_compact_json&& other) noexcept -> basic_compact_json& {
+            if (this != &other) {
+                auto moved = basic_compact_json(std::move(other));
+                swap(moved);
+            }
+            return *this;
+        }
+
+        ~basic_compact_json() noexcept {
+            switch (tag()) {
+                case _STRING_TAG:
+                    destroy_heap_object<Alloc<string>, string>(as_string());
+                    break;
+                case _OBJECT_TAG:
+                    destroy_heap_object<Alloc<object>, object>(as_object());
+                    break;
+                case _ARRAY_TAG:
+                    destroy_heap_object<Alloc<array>, array>(as_array());
+                    break;
+                default:
+                    break;
+            }
+            m_bits = _NULL_TAG;
+        }
+
+        template <typename Json>
+        auto to_json() const -> Json {
+            switch (tag()) {
+                case _NULL_TAG:
+                    return Json(nullptr);
+                case _BOOLEAN_TAG:
+                    return Json(typename Json::boolean{as_boolean()});
+                case _STRING_TAG:
+                    return Json(typename Json::string{*as_string()});
+                case _OBJECT_TAG: {
+                    auto o = typename Json::object{};
+                    for (const auto& [k, v] : *as_object()) {
+                        o.emplace_hint(o.end(), typename Json::key(std::string_view{k}), v.template to_json<Json>());
+                    }
+                    return Json(std::move(o));
+                }
+                case _ARRAY_TAG: {
+                    auto a = typename Json::array{};
+                    a.reserve(as_array()->size());
+                    for (const auto& v : *as_array()) {
+                        a.push_back(v.template to_json<Json>());
+                    }
+                    return Json(std::move(a));
+                }
+                default:
+                    return Json(as_number());
+            }
+        }
+
+        constexpr auto get_allocator() -> allocator_type {
+            return allocator_type{};
+        }
+
+        auto begin() -> iterator {
+            switch (tag()) {
+                case _OBJECT_TAG:
+                    return iterator{as_object()->begin()};
+                case _ARRAY_TAG:
+                    return iterator{as_array()->begin()};
+                default:
+                    return iterator{this};
+            }
+        }
+
+        auto end() -> iterator {
+            switch (tag()) {
+                case _OBJECT_TAG:
+                    return iterator{as_object()->end()};
+                case _ARRAY_TAG:
+                    return iterator{as_array()->end()};
+                default:
+                    return iterator{this + 1};
+            }
+        }
+
+        auto begin() const -> const_iterator {
+            return cbegin();
+        }
+
+        auto end() const -> const_iterator {
+            return cend();
+        }
+
+        auto cbegin() const -> const_iterator {
+            switch (tag()) {
+                case _OBJECT_TAG:
+                    return const_iterator{as_object()->begin()};
+                case _ARRAY_TAG:
+                    return const_iterator{as_array()->begin()};
+                default:
+                    return const_iterator{this};
+            }
+        }
+
+        auto cend() const -> const_iterator {
+            switch (tag()) {
+                case _OBJECT_TAG:
+                    return const_iterator{as_object()->end()};
+                case _ARRAY_TAG:
+                    return const_iterator{as_array()->end()};
+                default:
+                    return const_iterator{this + 1};
+            }
+        }
+
+        auto rbegin() -> reverse_iterator {
+            return reverse_iterator{end()};
+        }
+
+        auto rend() -> reverse_iterator {
+            return reverse_iterator{begin()};
+        }
+
+        auto rbegin() const -> const_reverse_iterator {
+            return const_reverse_iterator{end()};
+        }
+
+        auto rend() const -> const_reverse_iterator {
+            return const_reverse_iterator{begin()};
+        }
+
+        auto crbegin() const -> const_reverse_iterator {
+            return const_reverse_iterator{end()};
+        }
+
+        auto crend() const -> const_reverse_iterator {
+            return const_reverse_iterator{begin()};
+        }
+
+        auto swap(basic_compact_json& other) noexcept -> void {
+            std::swap(m_bits, other.m_bits);
+        }
+
+        auto size() const noexcept -> size_type {
+            switch (tag()) {
+                case _NULL_TAG:
+                    return 0;
+                case _STRING_TAG:
+                    return as_string()->size();
+                case _OBJECT_TAG:
+                    return as_object()->size();
+                case _ARRAY_TAG:
+                    return as_array()->size();
+                default:
+                    return 1;
+            }
+        }
+
+        auto empty() const noexcept -> bool {
+            return size() == 0;
+        }
+
+        auto clear() noexcept -> void {
+            switch (tag()) {
+                case _STRING_TAG:
+                    as_string()->clear();
+                    break;
+                case _OBJECT_TAG:
+                    as_object()->clear();
+                    break;
+                case _ARRAY_TAG:
+                    as_array()->clear();
+                    break;
+                default:
+                    m_bits = _NULL_TAG;
+                    break;
+            }
+        }
+
+        template <typename... Args>
+        auto emplace(Args&& ...args) -> std::pair<iterator, bool> {
+            const auto &[iter, insert_success] = checked_object()->emplace(std::forward<Args>(args)...);
+            return std::make_pair(iterator{iter}, insert_success);
+        }
+
+        auto insert(const typename object::value_type& value) -> std::pair<iterator, bool> {
+            const auto &[iter, insert_success] = checked_object()->insert(value);
+            return std::make_pair(iterator{iter}, insert_success);
+        }
+
+        auto insert(typename object::value_type&& value) -> std::pair<iterator, bool> {
+            const auto &[iter, insert_success] = checked_object()->insert(std::move(value));
+            return std::make_pair(iterator{iter}, insert_success);
+        }
+
+        auto erase(const typename object::key_type& k) -> size_type {
+            return checked_object()->erase(k);
+        }
+
+        auto at(const typename object::key_type& k) -> reference {
+            return checked_object()->at(k);
+        }
+
+        auto at(const typename object::key_type& k) const -> const_reference {
+            return checked_object()->at(k);
+        }
+
+        auto contains(const typename object::key_type& k) const -> bool {
+            return checked_object()->contains(k);
+        }
+
+        template <typename ...Args>
+        auto emplace_back(Args&& ...args) -> reference {
+            return checked_array()->emplace_back(std::forward<Args>(args)...);
+        }
+
+        auto push_back(const value_type& js) -> void {
+            checked_array()->push_back(js);
+        }
+
+        auto push_back(value_type&& js) -> void {
+            checked_array()->push_back(std::move(js));
+        }
+
+        auto pop_back() -> void {
+            checked_array()->pop_back();
+        }
+
+        auto front() -> reference {
+            return *begin();
+        }
+
+        auto front() const -> const_reference {
+            return *cbegin();
+        }
+
+        auto back() -> reference {
+            return *(--end());
+        }
+
+        auto back() const -> const_reference {
+            return *(--cend());
+        }
+
+        auto operator[](size_type n) -> reference {
+            return (*as_array())[n];
+        }
+
+        auto operator[](size_type n) const -> const_reference {
+            return (*as_array())[n];
+        }
+
+        auto at(size_type n) -> reference {
+            return checked_array()->at(n);
+        }
+
+        auto at(size_type n) const -> const_reference {
+            return checked_array()->at(n);
+        }
+
+        auto is_null() const noexcept -> bool {
+            return m_bits == _NULL_TAG;
+        }
+
+        auto is_number() const noexcept -> bool {
+            return m_bits < _NULL_TAG;
+        }
+
+        auto is_boolean() const noexcept -> bool {
+            return tag() == _BOOLEAN_TAG;
+        }
+
+        auto is_string() const noexcept -> bool {
+            return tag() == _STRING_TAG;
+        }
+
+        auto is_object() const noexcept -> bool {
+            return tag() == _OBJECT_TAG;
+        }
+
+        auto is_array() const noexcept -> bool {
+            return tag() == _ARRAY_TAG;
+        }
+
+        explicit operator number() const {
+            check_type(is_number(), "number");
+            return as_number();
+        }
+
+        explicit operator boolean() const {
+            check_type(is_boolean(), "boolean");
+            return as_boolean();
+        }
+
+        explicit operator string&() {
+            check_type(is_string(), "string");
+            return *as_string();
+        }
+
+        explicit operator const string&() const {
+            check_type(is_string(), "string");
+            return *as_string();
+        }
+
+        explicit operator object&() {
+            return *checked_object();
+        }
+
+        explicit operator const object&() const {
+            return *checked_object();
+        }
+
+        explicit operator array&() {
+            return *checked_array();
+        }
+
+        explicit operator const array&() const {
+            return *checked_array();
+        }
+
+        template <typename Visitor>
+        auto visit(Visitor&& visitor) const -> decltype(auto) {
+            switch (tag()) {
+                case _NULL_TAG:
+                    return std::forward<Visitor>(visitor)(null{});
+                case _BOOLEAN_TAG:
+                    return std::forward<Visitor>(visitor)(as_boolean());
+                case _STRING_TAG:
+                    return std::forward<Visitor>(visitor)(std::as_const(*as_string()));
+                case _OBJECT_TAG:
+                    return std::forward<Visitor>(visitor)(std::as_const(*as_object()));
+                case _ARRAY_TAG:
+                    return std::forward<Visitor>(visitor)(std::as_const(*as_array()));
+                default:
+                    return std::forward<Visitor>(visitor)(as_number());
+            }
+        }
+
+        auto dump(const std::size_t indent = 0) const -> std::string {
+            auto str = std::string{};
+            dump_to(detail::output::string_sink{str}, {.indent = indent});
+            return str;
+        }
+
+        // exact number of bytes dump_to and dump_into produce with the same options
+        auto serialized_size(const detail::output::dump_options& options = {}) const -> std::size_t {
+            auto sink = detail::output::counting_sink{};
+            dump_to(sink, options);
+            return sink.size();
+        }
+
+        // writes into buffer and returns the number of bytes written; throws std::length_error if
+        // buffer holds fewer than serialized_size(options) bytes
+        auto dump_into(const std::span<char> buffer, const detail::output::dump_options& options = {}) const
+            -> std::size_t {
+            auto sink = detail::output::span_sink{buffer.data(), buffer.data() + buffer.size()};
+            dump_to(sink, options);
+            return sink.size();
+        }
+
+        // streams the value into sink without building an intermediate string
+        template <detail::output::json_sink Sink>
+        auto dump_to(Sink&& sink, const detail::output::dump_options& options = {}) const -> void {
+            detail::output::json_serializer{sink, options}.dump(*this);
+        }
+
+        friend auto operator==(const basic_compact_json& js1, const basic_compact_json& js2) noexcept -> bool {
+            if (js1.is_number() or js2.is_number()) {
+                return js1.is_number() and js2.is_number() and js1.as_number() == js2.as_number();
+            } else if (js1.tag() != js2.tag()) {
+                return false;
+            }
+            switch (js1.tag()) {
+                case _STRING_TAG:
+                    return *js1.as_string() == *js2.as_string();
+                case _OBJECT_TAG:
+                    return *js1.as_object() == *js2.as_object();
+                case _ARRAY_TAG:
+                    return *js1.as_array() == *js2.as_array();
+                default:
+                    return js1.m_bits == js2.m_bits;
+            }
+        }
+
+        friend auto operator<<(std::ostream& os, const basic_compact_json& js) -> std::ostream& {
+            auto sink = detail::output::stream_sink{os};
+            detail::output::json_serializer{sink}.dump(js);
+            return os;
+        }
+
+        friend auto swap(basic_compact_json& js1, basic_compact_json& js2) noexcept -> void {
+            js1.swap(js2);
+        }
+
+    private:
+        static constexpr std::uint64_t _TAG_MASK = 0xFFFF'0000'0000'0000;
+        static constexpr std::uint64_t _PAYLOAD_MASK = 0x0000'FFFF'FFFF'FFFF;
+        static constexpr std::uint64_t _CANONICAL_NAN = 0x7FF8'0000'0000'0000;
+        static constexpr std::uint64_t _NULL_TAG = 0xFFF9'0000'0000'0000;
+        static constexpr std::uint64_t _BOOLEAN_TAG = 0xFFFA'0000'0000'0000;
+        static constexpr std::uint64_t _STRING_TAG = 0xFFFB'0000'0000'0000;
+        static constexpr std::uint64_t _OBJECT_TAG = 0xFFFC'0000'0000'0000;
+        static constexpr std::uint64_t _ARRAY_TAG = 0xFFFD'0000'0000'0000;
+
+        static auto box_number(const number n) noexcept -> std::uint64_t {
+            return (n != n) ? _CANONICAL_NAN : std::bit_cast<std::uint64_t>(n);
+        }
+
+        template <typename T>
+        static auto box_pointer(const std::uint64_t tag, T* ptr) noexcept -> std::uint64_t {
+            return tag | static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(ptr));
+        }
+
+        auto tag() const noexcept -> std::uint64_t {
+            return is_number() ? 0 : (m_bits & _TAG_MASK);
+        }
+
+        auto as_number() const noexcept -> number {
+            return std::bit_cast<number>(m_bits);
+        }
+
+        auto as_boolean() const noexcept -> boolean {
+            return (m_bits & _PAYLOAD_MASK) != 0;
+        }
+
+        auto as_string() const noexcept -> string* {
+            return reinterpret_cast<string*>(static_cast<std::uintptr_t>(m_bits & _PAYLOAD_MASK));
+        }
+
+        auto as_object() const noexcept -> object* {
+            return reinterpret_cast<object*>(static_cast<std::uintptr_t>(m_bits & _PAYLOAD_MASK));
+        }
+
+        auto as_array() const noexcept -> array* {
+            return reinterpret_cast<array*>(static_cast<std::uintptr_t>(m_bits & _PAYLOAD_MASK));
+        }
+
+        auto checked_object() const -> object* {
+            check_type(is_object(), "object");
+            return as_object();
+        }
+
+        auto checked_array() const -> array* {
+            check_type(is_array(), "array");
+            return as_array();
+        }
+
+        static auto check_type(const bool matches, const char* type_name) -> void {
+            if (not matches) {
+                throw detail::json_type_error(std::string{"json value is not a "} + type_name);
+            }
+        }
+
+        template<typename A, typename T, typename... Args>
+        static auto construct_heap_object(Args&& ...args) -> T* {
+            using alloc_traits = std::allocator_traits<A>;
+            auto alloc = A{};
+            const auto ptr = alloc_traits::allocate(alloc, 1);
+            alloc_traits::construct(alloc, ptr, std::forward<Args>(args)...);
+            return ptr;
+        }
+
+        template<typename A, typename T>
+        static auto destroy_heap_object(T* value) noexcept -> void {
+            using alloc_traits = std::allocator_traits<A>;
+            auto alloc = A{};
+            alloc_traits::destroy(alloc, value);
+            alloc_traits::deallocate(alloc, value, 1);
+        }
+
+        std::uint64_t m_bits;
+    };
+}
+
+
+#endif
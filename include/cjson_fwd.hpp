@@ -2,6 +2,8 @@
 #define CJSON_FWD_HPP
 
 #include "cjson_basic.hpp"
+#include "cjson_compact.hpp"
+#include "detail/cjson_string_pool.hpp"
 
 namespace cjson {
     struct json_types {
@@ -17,6 +19,24 @@ namespace cjson {
     };
 
     using json = basic_json<json_types>;
+    using compact_json = basic_compact_json<json_types>;
+
+    struct interned_json_types: json_types {
+        using key_type = interned_string;
+
+        template <typename Key, typename Val, typename Alloc>
+        using object_type = std::map<Key, Val, std::less<>, Alloc>;
+    };
+
+    using interned_json = basic_json<interned_json_types>;
+
+    // a json that carries a revision, which costs it 8 bytes and a thread local increment per
+    // container made or value modified, so that fragment_cache can re-render only what changed
+    struct tracked_json_types: json_types {
+        static constexpr bool track_revisions = true;
+    };
+
+    using tracked_json = basic_json<tracked_json_types>;
 }
 
 
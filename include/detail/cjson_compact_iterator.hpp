@@ -0,0 +1,138 @@
+#ifndef CJSON_COMPACT_ITERATOR_HPP
+#define CJSON_COMPACT_ITERATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace cjson {
+    // the iterator of basic_compact_json, which has only generic objects and arrays, and whose
+    // elements are all compact values it can refer to
+    template <typename Compact_Json>
+    class compact_json_iter {
+        friend std::remove_const_t<Compact_Json>;
+
+        using object_iterator = std::conditional_t<std::is_const_v<Compact_Json>,
+            typename Compact_Json::object::const_iterator, typename Compact_Json::object::iterator>;
+        using array_iterator = std::conditional_t<std::is_const_v<Compact_Json>,
+            typename Compact_Json::array::const_iterator, typename Compact_Json::array::iterator>;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::remove_const_t<Compact_Json>;
+        using reference = Compact_Json&;
+        using pointer = Compact_Json*;
+        using difference_type = std::ptrdiff_t;
+
+        compact_json_iter() noexcept = default;
+
+        auto operator*() const -> reference {
+            switch (m_iter_value_t) {
+                case iter_kind::_OBJECT:
+                    return m_iter_value.m_object_iter->second;
+                case iter_kind::_ARRAY:
+                    return *m_iter_value.m_array_iter;
+                case iter_kind::_SCALAR:
+                default:
+                    return *m_iter_value.m_scalar_value;
+            }
+        }
+
+        auto operator->() const -> pointer {
+            return &**this;
+        }
+
+        auto operator++() -> compact_json_iter& {
+            switch (m_iter_value_t) {
+                case iter_kind::_OBJECT:
+                    ++m_iter_value.m_object_iter;
+                    break;
+                case iter_kind::_ARRAY:
+                    ++m_iter_value.m_array_iter;
+                    break;
+                case iter_kind::_SCALAR:
+                    ++m_iter_value.m_scalar_value;
+                    break;
+            }
+            return *this;
+        }
+
+        auto operator++(int) -> compact_json_iter {
+            auto self = *this;
+            ++(*this);
+            return self;
+        }
+
+        auto operator--() -> compact_json_iter& {
+            switch (m_iter_value_t) {
+                case iter_kind::_OBJECT:
+                    --m_iter_value.m_object_iter;
+                    break;
+                case iter_kind::_ARRAY:
+                    --m_iter_value.m_array_iter;
+                    break;
+                case iter_kind::_SCALAR:
+                    --m_iter_value.m_scalar_value;
+                    break;
+            }
+            return *this;
+        }
+
+        auto operator--(int) -> compact_json_iter {
+            auto self = *this;
+            --(*this);
+            return self;
+        }
+
+        auto operator==(const compact_json_iter& other) const -> bool {
+            if (m_iter_value_t != other.m_iter_value_t) {
+                return false;
+            }
+            switch (m_iter_value_t) {
+                case iter_kind::_OBJECT:
+                    return m_iter_value.m_object_iter == other.m_iter_value.m_object_iter;
+                case iter_kind::_ARRAY:
+                    return m_iter_value.m_array_iter == other.m_iter_value.m_array_iter;
+                case iter_kind::_SCALAR:
+                default:
+                    return m_iter_value.m_scalar_value == other.m_iter_value.m_scalar_value;
+            }
+        }
+
+    private:
+        enum class iter_kind: std::uint8_t {
+            _SCALAR,
+            _OBJECT,
+            _ARRAY
+        };
+
+        compact_json_iter(pointer scalar) noexcept
+            : m_iter_value{scalar}, m_iter_value_t{iter_kind::_SCALAR} {}
+        compact_json_iter(const object_iterator& object_iter) noexcept
+            : m_iter_value{object_iter}, m_iter_value_t{iter_kind::_OBJECT} {}
+        compact_json_iter(const array_iterator& array_iter) noexcept
+            : m_iter_value{array_iter}, m_iter_value_t{iter_kind::_ARRAY} {}
+
+        union iter_value {
+            pointer m_scalar_value;
+            object_iterator m_object_iter;
+            array_iterator m_array_iter;
+
+            iter_value() noexcept
+                : m_scalar_value{nullptr} {}
+            iter_value(pointer scalar) noexcept
+                : m_scalar_value{scalar} {}
+            iter_value(const object_iterator& object_iter) noexcept
+                : m_object_iter{object_iter} {}
+            iter_value(const array_iterator& array_iter) noexcept
+                : m_array_iter{array_iter} {}
+        };
+
+        iter_value m_iter_value;
+        iter_kind m_iter_value_t = iter_kind::_SCALAR;
+    };
+}
+
+
+#endif
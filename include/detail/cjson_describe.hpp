@@ -0,0 +1,162 @@
+#ifndef CJSON_DESCRIBE_HPP
+#define CJSON_DESCRIBE_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#define _KEY_HASH_SEEDS 256
+
+// lists the members of a struct that map to json object members of the same names, e.g.
+//     struct point { double x; double y; };
+//     CJSON_DESCRIBE(point, x, y)
+// it goes in the namespace of the struct, where the parser and serializer find it by adl
+#define CJSON_DESCRIBE(type, ...)                                                                   \
+    [[maybe_unused]] constexpr auto cjson_describe(const type*) noexcept {                          \
+        return std::tuple{_CJSON_FOR_EACH(_CJSON_FIELD, type, __VA_ARGS__)};                        \
+    }
+
+#define _CJSON_FIELD(type, member) ::cjson::detail::reflect::field{#member, &type::member}
+
+// applies macro(type, x) to every x of the arguments, joined by commas; __VA_OPT__ recursion,
+// rescanned by _CJSON_EXPAND for up to 256 arguments
+#define _CJSON_PARENS ()
+#define _CJSON_EXPAND(...) _CJSON_EXPAND4(_CJSON_EXPAND4(_CJSON_EXPAND4(_CJSON_EXPAND4(__VA_ARGS__))))
+#define _CJSON_EXPAND4(...) _CJSON_EXPAND3(_CJSON_EXPAND3(_CJSON_EXPAND3(_CJSON_EXPAND3(__VA_ARGS__))))
+#define _CJSON_EXPAND3(...) _CJSON_EXPAND2(_CJSON_EXPAND2(_CJSON_EXPAND2(_CJSON_EXPAND2(__VA_ARGS__))))
+#define _CJSON_EXPAND2(...) _CJSON_EXPAND1(_CJSON_EXPAND1(_CJSON_EXPAND1(_CJSON_EXPAND1(__VA_ARGS__))))
+#define _CJSON_EXPAND1(...) __VA_ARGS__
+#define _CJSON_FOR_EACH(macro, type, ...) __VA_OPT__(_CJSON_EXPAND(_CJSON_FOR_EACH_NEXT(macro, type, __VA_ARGS__)))
+#define _CJSON_FOR_EACH_NEXT(macro, type, first, ...)                                               \
+    macro(type, first) __VA_OPT__(, _CJSON_FOR_EACH_AGAIN _CJSON_PARENS (macro, type, __VA_ARGS__))
+#define _CJSON_FOR_EACH_AGAIN() _CJSON_FOR_EACH_NEXT
+
+namespace cjson::detail::reflect {
+    template <typename T, typename Member>
+    struct field {
+        using type = Member;
+
+        std::string_view name_;
+        Member T::* member_;
+    };
+
+    template <typename T>
+    concept described = requires (const T* value) {
+        cjson_describe(value);
+    };
+
+    template <described T>
+    constexpr auto fields_of() noexcept {
+        return cjson_describe(static_cast<const T*>(nullptr));
+    }
+
+    template <described T>
+    inline constexpr auto fields_v = fields_of<T>();
+
+    template <described T>
+    inline constexpr auto field_count = std::tuple_size_v<decltype(fields_of<T>())>;
+
+    // seeded fnv-1a, with the product folded down so that the top bits depend on every byte
+    constexpr auto hash_key(const std::string_view key, const std::uint64_t seed) noexcept -> std::uint64_t {
+        auto hash = 0xCBF29CE484222325ull ^ (seed * 0x9E3779B97F4A7C15ull);
+        for (const auto c : key) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+        }
+        return (hash ^ (hash >> 32)) * 0x9E3779B97F4A7C15ull;
+    }
+
+    // where names go in a key_index table: to the top bits of their hashes with seed
+    struct key_layout {
+        std::uint64_t seed_;
+        unsigned bits_;
+    };
+
+    template <described T>
+    constexpr auto field_names() noexcept -> std::array<std::string_view, field_count<T>> {
+        auto names = std::array<std::string_view, field_count<T>>{};
+        std::apply([&](const auto& ...fields) {
+            auto i = std::size_t{0};
+            ((names[i++] = fields.name_), ...);
+        }, fields_v<T>);
+        return names;
+    }
+
+    template <std::size_t N>
+    constexpr auto collides(const std::array<std::string_view, N>& names, const key_layout layout) -> bool {
+        auto used = std::vector<bool>(std::size_t{1} << layout.bits_);
+        for (const auto name : names) {
+            const auto slot = hash_key(name, layout.seed_) >> (64 - layout.bits_);
+            if (used[slot]) {
+                return true;
+            }
+            used[slot] = true;
+        }
+        return false;
+    }
+
+    // the smallest table, and the first seed for it, without collisions; bits_ is 0 if there is
+    // none, as with duplicate names
+    template <std::size_t N>
+    constexpr auto find_layout(const std::array<std::string_view, N>& names) -> key_layout {
+        for (auto bits = std::max(1u, static_cast<unsigned>(std::bit_width(N))); bits <= 16; ++bits) {
+            for (std::uint64_t seed = 0; seed < _KEY_HASH_SEEDS; ++seed) {
+                if (not collides(names, key_layout{seed, bits})) {
+                    return key_layout{seed, bits};
+                }
+            }
+        }
+        return key_layout{0, 0};
+    }
+
+    // a perfect hash of the member names of T, built at compile time: every name has a slot of
+    // its own, the top bits of its hash. the table doubles until some seed works
+    template <described T>
+    class key_index {
+    public:
+        static constexpr auto size = field_count<T>;
+
+        // the index of the field named key, or size if there is none
+        static constexpr auto find(const std::string_view key) noexcept -> std::size_t {
+            const auto slot = slots_[hash_key(key, layout_.seed_) >> (64 - layout_.bits_)];
+            return slot < size and names_[slot] == key ? slot : size;
+        }
+
+        static constexpr auto name(const std::size_t index) noexcept -> std::string_view {
+            return names_[index];
+        }
+
+    private:
+        static constexpr auto names_ = field_names<T>();
+        static constexpr auto layout_ = find_layout(names_);
+
+        static_assert(layout_.bits_ > 0, "described member names must be distinct");
+
+        static constexpr auto slots_ = [] {
+            auto slots = std::array<std::uint16_t, (std::size_t{1} << layout_.bits_)>{};
+            slots.fill(static_cast<std::uint16_t>(size));
+            for (std::size_t i = 0; i < size; ++i) {
+                slots[hash_key(names_[i], layout_.seed_) >> (64 - layout_.bits_)] = static_cast<std::uint16_t>(i);
+            }
+            return slots;
+        }();
+    };
+
+    // calls visit(field) with the index-th field of T, which selects among them at run time
+    template <described T, typename Visit>
+    constexpr auto visit_field(const std::size_t index, Visit&& visit) -> bool {
+        return [&]<std::size_t ...I>(std::index_sequence<I...>) {
+            auto result = false;
+            static_cast<void>(((index == I and (result = visit(std::get<I>(fields_v<T>)), true)) or ...));
+            return result;
+        }(std::make_index_sequence<field_count<T>>{});
+    }
+}
+
+
+#endif
@@ -1,12 +1,25 @@
 #ifndef CJSON_ERROR_HPP
 #define CJSON_ERROR_HPP
 
+#include <cstddef>
 #include <exception>
 #include <string>
+#include <utility>
 
 #include "input/cjson_position.hpp"
 
 namespace cjson::detail {
+    struct json_type_error: std::exception {
+        explicit json_type_error(std::string&& error_str) noexcept
+            : error_str_{std::move(error_str)} {}
+
+        auto what() const noexcept -> const char* override {
+            return error_str_.data();
+        }
+
+        std::string error_str_;
+    };
+
     namespace input {
         struct json_error_kind {
             virtual auto what() const noexcept -> std::string = 0;
@@ -17,6 +30,9 @@ namespace cjson::detail {
             explicit json_input_error(json_error_kind&& error_str) noexcept
                 : error_str_{error_str.what()} {}
 
+            json_input_error(std::string&& error_str, const position& pos) noexcept
+                : error_str_{std::move(error_str)}, pos_{pos} {}
+
             auto what() const noexcept -> const char* override {
                 return error_str_.data();
             }
@@ -107,6 +123,17 @@ namespace cjson::detail {
             bool has_sign_;
         };
 
+        struct number_out_of_range_error: json_error_kind {
+            number_out_of_range_error(const std::string& reason)
+                : reason_{reason} {}
+
+            auto what() const noexcept -> std::string override {
+                return std::string{"Number out of range: \""} + reason_ + "\"";
+            }
+
+            std::string reason_;
+        };
+
         struct invalid_array_error: json_error_kind {
             invalid_array_error(const std::string& reason)
                 : reason_{reason} {}
@@ -161,6 +188,162 @@ namespace cjson::detail {
 
             std::string reason_;
         };
+
+        struct type_mismatch_error: json_error_kind {
+            type_mismatch_error(const std::string& reason)
+                : reason_{reason} {}
+
+            auto what() const noexcept -> std::string override {
+                return std::string{"Unexpected json value for the target type: got \""} + reason_ + "\" instead";
+            }
+
+            std::string reason_;
+        };
+
+        struct trailing_content_error: json_error_kind {
+            trailing_content_error(const std::string& reason)
+                : reason_{reason} {}
+
+            auto what() const noexcept -> std::string override {
+                return std::string{"Expecting end of input after the json value: got \""} + reason_ + "\" instead";
+            }
+
+            std::string reason_;
+        };
+
+        struct truncated_input_error: json_error_kind {
+            truncated_input_error(std::size_t offset)
+                : offset_{offset} {}
+
+            auto what() const noexcept -> std::string override {
+                return std::string{"Unexpected end of input at byte "} + std::to_string(offset_);
+            }
+
+            std::size_t offset_;
+        };
+
+        struct invalid_type_byte_error: json_error_kind {
+            invalid_type_byte_error(unsigned char reason, std::size_t offset)
+                : reason_{reason}, offset_{offset} {}
+
+            auto what() const noexcept -> std::string override {
+                constexpr auto hex_digits = "0123456789abcdef";
+                return std::string{"Invalid type byte 0x"} + hex_digits[reason_ >> 4] + hex_digits[reason_ & 0xF]
+                    + " at byte " + std::to_string(offset_);
+            }
+
+            unsigned char reason_;
+            std::size_t offset_;
+        };
+
+        struct invalid_binary_key_error: json_error_kind {
+            invalid_binary_key_error(std::size_t offset)
+                : offset_{offset} {}
+
+            auto what() const noexcept -> std::string override {
+                return std::string{"Expecting a string for key at byte "} + std::to_string(offset_);
+            }
+
+            std::size_t offset_;
+        };
+
+        struct nesting_depth_error: json_error_kind {
+            nesting_depth_error(std::size_t offset)
+                : offset_{offset} {}
+
+            auto what() const noexcept -> std::string override {
+                return std::string{"Maximum nesting depth exceeded at byte "} + std::to_string(offset_);
+            }
+
+            std::size_t offset_;
+        };
+
+        struct invalid_snapshot_error: json_error_kind {
+            invalid_snapshot_error(const std::string& reason, std::size_t offset)
+                : reason_{reason}, offset_{offset} {}
+
+            auto what() const noexcept -> std::string override {
+                return std::string{"Invalid snapshot: "} + reason_ + " at byte " + std::to_string(offset_);
+            }
+
+            std::string reason_;
+            std::size_t offset_;
+        };
+
+        enum class error_code: unsigned short int {
+            NONE,
+            UNTERMINATED_STRING,
+            ILLEGAL_ESCAPE,
+            INVALID_UNICODE_ESCAPE,
+            INVALID_CHARACTER,
+            INVALID_MINUS,
+            INVALID_FRACTION,
+            INVALID_EXPONENT,
+            INVALID_EXPONENT_SIGN,
+            NUMBER_OUT_OF_RANGE,
+            INVALID_ARRAY,
+            INVALID_KEY,
+            INVALID_COLON,
+            INVALID_OBJECT,
+            INVALID_JSON_VALUE,
+            TRUNCATED_INPUT,
+            TYPE_MISMATCH,
+            TRAILING_CONTENT
+        };
+
+        // what the non-throwing parser reports instead of a json_input_error. the message is
+        // only formatted on request, and reads the same as the exception's
+        struct parse_error {
+            auto message() const -> std::string {
+                const auto reason = reason_.empty() ? char{} : reason_.front();
+                switch (code_) {
+                    case error_code::NONE:
+                        break;
+                    case error_code::UNTERMINATED_STRING:
+                        return unterminated_string_error(reason_).what();
+                    case error_code::ILLEGAL_ESCAPE:
+                        return illegal_escape_error(reason).what();
+                    case error_code::INVALID_UNICODE_ESCAPE:
+                        return invalid_unicode_escape_error(reason_).what();
+                    case error_code::INVALID_CHARACTER:
+                        return invalid_character_error(reason).what();
+                    case error_code::INVALID_MINUS:
+                        return invalid_minus_error(reason).what();
+                    case error_code::INVALID_FRACTION:
+                        return invalid_fraction_error(reason).what();
+                    case error_code::INVALID_EXPONENT:
+                        return invalid_exponent_error(reason, false).what();
+                    case error_code::INVALID_EXPONENT_SIGN:
+                        return invalid_exponent_error(reason, true).what();
+                    case error_code::NUMBER_OUT_OF_RANGE:
+                        return number_out_of_range_error(reason_).what();
+                    case error_code::INVALID_ARRAY:
+                        return invalid_array_error(reason_).what();
+                    case error_code::INVALID_KEY:
+                        return invalid_key_error(reason_).what();
+                    case error_code::INVALID_COLON:
+                        return invalid_colon_error(reason_).what();
+                    case error_code::INVALID_OBJECT:
+                        return invalid_object_error(reason_).what();
+                    case error_code::INVALID_JSON_VALUE:
+                        return invalid_json_value_error(reason_).what();
+                    case error_code::TRUNCATED_INPUT:
+                        return truncated_input_error(offset_).what();
+                    case error_code::TYPE_MISMATCH:
+                        return type_mismatch_error(reason_).what();
+                    case error_code::TRAILING_CONTENT:
+                        return trailing_content_error(reason_).what();
+                }
+                return {};
+            }
+
+            error_code code_ = error_code::NONE;
+            // byte offset of the token that failed, or of the end of a truncated input
+            std::size_t offset_ = 0;
+            position pos_;
+            // the offending character or spelling
+            std::string reason_;
+        };
     }
 }
 
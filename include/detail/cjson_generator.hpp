@@ -0,0 +1,136 @@
+#ifndef CJSON_GENERATOR_HPP
+#define CJSON_GENERATOR_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace cjson::detail {
+    // the values a coroutine co_yields, produced one at a time as they are asked for; a stand-in
+    // for c++23's std::generator. a value is referred to rather than copied, and stays valid
+    // until the generator is resumed. an exception thrown by the coroutine leaves through next()
+    template <typename T>
+    class generator {
+    public:
+        struct promise_type {
+            auto get_return_object() noexcept -> generator {
+                return generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            auto initial_suspend() const noexcept -> std::suspend_always {
+                return {};
+            }
+
+            auto final_suspend() const noexcept -> std::suspend_always {
+                return {};
+            }
+
+            auto yield_value(const T& value) noexcept -> std::suspend_always {
+                value_ = std::addressof(value);
+                return {};
+            }
+
+            auto return_void() const noexcept -> void {}
+
+            auto unhandled_exception() noexcept -> void {
+                exception_ = std::current_exception();
+            }
+
+            const T* value_ = nullptr;
+            std::exception_ptr exception_;
+        };
+
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            iterator() noexcept = default;
+            explicit iterator(generator& gen)
+                : gen_{&gen}, current_{gen.next()} {}
+
+            auto operator*() const noexcept -> reference {
+                return *current_;
+            }
+
+            auto operator->() const noexcept -> pointer {
+                return current_;
+            }
+
+            auto operator++() -> iterator& {
+                current_ = gen_->next();
+                return *this;
+            }
+
+            auto operator++(int) -> void {
+                ++*this;
+            }
+
+            friend auto operator==(const iterator& iter, std::default_sentinel_t) noexcept -> bool {
+                return iter.current_ == nullptr;
+            }
+
+        private:
+            generator* gen_ = nullptr;
+            const T* current_ = nullptr;
+        };
+
+        generator(const generator&) noexcept = delete;
+        generator(generator&& other) noexcept
+            : handle_{std::exchange(other.handle_, {})} {}
+
+        auto operator=(const generator&) noexcept -> generator& = delete;
+        auto operator=(generator&& other) noexcept -> generator& {
+            if (this != &other) {
+                if (handle_) {
+                    handle_.destroy();
+                }
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+
+        ~generator() noexcept {
+            if (handle_) {
+                handle_.destroy();
+            }
+        }
+
+        // runs the coroutine to its next value; nullptr once it has finished
+        auto next() -> const T* {
+            if (not handle_ or handle_.done()) {
+                return nullptr;
+            }
+            handle_.resume();
+            auto& promise = handle_.promise();
+            if (promise.exception_) {
+                std::rethrow_exception(std::exchange(promise.exception_, nullptr));
+            }
+            return handle_.done() ? nullptr : promise.value_;
+        }
+
+        // values are produced as the iterator advances, so begin() starts at the next one
+        auto begin() -> iterator {
+            return iterator{*this};
+        }
+
+        auto end() const noexcept -> std::default_sentinel_t {
+            return std::default_sentinel;
+        }
+
+    private:
+        explicit generator(const std::coroutine_handle<promise_type> handle) noexcept
+            : handle_{handle} {}
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+}
+
+
+#endif
@@ -2,13 +2,16 @@
 #define CJSON_ITERATOR_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 
 namespace cjson {
     enum class iter_value_t: std::uint8_t {
         _SCALAR,
         _OBJECT,
-        _ARRAY
+        _ARRAY,
+        // over the values of a shaped object in key order, which leaves the object shaped
+        _SHAPED_OBJECT
     };
 
     template <typename Basic_Json>
@@ -32,6 +35,7 @@ namespace cjson {
                 case iter_value_t::_OBJECT:
                     return m_iter_value.m_object_iter->second;
                 case iter_value_t::_ARRAY:
+                case iter_value_t::_SHAPED_OBJECT:
                     return *m_iter_value.m_array_iter;
                 case iter_value_t::_SCALAR:
                 default:
@@ -40,15 +44,7 @@ namespace cjson {
         }
 
         auto operator->() const -> pointer {
-            switch (m_iter_value_t) {
-                case iter_value_t::_OBJECT:
-                    return &(*m_iter_value.m_object_iter);
-                case iter_value_t::_ARRAY:
-                    return &(*m_iter_value.m_array_iter);
-                case iter_value_t::_SCALAR:
-                default:
-                    return m_iter_value.m_scalar_value;
-            }
+            return &**this;
         }
 
         auto operator++() -> json_iter& {
@@ -57,6 +53,7 @@ namespace cjson {
                     ++m_iter_value.m_object_iter;
                     break;
                 case iter_value_t::_ARRAY:
+                case iter_value_t::_SHAPED_OBJECT:
                     ++m_iter_value.m_array_iter;
                     break;
                 case iter_value_t::_SCALAR:
@@ -78,6 +75,7 @@ namespace cjson {
                     --m_iter_value.m_object_iter;
                     break;
                 case iter_value_t::_ARRAY:
+                case iter_value_t::_SHAPED_OBJECT:
                     --m_iter_value.m_array_iter;
                     break;
                 case iter_value_t::_SCALAR:
@@ -104,6 +102,7 @@ namespace cjson {
                 case iter_value_t::_OBJECT:
                     return m_iter_value.m_object_iter == other.m_iter_value.m_object_iter;
                 case iter_value_t::_ARRAY:
+                case iter_value_t::_SHAPED_OBJECT:
                     return m_iter_value.m_array_iter == other.m_iter_value.m_array_iter;
                 default:
                     return false;
@@ -118,6 +117,10 @@ namespace cjson {
         json_iter(const typename value_type::array::iterator& array_iter) noexcept
             : m_iter_value{array_iter}, m_iter_value_t{iter_value_t::_ARRAY} {}
 
+        // over the values of a shaped object, which are in key order
+        json_iter(const typename value_type::array::iterator& values_iter, iter_value_t) noexcept
+            : m_iter_value{values_iter}, m_iter_value_t{iter_value_t::_SHAPED_OBJECT} {}
+
         union iter_value {
             pointer m_scalar_value;
             typename value_type::object::iterator m_object_iter;
@@ -0,0 +1,115 @@
+#ifndef CJSON_NUMBER_VIEW_HPP
+#define CJSON_NUMBER_VIEW_HPP
+
+#include <cstddef>
+#include <iterator>
+
+#include "cjson_reference.hpp"
+
+namespace cjson::detail {
+    // the elements of a number array, read and written in place as json_refs. the generic
+    // element access and iterators of a json hand out json&, which a number array has none of,
+    // so they promote a non-const number array, and a const one makes json values of its
+    // numbers once; this is how to reach the elements with nothing but the numbers
+    template <typename Json>
+    class json_number_view {
+    public:
+        using value_type = typename json_ref<Json>::value_type;
+        using reference = json_ref<Json>;
+        using size_type = std::size_t;
+
+        class iterator {
+        public:
+            // the elements are handed out by value, so this is only an input iterator to
+            // algorithms that take a reference to be a json&
+            using iterator_concept = std::bidirectional_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type = json_number_view::value_type;
+            using reference = json_number_view::reference;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() noexcept = default;
+
+            auto operator*() const noexcept -> reference {
+                return reference{owner_, index_};
+            }
+
+            auto operator++() noexcept -> iterator& {
+                ++index_;
+                return *this;
+            }
+
+            auto operator++(int) noexcept -> iterator {
+                auto self = *this;
+                ++(*this);
+                return self;
+            }
+
+            auto operator--() noexcept -> iterator& {
+                --index_;
+                return *this;
+            }
+
+            auto operator--(int) noexcept -> iterator {
+                auto self = *this;
+                --(*this);
+                return self;
+            }
+
+            auto operator==(const iterator& other) const noexcept -> bool {
+                return owner_ == other.owner_ and index_ == other.index_;
+            }
+
+        private:
+            friend json_number_view;
+
+            iterator(Json* owner, const size_type index) noexcept
+                : owner_{owner}, index_{index} {}
+
+            Json* owner_ = nullptr;
+            size_type index_ = 0;
+        };
+
+        explicit json_number_view(Json& owner) noexcept
+            : owner_{&owner} {}
+
+        auto begin() const noexcept -> iterator {
+            return iterator{owner_, 0};
+        }
+
+        auto end() const noexcept -> iterator {
+            return iterator{owner_, size()};
+        }
+
+        auto size() const noexcept -> size_type {
+            return owner_->size();
+        }
+
+        auto empty() const noexcept -> bool {
+            return size() == 0;
+        }
+
+        auto operator[](const size_type n) const noexcept -> reference {
+            return reference{owner_, n};
+        }
+
+        auto at(const size_type n) const -> reference {
+            owner_->check_index(n);
+            return reference{owner_, n};
+        }
+
+        auto front() const noexcept -> reference {
+            return reference{owner_, 0};
+        }
+
+        auto back() const noexcept -> reference {
+            return reference{owner_, size() - 1};
+        }
+
+    private:
+        Json* owner_;
+    };
+}
+
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef CJSON_NUMBERS_HPP
+#define CJSON_NUMBERS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace cjson::detail {
+    // the storage of a number array: the numbers, and the json values made of them the first
+    // time a const json hands out references to its elements. the values are made once, by
+    // whichever thread asks first, and are kept in step with the numbers from then on: a number
+    // written in place is written to both, and anything that resizes the numbers drops them
+    template <typename Numbers, typename Array, typename Alloc>
+    class json_numbers {
+    public:
+        explicit json_numbers(const Numbers& numbers)
+            : numbers_{numbers} {}
+
+        explicit json_numbers(Numbers&& numbers) noexcept
+            : numbers_{std::move(numbers)} {}
+
+        json_numbers(const json_numbers&) = delete;
+
+        auto operator=(const json_numbers&) -> json_numbers& = delete;
+
+        ~json_numbers() noexcept {
+            drop_values();
+        }
+
+        auto numbers() noexcept -> Numbers& {
+            return numbers_;
+        }
+
+        auto numbers() const noexcept -> const Numbers& {
+            return numbers_;
+        }
+
+        // non-const because the const iterators of a json are made from array::iterator
+        auto values() const -> Array& {
+            auto values = values_.load(std::memory_order_acquire);
+            if (values == nullptr) {
+                const auto made = make_values();
+                if (values_.compare_exchange_strong(values, made, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    values = made;
+                } else {
+                    destroy_values(made);
+                }
+            }
+            return *values;
+        }
+
+        auto assign(const std::size_t n, const typename Numbers::value_type number) -> void {
+            numbers_[n] = number;
+            if (const auto values = values_.load(std::memory_order_relaxed)) {
+                (*values)[n] = typename Array::value_type{number};
+            }
+        }
+
+        // the values made so far, for the json to keep when it promotes the array; nullptr if
+        // none were made
+        auto release_values() noexcept -> Array* {
+            return values_.exchange(nullptr, std::memory_order_relaxed);
+        }
+
+        auto drop_values() noexcept -> void {
+            if (const auto values = release_values()) {
+                destroy_values(values);
+            }
+        }
+
+    private:
+        auto make_values() const -> Array* {
+            using alloc_traits = std::allocator_traits<Alloc>;
+            auto alloc = Alloc{};
+            const auto ptr = alloc_traits::allocate(alloc, 1);
+            alloc_traits::construct(alloc, ptr, numbers_.begin(), numbers_.end());
+            return ptr;
+        }
+
+        static auto destroy_values(Array* values) noexcept -> void {
+            using alloc_traits = std::allocator_traits<Alloc>;
+            auto alloc = Alloc{};
+            alloc_traits::destroy(alloc, values);
+            alloc_traits::deallocate(alloc, values, 1);
+        }
+
+        Numbers numbers_;
+        mutable std::atomic<Array*> values_{nullptr};
+    };
+}
+
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef CJSON_OBJECT_VIEW_HPP
+#define CJSON_OBJECT_VIEW_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace cjson::detail {
+    // the members of a json object with their keys, in key order, read in place whether the
+    // object is generic or shaped. a shaped object has no generic object behind it to refer to,
+    // so this is how to read the members of any object through a const json
+    template <typename Json>
+    class json_object_view {
+        using object = typename Json::object;
+        using shaped_object = typename Json::shaped_object;
+
+    public:
+        using key_type = typename object::key_type;
+        using mapped_type = Json;
+        using value_type = std::pair<const key_type&, const Json&>;
+        using size_type = std::size_t;
+
+        class iterator {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = json_object_view::value_type;
+            using reference = value_type;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() noexcept = default;
+
+            auto operator*() const -> reference {
+                if (shaped_ != nullptr) {
+                    return reference{shaped_->shape_->key(index_), shaped_->values_[index_]};
+                }
+                return reference{member_->first, member_->second};
+            }
+
+            auto operator++() -> iterator& {
+                (shaped_ != nullptr) ? static_cast<void>(++index_) : static_cast<void>(++member_);
+                return *this;
+            }
+
+            auto operator++(int) -> iterator {
+                auto self = *this;
+                ++(*this);
+                return self;
+            }
+
+            auto operator--() -> iterator& {
+                (shaped_ != nullptr) ? static_cast<void>(--index_) : static_cast<void>(--member_);
+                return *this;
+            }
+
+            auto operator--(int) -> iterator {
+                auto self = *this;
+                --(*this);
+                return self;
+            }
+
+            auto operator==(const iterator& other) const -> bool {
+                return (shaped_ != nullptr) ? index_ == other.index_ : member_ == other.member_;
+            }
+
+        private:
+            friend json_object_view;
+
+            iterator(const typename object::const_iterator member) noexcept
+                : member_{member} {}
+            iterator(const shaped_object* shaped, const size_type index) noexcept
+                : shaped_{shaped}, index_{index} {}
+
+            typename object::const_iterator member_ = {};
+            const shaped_object* shaped_ = nullptr;
+            size_type index_ = 0;
+        };
+
+        explicit json_object_view(const object& o) noexcept
+            : object_{&o} {}
+
+        explicit json_object_view(const shaped_object& o) noexcept
+            : shaped_{&o} {}
+
+        auto begin() const noexcept -> iterator {
+            return (shaped_ != nullptr) ? iterator{shaped_, 0} : iterator{object_->begin()};
+        }
+
+        auto end() const noexcept -> iterator {
+            return (shaped_ != nullptr) ? iterator{shaped_, shaped_->values_.size()} : iterator{object_->end()};
+        }
+
+        auto size() const noexcept -> size_type {
+            return (shaped_ != nullptr) ? shaped_->values_.size() : object_->size();
+        }
+
+        auto empty() const noexcept -> bool {
+            return size() == 0;
+        }
+
+        template <typename Key>
+        auto find(const Key& key) const -> iterator {
+            if (shaped_ != nullptr) {
+                const auto index = shaped_->shape_->find(key);
+                return iterator{shaped_, index.value_or(shaped_->values_.size())};
+            }
+            return iterator{object_->find(key)};
+        }
+
+        template <typename Key>
+        auto contains(const Key& key) const -> bool {
+            return find(key) != end();
+        }
+
+        template <typename Key>
+        auto count(const Key& key) const -> size_type {
+            return contains(key) ? 1 : 0;
+        }
+
+        template <typename Key>
+        auto at(const Key& key) const -> const Json& {
+            const auto iter = find(key);
+            if (iter == end()) {
+                throw std::out_of_range("key not found in json object");
+            }
+            return (*iter).second;
+        }
+
+    private:
+        const object* object_ = nullptr;
+        const shaped_object* shaped_ = nullptr;
+    };
+}
+
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef CJSON_REFERENCE_HPP
+#define CJSON_REFERENCE_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+namespace cjson {
+    namespace detail {
+        template <typename Json>
+        class json_number_view;
+    }
+
+    // an element of a number array, which holds plain numbers and so has no json to refer to.
+    // the element is read and written through the array each time, so like an element of a
+    // std::vector it stays valid until the array is resized, even after assigning a non-number
+    // through it has promoted the array to its generic form
+    template <typename Basic_Json>
+    class json_ref {
+        using json = std::remove_const_t<Basic_Json>;
+
+        friend json;
+
+        template <typename>
+        friend class detail::json_number_view;
+
+    public:
+        using value_type = json;
+
+        json_ref(const json_ref&) noexcept = default;
+
+        auto operator=(const json_ref& other) -> json_ref&
+            requires (not std::is_const_v<Basic_Json>) {
+            return *this = other.get();
+        }
+
+        // a number is written in place, anything else promotes the array first
+        auto operator=(const json& js) -> json_ref&
+            requires (not std::is_const_v<Basic_Json>) {
+            m_owner->assign_element(m_index, js);
+            return *this;
+        }
+
+        auto operator=(json&& js) -> json_ref&
+            requires (not std::is_const_v<Basic_Json>) {
+            m_owner->assign_element(m_index, std::move(js));
+            return *this;
+        }
+
+        ~json_ref() noexcept = default;
+
+        auto get() const -> json {
+            return m_owner->element(m_index);
+        }
+
+        operator json() const {
+            return get();
+        }
+
+        // reads the number without making a json of it; throws json_type_error if a non-number
+        // has been assigned to the element since
+        explicit operator typename json::number() const {
+            return m_owner->number_element(m_index);
+        }
+
+    private:
+        json_ref(Basic_Json* owner, const std::size_t index) noexcept
+            : m_owner{owner}, m_index{index} {}
+
+        Basic_Json* m_owner;
+        std::size_t m_index;
+    };
+}
+
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef CJSON_REVISION_HPP
+#define CJSON_REVISION_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace cjson::detail {
+    inline constexpr auto revision_block = std::uint64_t{4096};
+
+    // a revision that no value has had before. each thread takes a block of revisions at a
+    // time, so handing one out is a thread local increment. revisions are 64 bits wide, so they
+    // do not wrap in practice
+    inline auto next_revision() noexcept -> std::uint64_t {
+        static constinit auto issued = std::atomic<std::uint64_t>{0};
+        thread_local auto next = std::uint64_t{0};
+        thread_local auto last = std::uint64_t{0};
+        if (next == last) {
+            next = issued.fetch_add(revision_block, std::memory_order_relaxed);
+            last = next + revision_block;
+        }
+        return ++next;
+    }
+
+    // the revision a json carries when its types ask for it with track_revisions, see
+    // basic_json::revision. a json whose types do not carries the empty specialization, which
+    // takes no space and does nothing
+    template <bool Tracked>
+    class json_revision {
+    public:
+        constexpr json_revision() noexcept = default;
+
+        static auto fresh() noexcept -> json_revision {
+            return json_revision{next_revision()};
+        }
+
+        auto revise() noexcept -> void {
+            value_ = next_revision();
+        }
+
+        auto value() const noexcept -> std::uint64_t {
+            return value_;
+        }
+
+    private:
+        explicit json_revision(const std::uint64_t value) noexcept
+            : value_{value} {}
+
+        std::uint64_t value_ = 0;
+    };
+
+    template <>
+    class json_revision<false> {
+    public:
+        constexpr json_revision() noexcept = default;
+
+        static auto fresh() noexcept -> json_revision {
+            return {};
+        }
+
+        auto revise() noexcept -> void {}
+    };
+}
+
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef CJSON_SHAPE_HPP
+#define CJSON_SHAPE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <vector>
+
+namespace cjson::detail {
+    template <typename String, typename Compare>
+    class json_shape {
+    public:
+        using key_type = String;
+        using size_type = std::size_t;
+
+        // keys are given in the order they were parsed in; returns nullptr if
+        // the key sequence contains duplicates
+        static auto make(const std::vector<key_type>& parsed_keys) -> std::shared_ptr<const json_shape> {
+            auto order = std::vector<size_type>(parsed_keys.size());
+            std::iota(order.begin(), order.end(), size_type{0});
+            std::sort(order.begin(), order.end(), [&](const size_type i, const size_type j) {
+                return Compare{}(parsed_keys[i], parsed_keys[j]);
+            });
+
+            auto shape = std::make_shared<json_shape>();
+            shape->keys_.reserve(parsed_keys.size());
+            shape->order_.resize(parsed_keys.size());
+            for (size_type sorted = 0; sorted < order.size(); ++sorted) {
+                if (sorted > 0 and not Compare{}(shape->keys_.back(), parsed_keys[order[sorted]])) {
+                    return nullptr;
+                }
+                shape->order_[order[sorted]] = sorted;
+                shape->keys_.push_back(parsed_keys[order[sorted]]);
+            }
+            return shape;
+        }
+
+        auto size() const noexcept -> size_type {
+            return keys_.size();
+        }
+
+        auto key(const size_type sorted_index) const noexcept -> const key_type& {
+            return keys_[sorted_index];
+        }
+
+        auto parsed_key(const size_type parsed_index) const noexcept -> const key_type& {
+            return keys_[order_[parsed_index]];
+        }
+
+        auto sorted_index(const size_type parsed_index) const noexcept -> size_type {
+            return order_[parsed_index];
+        }
+
+        template <typename Key>
+        auto find(const Key& key) const noexcept -> std::optional<size_type> {
+            const auto iter = std::lower_bound(keys_.begin(), keys_.end(), key, Compare{});
+            if (iter == keys_.end() or Compare{}(key, *iter)) {
+                return std::nullopt;
+            }
+            return static_cast<size_type>(iter - keys_.begin());
+        }
+
+    private:
+        std::vector<key_type> keys_;
+        std::vector<size_type> order_;
+    };
+
+    template <typename Shape, typename Array>
+    struct json_shaped_object {
+        std::shared_ptr<const Shape> shape_;
+        Array values_;
+    };
+}
+
+
+#endif
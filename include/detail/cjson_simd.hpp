@@ -0,0 +1,271 @@
+#ifndef CJSON_SIMD_HPP
+#define CJSON_SIMD_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <type_traits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace cjson::detail::simd {
+    template <typename T>
+    auto sum(const T* first, const std::size_t n) noexcept -> T {
+        auto i = std::size_t{0};
+        auto acc = T{};
+        if constexpr (std::is_same_v<T, double>) {
+#if defined(__AVX__)
+            auto acc0 = _mm256_setzero_pd();
+            auto acc1 = _mm256_setzero_pd();
+            for (; i + 8 <= n; i += 8) {
+                acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(first + i));
+                acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(first + i + 4));
+            }
+            double lanes[4];
+            _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+            acc = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(__SSE2__)
+            auto acc0 = _mm_setzero_pd();
+            auto acc1 = _mm_setzero_pd();
+            for (; i + 4 <= n; i += 4) {
+                acc0 = _mm_add_pd(acc0, _mm_loadu_pd(first + i));
+                acc1 = _mm_add_pd(acc1, _mm_loadu_pd(first + i + 2));
+            }
+            double lanes[2];
+            _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+            acc = lanes[0] + lanes[1];
+#endif
+        }
+        return std::accumulate(first + i, first + n, acc);
+    }
+
+    template <typename T>
+    auto min(const T* first, const std::size_t n) noexcept -> T {
+        auto i = std::size_t{0};
+        auto acc = first[0];
+        if constexpr (std::is_same_v<T, double>) {
+#if defined(__AVX__)
+            if (n >= 4) {
+                auto lo = _mm256_loadu_pd(first);
+                for (i = 4; i + 4 <= n; i += 4) {
+                    lo = _mm256_min_pd(lo, _mm256_loadu_pd(first + i));
+                }
+                double lanes[4];
+                _mm256_storeu_pd(lanes, lo);
+                acc = std::min({lanes[0], lanes[1], lanes[2], lanes[3]});
+            }
+#elif defined(__SSE2__)
+            if (n >= 2) {
+                auto lo = _mm_loadu_pd(first);
+                for (i = 2; i + 2 <= n; i += 2) {
+                    lo = _mm_min_pd(lo, _mm_loadu_pd(first + i));
+                }
+                double lanes[2];
+                _mm_storeu_pd(lanes, lo);
+                acc = std::min(lanes[0], lanes[1]);
+            }
+#endif
+        }
+        for (; i < n; ++i) {
+            acc = std::min(acc, first[i]);
+        }
+        return acc;
+    }
+
+    template <typename T>
+    auto max(const T* first, const std::size_t n) noexcept -> T {
+        auto i = std::size_t{0};
+        auto acc = first[0];
+        if constexpr (std::is_same_v<T, double>) {
+#if defined(__AVX__)
+            if (n >= 4) {
+                auto hi = _mm256_loadu_pd(first);
+                for (i = 4; i + 4 <= n; i += 4) {
+                    hi = _mm256_max_pd(hi, _mm256_loadu_pd(first + i));
+                }
+                double lanes[4];
+                _mm256_storeu_pd(lanes, hi);
+                acc = std::max({lanes[0], lanes[1], lanes[2], lanes[3]});
+            }
+#elif defined(__SSE2__)
+            if (n >= 2) {
+                auto hi = _mm_loadu_pd(first);
+                for (i = 2; i + 2 <= n; i += 2) {
+                    hi = _mm_max_pd(hi, _mm_loadu_pd(first + i));
+                }
+                double lanes[2];
+                _mm_storeu_pd(lanes, hi);
+                acc = std::max(lanes[0], lanes[1]);
+            }
+#endif
+        }
+        for (; i < n; ++i) {
+            acc = std::max(acc, first[i]);
+        }
+        return acc;
+    }
+
+    // returns the index of the first byte that needs escaping inside a json string: a quote,
+    // a backslash, a control character or, if ascii_only is set, any byte outside ascii
+    inline auto find_escape(const char* first, const std::size_t n, const bool ascii_only) noexcept -> std::size_t {
+        auto i = std::size_t{0};
+#if defined(__AVX2__)
+        const auto quote = _mm256_set1_epi8('"');
+        const auto backslash = _mm256_set1_epi8('\\');
+        const auto control = _mm256_set1_epi8(0x1F);
+        for (; i + 32 <= n; i += 32) {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+            auto special = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash));
+            special = _mm256_or_si256(special, _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control));
+            if (ascii_only) {
+                special = _mm256_or_si256(special, chunk);
+            }
+            const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(special));
+            if (mask != 0) {
+                return i + static_cast<std::size_t>(__builtin_ctz(mask));
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        const auto quote_16 = _mm_set1_epi8('"');
+        const auto backslash_16 = _mm_set1_epi8('\\');
+        const auto control_16 = _mm_set1_epi8(0x1F);
+        for (; i + 16 <= n; i += 16) {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+            auto special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote_16), _mm_cmpeq_epi8(chunk, backslash_16));
+            special = _mm_or_si128(special, _mm_cmpeq_epi8(_mm_max_epu8(chunk, control_16), control_16));
+            if (ascii_only) {
+                special = _mm_or_si128(special, chunk);
+            }
+            const auto mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+            if (mask != 0) {
+                return i + static_cast<std::size_t>(__builtin_ctz(mask));
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            const auto c = static_cast<unsigned char>(first[i]);
+            if (c < 0x20 or c == '"' or c == '\\' or (ascii_only and c >= 0x80)) {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    // returns the index of the first '\n', or n if there is none
+    inline auto find_newline(const char* first, const std::size_t n) noexcept -> std::size_t {
+        auto i = std::size_t{0};
+#if defined(__AVX2__)
+        const auto newline = _mm256_set1_epi8('\n');
+        for (; i + 32 <= n; i += 32) {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+            const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline)));
+            if (mask != 0) {
+                return i + static_cast<std::size_t>(__builtin_ctz(mask));
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        const auto newline_16 = _mm_set1_epi8('\n');
+        for (; i + 16 <= n; i += 16) {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+            const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline_16)));
+            if (mask != 0) {
+                return i + static_cast<std::size_t>(__builtin_ctz(mask));
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            if (first[i] == '\n') {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    // returns the index of the first quote or bracket, i.e. the bytes that change the nesting of
+    // a json text, or, if commas is set, the first of those or a comma; n if there is none
+    inline auto find_structural(const char* first, const std::size_t n, const bool commas) noexcept -> std::size_t {
+        auto i = std::size_t{0};
+#if defined(__AVX2__)
+        const auto quote = _mm256_set1_epi8('"');
+        const auto left_bracket = _mm256_set1_epi8('[');
+        const auto right_bracket = _mm256_set1_epi8(']');
+        const auto left_brace = _mm256_set1_epi8('{');
+        const auto right_brace = _mm256_set1_epi8('}');
+        const auto comma = _mm256_set1_epi8(commas ? ',' : '"');
+        for (; i + 32 <= n; i += 32) {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+            auto special = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, left_bracket));
+            special = _mm256_or_si256(special, _mm256_cmpeq_epi8(chunk, right_bracket));
+            special = _mm256_or_si256(special, _mm256_cmpeq_epi8(chunk, left_brace));
+            special = _mm256_or_si256(special, _mm256_cmpeq_epi8(chunk, right_brace));
+            special = _mm256_or_si256(special, _mm256_cmpeq_epi8(chunk, comma));
+            const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(special));
+            if (mask != 0) {
+                return i + static_cast<std::size_t>(__builtin_ctz(mask));
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        const auto quote_16 = _mm_set1_epi8('"');
+        const auto left_bracket_16 = _mm_set1_epi8('[');
+        const auto right_bracket_16 = _mm_set1_epi8(']');
+        const auto left_brace_16 = _mm_set1_epi8('{');
+        const auto right_brace_16 = _mm_set1_epi8('}');
+        const auto comma_16 = _mm_set1_epi8(commas ? ',' : '"');
+        for (; i + 16 <= n; i += 16) {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+            auto special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote_16), _mm_cmpeq_epi8(chunk, left_bracket_16));
+            special = _mm_or_si128(special, _mm_cmpeq_epi8(chunk, right_bracket_16));
+            special = _mm_or_si128(special, _mm_cmpeq_epi8(chunk, left_brace_16));
+            special = _mm_or_si128(special, _mm_cmpeq_epi8(chunk, right_brace_16));
+            special = _mm_or_si128(special, _mm_cmpeq_epi8(chunk, comma_16));
+            const auto mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+            if (mask != 0) {
+                return i + static_cast<std::size_t>(__builtin_ctz(mask));
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            const auto c = first[i];
+            if (c == '"' or c == '[' or c == ']' or c == '{' or c == '}' or (commas and c == ',')) {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    // returns how many bytes equal c
+    inline auto count(const char* first, const std::size_t n, const char c) noexcept -> std::size_t {
+        auto i = std::size_t{0};
+        auto total = std::size_t{0};
+#if defined(__AVX2__)
+        const auto needle = _mm256_set1_epi8(c);
+        for (; i + 32 <= n; i += 32) {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+            const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+            total += static_cast<std::size_t>(__builtin_popcount(mask));
+        }
+#endif
+#if defined(__SSE2__)
+        const auto needle_16 = _mm_set1_epi8(c);
+        for (; i + 16 <= n; i += 16) {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i));
+            const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle_16)));
+            total += static_cast<std::size_t>(__builtin_popcount(mask));
+        }
+#endif
+        for (; i < n; ++i) {
+            total += first[i] == c;
+        }
+        return total;
+    }
+}
+
+
+#endif
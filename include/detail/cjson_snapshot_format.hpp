@@ -0,0 +1,69 @@
+#ifndef CJSON_SNAPSHOT_FORMAT_HPP
+#define CJSON_SNAPSHOT_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#define _SNAPSHOT_MAGIC "CJSNAP\0\1"
+#define _SNAPSHOT_MAGIC_SIZE 8
+#define _SNAPSHOT_ENDIAN_MARK 0x01020304u
+#define _SNAPSHOT_ALIGNMENT 8
+
+// layout of a snapshot, all integers in native byte order and all offsets relative to the
+// start of the snapshot:
+//
+//   header      magic, endian mark, total size, offset of the key dictionary and the
+//               root slot
+//   dictionary  u64 count, then count (u64 offset, u64 size) pairs pointing at the key
+//               bytes, sorted bytewise
+//   blocks      every block starts with a u64 element count and is 8-byte aligned:
+//               strings hold their bytes, arrays and objects hold slots, number arrays
+//               hold doubles
+//
+// object slots carry the dictionary index of their key and are sorted by it, so a lookup
+// is a binary search in the dictionary followed by one over the members
+namespace cjson::detail::snapshot {
+    enum class slot_type: std::uint8_t {
+        _NULL,
+        _NUMBER,
+        _BOOLEAN,
+        _STRING,
+        _OBJECT,
+        _ARRAY,
+        _NUMBER_ARRAY,
+    };
+
+    // numbers and booleans are stored inline in the payload, everything else as the offset
+    // of its block
+    struct slot {
+        slot_type type;
+        std::uint8_t reserved[3];
+        std::uint32_t key;
+        std::uint64_t payload;
+    };
+
+    struct header {
+        char magic[_SNAPSHOT_MAGIC_SIZE];
+        std::uint32_t endian_mark;
+        std::uint32_t reserved;
+        std::uint64_t size;
+        std::uint64_t dictionary;
+        slot root;
+    };
+
+    struct dictionary_entry {
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    static_assert(sizeof(slot) == 16);
+    static_assert(sizeof(header) == 48);
+    static_assert(sizeof(dictionary_entry) == 16);
+
+    constexpr auto align(const std::size_t offset) noexcept -> std::size_t {
+        return (offset + _SNAPSHOT_ALIGNMENT - 1) & ~std::size_t{_SNAPSHOT_ALIGNMENT - 1};
+    }
+}
+
+
+#endif
@@ -0,0 +1,286 @@
+#ifndef CJSON_STRING_POOL_HPP
+#define CJSON_STRING_POOL_HPP
+
+#include <array>
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+#define _STRING_POOL_SHARDS 16
+
+namespace cjson {
+    namespace detail {
+        class string_pool;
+
+        // a string in a pool, with the number of handles to it. the empty string is a single
+        // sentinel that belongs to no pool and is not counted
+        struct pooled_string {
+            std::string str_;
+            string_pool* pool_ = nullptr;
+            mutable std::atomic<std::size_t> refs_ = 1;
+        };
+
+        // a thread-safe set of immutable strings, each kept while a handle refers to it. the set
+        // is split into shards by hash, and a string that is already there is found under a
+        // shared lock, so threads interning keys at the same time do not wait on each other
+        class string_pool {
+        public:
+            // makes interned_string intern into pool on this thread until the scope ends. such
+            // handles must not outlive the pool
+            class scope {
+            public:
+                explicit scope(string_pool& pool) noexcept
+                    : previous_{active_} {
+                    active_ = &pool;
+                }
+
+                scope(const scope&) noexcept = delete;
+                scope(scope&&) noexcept = delete;
+
+                auto operator=(const scope&) noexcept -> scope& = delete;
+                auto operator=(scope&&) noexcept -> scope& = delete;
+
+                ~scope() noexcept {
+                    active_ = previous_;
+                }
+
+            private:
+                string_pool* previous_;
+            };
+
+            string_pool() noexcept = default;
+            string_pool(const string_pool&) noexcept = delete;
+            string_pool(string_pool&&) noexcept = delete;
+
+            auto operator=(const string_pool&) noexcept -> string_pool& = delete;
+            auto operator=(string_pool&&) noexcept -> string_pool& = delete;
+
+            ~string_pool() noexcept = default;
+
+            static auto global() -> string_pool& {
+                static auto pool = string_pool{};
+                return pool;
+            }
+
+            // the pool of the innermost scope on this thread, or the global one
+            static auto current() -> string_pool& {
+                return active_ != nullptr ? *active_ : global();
+            }
+
+            static auto empty() noexcept -> const pooled_string* {
+                return &empty_;
+            }
+
+            // returns the pooled copy of str with a reference taken for the caller
+            auto intern(const std::string_view str) -> const pooled_string* {
+                if (str.empty()) {
+                    return empty();
+                }
+                auto& shard = shards_[string_hash{}(str) % _STRING_POOL_SHARDS];
+                {
+                    const auto lock = std::shared_lock{shard.mutex_};
+                    if (const auto iter = shard.strings_.find(str); iter != shard.strings_.end()) {
+                        iter->refs_.fetch_add(1, std::memory_order_relaxed);
+                        return &*iter;
+                    }
+                }
+                const auto lock = std::unique_lock{shard.mutex_};
+                const auto [iter, inserted] = shard.strings_.emplace(std::string{str}, this);
+                if (inserted) {
+                    shard.bytes_ += str.size();
+                } else {
+                    iter->refs_.fetch_add(1, std::memory_order_relaxed);
+                }
+                return &*iter;
+            }
+
+            static auto retain(const pooled_string* str) noexcept -> void {
+                if (str->pool_ != nullptr) {
+                    str->refs_.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            // drops a reference, and the string with the last one. the last reference is only
+            // dropped under the shard's lock, so that it cannot race with interning the string
+            static auto release(const pooled_string* str) noexcept -> void {
+                if (str->pool_ == nullptr) {
+                    return;
+                }
+                auto refs = str->refs_.load(std::memory_order_relaxed);
+                while (refs > 1) {
+                    if (str->refs_.compare_exchange_weak(refs, refs - 1, std::memory_order_acq_rel)) {
+                        return;
+                    }
+                }
+                str->pool_->erase(str);
+            }
+
+            auto size() const -> std::size_t {
+                auto size = std::size_t{0};
+                for (const auto& shard : shards_) {
+                    const auto lock = std::shared_lock{shard.mutex_};
+                    size += shard.strings_.size();
+                }
+                return size;
+            }
+
+            auto bytes() const -> std::size_t {
+                auto bytes = std::size_t{0};
+                for (const auto& shard : shards_) {
+                    const auto lock = std::shared_lock{shard.mutex_};
+                    bytes += shard.bytes_;
+                }
+                return bytes;
+            }
+
+        private:
+            struct string_hash {
+                using is_transparent = void;
+
+                auto operator()(const std::string_view str) const noexcept -> std::size_t {
+                    return std::hash<std::string_view>{}(str);
+                }
+
+                auto operator()(const pooled_string& str) const noexcept -> std::size_t {
+                    return (*this)(str.str_);
+                }
+            };
+
+            struct string_equal {
+                using is_transparent = void;
+
+                auto operator()(const pooled_string& s1, const pooled_string& s2) const noexcept -> bool {
+                    return s1.str_ == s2.str_;
+                }
+
+                auto operator()(const std::string_view s1, const pooled_string& s2) const noexcept -> bool {
+                    return s1 == s2.str_;
+                }
+
+                auto operator()(const pooled_string& s1, const std::string_view s2) const noexcept -> bool {
+                    return s1.str_ == s2;
+                }
+            };
+
+            struct alignas(64) shard {
+                mutable std::shared_mutex mutex_;
+                std::unordered_set<pooled_string, string_hash, string_equal> strings_;
+                std::size_t bytes_ = 0;
+            };
+
+            auto erase(const pooled_string* str) noexcept -> void {
+                auto& shard = shards_[string_hash{}(str->str_) % _STRING_POOL_SHARDS];
+                const auto lock = std::unique_lock{shard.mutex_};
+                if (str->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    shard.bytes_ -= str->str_.size();
+                    shard.strings_.erase(shard.strings_.find(str->str_));
+                }
+            }
+
+            std::array<shard, _STRING_POOL_SHARDS> shards_;
+
+            static inline const pooled_string empty_ = {};
+            static inline thread_local string_pool* active_ = nullptr;
+        };
+    }
+
+    // a counted handle to a string in the current pool. a pool holds each string once, so two
+    // handles from the same pool are equal exactly when they point to the same string, while
+    // handles from different pools compare their contents. ordering compares the contents, so
+    // that objects keep their keys in lexicographic order
+    class interned_string {
+    public:
+        interned_string() noexcept
+            : str_{detail::string_pool::empty()} {}
+        interned_string(const std::string_view str)
+            : str_{detail::string_pool::current().intern(str)} {}
+        interned_string(const std::string& str)
+            : interned_string{std::string_view{str}} {}
+        interned_string(const char* str)
+            : interned_string{std::string_view{str}} {}
+
+        interned_string(const interned_string& other) noexcept
+            : str_{other.str_} {
+            detail::string_pool::retain(str_);
+        }
+
+        interned_string(interned_string&& other) noexcept
+            : str_{std::exchange(other.str_, detail::string_pool::empty())} {}
+
+        auto operator=(const interned_string& other) noexcept -> interned_string& {
+            auto copy = other;
+            std::swap(str_, copy.str_);
+            return *this;
+        }
+
+        auto operator=(interned_string&& other) noexcept -> interned_string& {
+            std::swap(str_, other.str_);
+            return *this;
+        }
+
+        ~interned_string() noexcept {
+            detail::string_pool::release(str_);
+        }
+
+        auto str() const noexcept -> const std::string& {
+            return str_->str_;
+        }
+
+        auto data() const noexcept -> const char* {
+            return str_->str_.data();
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return str_->str_.size();
+        }
+
+        operator std::string_view() const noexcept {
+            return str_->str_;
+        }
+
+        friend auto operator==(const interned_string& s1, const interned_string& s2) noexcept -> bool {
+            if (s1.str_ == s2.str_) {
+                return true;
+            }
+            return s1.str_->pool_ != s2.str_->pool_ and s1.str_->str_ == s2.str_->str_;
+        }
+
+        friend auto operator==(const interned_string& s1, const std::string_view s2) noexcept -> bool {
+            return s1.str_->str_ == s2;
+        }
+
+        friend auto operator==(const interned_string& s1, const std::string& s2) noexcept -> bool {
+            return s1.str_->str_ == s2;
+        }
+
+        friend auto operator==(const interned_string& s1, const char* s2) noexcept -> bool {
+            return s1.str_->str_ == s2;
+        }
+
+        friend auto operator<=>(const interned_string& s1, const interned_string& s2) noexcept
+            -> std::strong_ordering {
+            if (s1.str_ == s2.str_) {
+                return std::strong_ordering::equal;
+            }
+            return s1.str_->str_ <=> s2.str_->str_;
+        }
+
+        friend auto operator<=>(const interned_string& s1, const std::string_view s2) noexcept
+            -> std::strong_ordering {
+            return std::string_view{s1.str_->str_} <=> s2;
+        }
+
+    private:
+        const detail::pooled_string* str_;
+    };
+}
+
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef CJSON_THREAD_POOL_HPP
+#define CJSON_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cjson::detail {
+    // a fixed set of worker threads with one task queue each. tasks submitted from outside the
+    // pool are spread round-robin, tasks submitted by a worker go to its own queue, and a worker
+    // whose queue is empty steals from the back of the others. the destructor finishes every
+    // queued task before joining the workers
+    class thread_pool {
+    public:
+        explicit thread_pool(const std::size_t threads = std::max(std::thread::hardware_concurrency(), 1u)) {
+            queues_.reserve(threads);
+            for (std::size_t i = 0; i < threads; ++i) {
+                queues_.push_back(std::make_unique<task_queue>());
+            }
+            workers_.reserve(threads);
+            for (std::size_t i = 0; i < threads; ++i) {
+                workers_.emplace_back([this, i] {
+                    run(i);
+                });
+            }
+        }
+
+        thread_pool(const thread_pool&) noexcept = delete;
+        thread_pool(thread_pool&&) noexcept = delete;
+
+        auto operator=(const thread_pool&) noexcept -> thread_pool& = delete;
+        auto operator=(thread_pool&&) noexcept -> thread_pool& = delete;
+
+        ~thread_pool() noexcept {
+            {
+                const auto lock = std::scoped_lock{mutex_};
+                stopping_ = true;
+            }
+            ready_.notify_all();
+            for (auto& worker : workers_) {
+                worker.join();
+            }
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return workers_.size();
+        }
+
+        // the returned future holds the task's result or the exception it threw
+        template <typename Task>
+        auto submit(Task&& task) -> std::future<std::invoke_result_t<std::decay_t<Task>>> {
+            using result = std::invoke_result_t<std::decay_t<Task>>;
+            auto packaged = std::make_shared<std::packaged_task<result()>>(std::forward<Task>(task));
+            auto future = packaged->get_future();
+            const auto index = current_pool_ == this
+                ? current_index_
+                : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+            {
+                const auto lock = std::scoped_lock{mutex_};
+                ++pending_;
+            }
+            {
+                auto& queue = *queues_[index];
+                const auto lock = std::scoped_lock{queue.mutex_};
+                queue.tasks_.emplace_back([packaged = std::move(packaged)] {
+                    (*packaged)();
+                });
+            }
+            ready_.notify_one();
+            return future;
+        }
+
+    private:
+        struct task_queue {
+            std::mutex mutex_;
+            std::deque<std::function<void()>> tasks_;
+        };
+
+        auto run(const std::size_t index) -> void {
+            current_pool_ = this;
+            current_index_ = index;
+            while (true) {
+                if (auto task = take(index)) {
+                    {
+                        const auto lock = std::scoped_lock{mutex_};
+                        --pending_;
+                    }
+                    (*task)();
+                    continue;
+                }
+                // pending_ is counted before a task is queued, so a woken worker may briefly
+                // find nothing to take and come back here
+                auto lock = std::unique_lock{mutex_};
+                ready_.wait(lock, [this] {
+                    return stopping_ or pending_ > 0;
+                });
+                if (stopping_ and pending_ == 0) {
+                    return;
+                }
+            }
+        }
+
+        // the front of the worker's own queue first, then the back of the others
+        auto take(const std::size_t index) -> std::optional<std::function<void()>> {
+            for (std::size_t i = 0; i < queues_.size(); ++i) {
+                auto& queue = *queues_[(index + i) % queues_.size()];
+                const auto lock = std::scoped_lock{queue.mutex_};
+                if (not queue.tasks_.empty()) {
+                    auto task = std::function<void()>{};
+                    if (i == 0) {
+                        task = std::move(queue.tasks_.front());
+                        queue.tasks_.pop_front();
+                    } else {
+                        task = std::move(queue.tasks_.back());
+                        queue.tasks_.pop_back();
+                    }
+                    return task;
+                }
+            }
+            return std::nullopt;
+        }
+
+        inline static thread_local const thread_pool* current_pool_ = nullptr;
+        inline static thread_local std::size_t current_index_ = 0;
+
+        std::vector<std::unique_ptr<task_queue>> queues_;
+        std::atomic<std::size_t> next_queue_ = 0;
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::size_t pending_ = 0;
+        bool stopping_ = false;
+        std::vector<std::thread> workers_;
+    };
+}
+
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef CJSON_BATCH_PARSER_HPP
+#define CJSON_BATCH_PARSER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../cjson_error.hpp"
+#include "../cjson_thread_pool.hpp"
+#include "cjson_parse_options.hpp"
+#include "cjson_parser.hpp"
+#include "cjson_reader.hpp"
+
+#define _BATCH_TASKS_PER_THREAD 4
+
+namespace cjson::detail::input {
+    template <typename JsonType>
+    struct parse_many_result {
+        // one per input, in input order; null where the input is not valid json
+        std::vector<JsonType> values;
+        // the failed inputs by index, in input order
+        std::vector<std::pair<std::size_t, json_input_error>> errors;
+    };
+
+    namespace batch {
+        // parses inputs into values with one parser, reset between inputs; each input holds one
+        // value, and errors are indexed from first
+        template <typename JsonType>
+        auto parse_range(const std::span<const std::string_view> inputs, const std::span<JsonType> values,
+            std::vector<std::pair<std::size_t, json_input_error>>& errors, const std::size_t first,
+            const parse_options& options) -> void {
+            auto parser = json_parser<string_reader, JsonType>{options, std::string_view{""}};
+            for (std::size_t i = 0; i < inputs.size(); ++i) {
+                parser.reset(std::string_view{inputs[i]});
+                auto result = parser.try_parse();
+                if (result and not parser.at_end()) {
+                    result = parse_result<JsonType>{parser.trailing_error()};
+                }
+                if (result) {
+                    values[i] = std::move(*result);
+                } else {
+                    errors.emplace_back(first + i, json_input_error(result.error().message(), result.error().pos_));
+                }
+            }
+        }
+    }
+
+    // parses every input, reusing one parser for all of them. a failing input is reported in
+    // errors and does not stop the others
+    template <typename JsonType>
+    auto parse_many(const std::span<const std::string_view> inputs, const parse_options& options = {})
+        -> parse_many_result<JsonType> {
+        auto result = parse_many_result<JsonType>{std::vector<JsonType>(inputs.size()), {}};
+        batch::parse_range<JsonType>(inputs, result.values, result.errors, 0, options);
+        return result;
+    }
+
+    // as above, with contiguous runs of inputs parsed on pool, one parser per run
+    template <typename JsonType>
+    auto parse_many(const std::span<const std::string_view> inputs, thread_pool& pool,
+        const parse_options& options = {}) -> parse_many_result<JsonType> {
+        auto result = parse_many_result<JsonType>{std::vector<JsonType>(inputs.size()), {}};
+        const auto tasks = pool.size() * _BATCH_TASKS_PER_THREAD;
+        const auto run = std::max<std::size_t>(1, (inputs.size() + tasks - 1) / tasks);
+        auto errors = std::vector<std::vector<std::pair<std::size_t, json_input_error>>>(
+            (inputs.size() + run - 1) / run);
+        auto futures = std::vector<std::future<void>>{};
+        futures.reserve(errors.size());
+        for (std::size_t i = 0; i < errors.size(); ++i) {
+            futures.push_back(pool.submit([&, i] {
+                const auto first = i * run;
+                const auto size = std::min(run, inputs.size() - first);
+                batch::parse_range<JsonType>(inputs.subspan(first, size),
+                    std::span{result.values}.subspan(first, size), errors[i], first, options);
+            }));
+        }
+        // every task writes into result, so all of them finish before an error propagates
+        for (const auto& future : futures) {
+            future.wait();
+        }
+        for (std::size_t i = 0; i < futures.size(); ++i) {
+            futures[i].get();
+            std::move(errors[i].begin(), errors[i].end(), std::back_inserter(result.errors));
+        }
+        return result;
+    }
+}
+
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef CJSON_BUILDER_HPP
+#define CJSON_BUILDER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cjson::detail::input {
+    // makes the containers of a json value out of their decoded elements, whichever format they
+    // were decoded from, so that every parser builds the same representations: arrays of numbers
+    // only keep their numbers packed, large objects are built from a sorted run of members, and
+    // objects with the key sequence of a recently built object share its shape
+    template <typename JsonType>
+    class json_builder {
+    public:
+        using key = typename JsonType::key;
+        using member = std::pair<key, JsonType>;
+        using shape_ptr = std::shared_ptr<const typename JsonType::shape>;
+
+        // the elements of an array being built. they are kept as plain numbers until the first
+        // element that is not a number, or until the array is made generic
+        struct elements {
+            // how many elements are expected, to reserve for; 0 if that is not known
+            std::size_t size_ = 0;
+            typename JsonType::number_array numbers_{};
+            typename JsonType::array values_{};
+            bool generic_ = false;
+        };
+
+        // the members of an object being built with a shape. while they follow the shape of a
+        // recently built object their keys are not stored
+        struct shaped_members {
+            std::vector<key> keys_;
+            typename JsonType::array values_;
+            shape_ptr shape_;
+        };
+
+        explicit json_builder(const std::size_t shape_cache_size) noexcept
+            : shape_cache_size_{shape_cache_size} {}
+
+        static auto add_number(elements& array, const typename JsonType::number n) -> void {
+            if (array.generic_) {
+                array.values_.emplace_back(n);
+                return;
+            } else if (array.numbers_.empty()) {
+                array.numbers_.reserve(array.size_);
+            }
+            array.numbers_.push_back(n);
+        }
+
+        static auto add_element(elements& array, JsonType&& value) -> void {
+            if (not array.generic_ and value.is_number()) {
+                add_number(array, static_cast<typename JsonType::number>(value));
+                return;
+            }
+            make_generic(array);
+            array.values_.push_back(std::move(value));
+        }
+
+        // moves the numbers added so far into generic elements
+        static auto make_generic(elements& array) -> void {
+            if (array.generic_) {
+                return;
+            }
+            array.values_.reserve(std::max(array.size_, array.numbers_.size() + 1));
+            for (const auto n : array.numbers_) {
+                array.values_.emplace_back(n);
+            }
+            array.numbers_ = {};
+            array.generic_ = true;
+        }
+
+        static auto make_array(elements& array) -> JsonType {
+            return array.generic_ ? JsonType{std::move(array.values_)} : JsonType{std::move(array.numbers_)};
+        }
+
+        // sorts the members unless they are in order already, which lets every one of them be
+        // inserted at the end of the object in constant time. the sort is stable so that, as with
+        // emplace, the first of duplicate keys is kept
+        static auto make_object(std::vector<member>& members) -> typename JsonType::object {
+            const auto less = [](const member& lhs, const member& rhs) {
+                return typename JsonType::object::key_compare{}(lhs.first, rhs.first);
+            };
+            if (not std::is_sorted(members.begin(), members.end(), less)) {
+                std::stable_sort(members.begin(), members.end(), less);
+            }
+            auto json_object = typename JsonType::object{};
+            for (auto& [key, value] : members) {
+                json_object.emplace_hint(json_object.end(), std::move(key), std::move(value));
+            }
+            return json_object;
+        }
+
+        // whether key is the next key of the shape the members follow, which the first key
+        // picks from the recently built shapes. if it is not, the members stop following a
+        // shape and the caller adds key to keys_ itself, before adding its value
+        auto follow_shape(shaped_members& members, const std::string_view key) const -> bool {
+            const auto index = members.values_.size();
+            if (index == 0) {
+                members.shape_ = find_shape(key);
+            }
+            if (members.shape_ and index < members.shape_->size() and members.shape_->parsed_key(index) == key) {
+                return true;
+            }
+            materialize_keys(members, index);
+            return false;
+        }
+
+        // an object with no generic object behind it, or a generic one if its keys cannot make a
+        // shape
+        auto make_shaped(shaped_members& members) -> JsonType {
+            if (members.shape_ and members.shape_->size() != members.values_.size()) {
+                materialize_keys(members, members.values_.size());
+            }
+            if (not members.shape_) {
+                members.shape_ = JsonType::shape::make(members.keys_);
+                if (not members.shape_) {
+                    auto json_object = typename JsonType::object{};
+                    for (std::size_t i = 0; i < members.keys_.size(); ++i) {
+                        json_object.emplace(std::move(members.keys_[i]), std::move(members.values_[i]));
+                    }
+                    return JsonType{std::move(json_object)};
+                }
+            }
+            remember_shape(members.shape_);
+
+            auto sorted_values = typename JsonType::array(members.values_.size());
+            for (std::size_t i = 0; i < members.values_.size(); ++i) {
+                sorted_values[members.shape_->sorted_index(i)] = std::move(members.values_[i]);
+            }
+            return JsonType{typename JsonType::shaped_object{std::move(members.shape_), std::move(sorted_values)}};
+        }
+
+    private:
+        auto find_shape(const std::string_view first_key) const noexcept -> shape_ptr {
+            for (const auto& shape : shapes_) {
+                if (shape->size() > 0 and shape->parsed_key(0) == first_key) {
+                    return shape;
+                }
+            }
+            return nullptr;
+        }
+
+        static auto materialize_keys(shaped_members& members, const std::size_t count) -> void {
+            if (members.shape_) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    members.keys_.push_back(members.shape_->parsed_key(i));
+                }
+                members.shape_ = nullptr;
+            }
+        }
+
+        auto remember_shape(const shape_ptr& shape) -> void {
+            const auto iter = std::find(shapes_.begin(), shapes_.end(), shape);
+            if (iter != shapes_.end()) {
+                std::rotate(shapes_.begin(), iter, iter + 1);
+            } else if (shape_cache_size_ > 0) {
+                if (shapes_.size() < shape_cache_size_) {
+                    shapes_.emplace_back();
+                }
+                std::move_backward(shapes_.begin(), shapes_.end() - 1, shapes_.end());
+                shapes_.front() = shape;
+            }
+        }
+
+        std::size_t shape_cache_size_;
+        std::vector<shape_ptr> shapes_;
+    };
+}
+
+
+#endif
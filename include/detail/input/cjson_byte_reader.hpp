@@ -0,0 +1,87 @@
+#ifndef CJSON_BYTE_READER_HPP
+#define CJSON_BYTE_READER_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "../cjson_error.hpp"
+
+#define _MAX_BINARY_DEPTH 512
+
+namespace cjson::detail::input {
+    // bounds-checked sequential access to a binary document held in memory
+    class byte_reader {
+    public:
+        explicit byte_reader(const std::string_view bytes) noexcept
+            : bytes_{bytes} {}
+
+        auto position() const noexcept -> std::size_t {
+            return pos_;
+        }
+
+        auto remaining() const noexcept -> std::size_t {
+            return bytes_.size() - pos_;
+        }
+
+        auto at_end() const noexcept -> bool {
+            return pos_ == bytes_.size();
+        }
+
+        auto peek() const -> std::uint8_t {
+            require(1);
+            return static_cast<std::uint8_t>(bytes_[pos_]);
+        }
+
+        auto read_byte() -> std::uint8_t {
+            const auto byte = peek();
+            ++pos_;
+            return byte;
+        }
+
+        template <typename T>
+        auto read_big_endian() -> T {
+            require(sizeof(T));
+            auto value = T{};
+            std::memcpy(&value, bytes_.data() + pos_, sizeof(T));
+            pos_ += sizeof(T);
+            if constexpr (std::endian::native == std::endian::little and sizeof(T) > 1) {
+                value = byteswap(value);
+            }
+            return value;
+        }
+
+        auto read_bytes(const std::size_t n) -> std::string_view {
+            require(n);
+            const auto bytes = bytes_.substr(pos_, n);
+            pos_ += n;
+            return bytes;
+        }
+
+    private:
+        auto require(const std::size_t n) const -> void {
+            if (n > bytes_.size() - pos_) {
+                throw json_input_error(truncated_input_error(bytes_.size()));
+            }
+        }
+
+        template <typename T>
+        static auto byteswap(const T value) noexcept -> T {
+            if constexpr (sizeof(T) == 2) {
+                return static_cast<T>(__builtin_bswap16(static_cast<std::uint16_t>(value)));
+            } else if constexpr (sizeof(T) == 4) {
+                return static_cast<T>(__builtin_bswap32(static_cast<std::uint32_t>(value)));
+            } else {
+                return static_cast<T>(__builtin_bswap64(static_cast<std::uint64_t>(value)));
+            }
+        }
+
+        std::string_view bytes_;
+        std::size_t pos_ = 0;
+    };
+}
+
+
+#endif
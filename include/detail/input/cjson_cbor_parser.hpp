@@ -0,0 +1,252 @@
+#ifndef CJSON_CBOR_PARSER_HPP
+#define CJSON_CBOR_PARSER_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../cjson_error.hpp"
+#include "cjson_builder.hpp"
+#include "cjson_byte_reader.hpp"
+#include "cjson_parse_options.hpp"
+
+#define _CBOR_BREAK 0xFF
+#define _CBOR_INDEFINITE 31
+#define _CBOR_TAG_POSITIVE_BIGNUM 2
+#define _CBOR_TAG_NEGATIVE_BIGNUM 3
+
+namespace cjson::detail::input {
+    // builds json values from a sequence of cbor data items (rfc 8949). integers and floats of
+    // any width become numbers, byte strings become strings holding the raw bytes, undefined
+    // becomes null and indefinite-length items are concatenated. tags are skipped and their
+    // content decoded as usual, except bignums (tags 2 and 3) which become numbers. arrays and
+    // maps are made by json_builder, as in msgpack_parser; of the parse_options only
+    // shared_shapes and shape_cache_size apply
+    //
+    // the whole encoded input has to be in memory up front: items are read one at a time from
+    // a sequence, but not from input that is still arriving. a json_reader cannot stand in for
+    // the buffer, since it hands out chars with '\0' marking the end and binary input holds
+    // zero bytes; a truncated item throws json_input_error rather than waiting for more
+    template <typename JsonType>
+    class cbor_parser {
+    public:
+        explicit cbor_parser(const std::string_view bytes, const parse_options& options = {})
+            : reader_{bytes}, shared_shapes_{options.shared_shapes}, builder_{options.shape_cache_size} {}
+
+        cbor_parser(const cbor_parser&) noexcept = delete;
+        cbor_parser(cbor_parser&&) noexcept = default;
+
+        auto operator=(const cbor_parser&) noexcept -> cbor_parser& = delete;
+        auto operator=(cbor_parser&&) noexcept -> cbor_parser& = default;
+
+        ~cbor_parser() noexcept = default;
+
+        // decodes the next data item; call repeatedly until at_end() to read a sequence
+        auto parse() -> JsonType {
+            return parse_value(0);
+        }
+
+        auto at_end() const noexcept -> bool {
+            return reader_.at_end();
+        }
+
+        auto position() const noexcept -> std::size_t {
+            return reader_.position();
+        }
+
+    private:
+        using number = typename JsonType::number;
+        using string = typename JsonType::string;
+
+        enum class major_type : std::uint8_t {
+            _UNSIGNED, _NEGATIVE, _BYTES, _TEXT, _ARRAY, _MAP, _TAG, _SIMPLE
+        };
+
+        auto parse_value(const std::size_t depth) -> JsonType {
+            if (depth > _MAX_BINARY_DEPTH) {
+                throw json_input_error(nesting_depth_error(reader_.position()));
+            }
+            const auto offset = reader_.position();
+            const auto initial = reader_.read_byte();
+            switch (static_cast<major_type>(initial >> 5)) {
+                case major_type::_UNSIGNED:
+                    return JsonType{static_cast<number>(read_argument(initial, offset))};
+                case major_type::_NEGATIVE:
+                    return JsonType{-1 - static_cast<number>(read_argument(initial, offset))};
+                case major_type::_BYTES:
+                case major_type::_TEXT:
+                    return JsonType{parse_string(initial, offset)};
+                case major_type::_ARRAY:
+                    return parse_array(initial, offset, depth);
+                case major_type::_MAP:
+                    return parse_map(initial, offset, depth);
+                case major_type::_TAG:
+                    return parse_tagged(read_argument(initial, offset), depth);
+                case major_type::_SIMPLE:
+                default:
+                    return parse_simple(initial, offset);
+            }
+        }
+
+        auto read_argument(const std::uint8_t initial, const std::size_t offset) -> std::uint64_t {
+            const auto info = static_cast<std::uint8_t>(initial & 0x1F);
+            if (info < 24) {
+                return info;
+            }
+            switch (info) {
+                case 24:
+                    return reader_.read_byte();
+                case 25:
+                    return reader_.read_big_endian<std::uint16_t>();
+                case 26:
+                    return reader_.read_big_endian<std::uint32_t>();
+                case 27:
+                    return reader_.read_big_endian<std::uint64_t>();
+                default:
+                    throw json_input_error(invalid_type_byte_error(initial, offset));
+            }
+        }
+
+        auto read_length(const std::uint8_t initial, const std::size_t offset) -> std::size_t {
+            const auto length = read_argument(initial, offset);
+            if (length > reader_.remaining()) {
+                throw json_input_error(truncated_input_error(reader_.position() + reader_.remaining()));
+            }
+            return static_cast<std::size_t>(length);
+        }
+
+        // indefinite-length strings are a series of definite chunks of the same major type
+        auto parse_string(const std::uint8_t initial, const std::size_t offset) -> string {
+            if ((initial & 0x1F) != _CBOR_INDEFINITE) {
+                return string{reader_.read_bytes(read_length(initial, offset))};
+            }
+            auto str = string{};
+            while (reader_.peek() != _CBOR_BREAK) {
+                const auto chunk_offset = reader_.position();
+                const auto chunk = reader_.read_byte();
+                if ((chunk >> 5) != (initial >> 5) or (chunk & 0x1F) == _CBOR_INDEFINITE) {
+                    throw json_input_error(invalid_type_byte_error(chunk, chunk_offset));
+                }
+                str += reader_.read_bytes(read_length(chunk, chunk_offset));
+            }
+            reader_.read_byte();
+            return str;
+        }
+
+        auto parse_array(const std::uint8_t initial, const std::size_t offset, const std::size_t depth) -> JsonType {
+            const auto indefinite = (initial & 0x1F) == _CBOR_INDEFINITE;
+            const auto size = indefinite ? std::size_t{0} : read_length(initial, offset);
+            auto elements = typename json_builder<JsonType>::elements{.size_ = size};
+            for (std::size_t i = 0; indefinite ? not consume_break() : i < size; ++i) {
+                json_builder<JsonType>::add_element(elements, parse_value(depth + 1));
+            }
+            return json_builder<JsonType>::make_array(elements);
+        }
+
+        auto parse_map(const std::uint8_t initial, const std::size_t offset, const std::size_t depth) -> JsonType {
+            const auto indefinite = (initial & 0x1F) == _CBOR_INDEFINITE;
+            const auto size = indefinite ? std::size_t{0} : read_length(initial, offset);
+            if (shared_shapes_) {
+                return parse_shaped_map(indefinite, size, depth);
+            }
+            auto members = std::vector<typename json_builder<JsonType>::member>{};
+            members.reserve(size);
+            for (std::size_t i = 0; indefinite ? not consume_break() : i < size; ++i) {
+                auto key = typename JsonType::key{parse_key()};
+                members.emplace_back(std::move(key), parse_value(depth + 1));
+            }
+            return JsonType{json_builder<JsonType>::make_object(members)};
+        }
+
+        auto parse_shaped_map(const bool indefinite, const std::size_t size, const std::size_t depth) -> JsonType {
+            auto members = typename json_builder<JsonType>::shaped_members{};
+            members.values_.reserve(size);
+            for (std::size_t i = 0; indefinite ? not consume_break() : i < size; ++i) {
+                auto key = parse_key();
+                if (not builder_.follow_shape(members, key)) {
+                    members.keys_.emplace_back(std::move(key));
+                }
+                members.values_.push_back(parse_value(depth + 1));
+            }
+            return builder_.make_shaped(members);
+        }
+
+        auto parse_key() -> string {
+            const auto offset = reader_.position();
+            const auto initial = reader_.read_byte();
+            if (static_cast<major_type>(initial >> 5) != major_type::_TEXT) {
+                throw json_input_error(invalid_binary_key_error(offset));
+            }
+            return parse_string(initial, offset);
+        }
+
+        auto parse_tagged(const std::uint64_t tag, const std::size_t depth) -> JsonType {
+            const auto bignum = tag == _CBOR_TAG_POSITIVE_BIGNUM or tag == _CBOR_TAG_NEGATIVE_BIGNUM;
+            if (bignum and static_cast<major_type>(reader_.peek() >> 5) == major_type::_BYTES) {
+                const auto offset = reader_.position();
+                const auto magnitude = parse_string(reader_.read_byte(), offset);
+                auto n = number{0};
+                for (const auto byte : magnitude) {
+                    n = n * 256 + static_cast<number>(static_cast<unsigned char>(byte));
+                }
+                return JsonType{(tag == _CBOR_TAG_NEGATIVE_BIGNUM) ? -1 - n : n};
+            }
+            return parse_value(depth + 1);
+        }
+
+        auto parse_simple(const std::uint8_t initial, const std::size_t offset) -> JsonType {
+            switch (initial & 0x1F) {
+                case 20:
+                    return JsonType{false};
+                case 21:
+                    return JsonType{true};
+                case 22:
+                case 23:
+                    return JsonType{nullptr};
+                case 25:
+                    return JsonType{static_cast<number>(half_to_double(reader_.read_big_endian<std::uint16_t>()))};
+                case 26:
+                    return JsonType{static_cast<number>(std::bit_cast<float>(reader_.read_big_endian<std::uint32_t>()))};
+                case 27:
+                    return JsonType{static_cast<number>(std::bit_cast<double>(reader_.read_big_endian<std::uint64_t>()))};
+                default:
+                    throw json_input_error(invalid_type_byte_error(initial, offset));
+            }
+        }
+
+        auto consume_break() -> bool {
+            if (reader_.peek() == _CBOR_BREAK) {
+                reader_.read_byte();
+                return true;
+            }
+            return false;
+        }
+
+        static auto half_to_double(const std::uint16_t half) noexcept -> double {
+            const auto exponent = (half >> 10) & 0x1F;
+            const auto mantissa = half & 0x3FF;
+            auto value = 0.0;
+            if (exponent == 0) {
+                value = std::ldexp(mantissa, -24);
+            } else if (exponent != 0x1F) {
+                value = std::ldexp(mantissa + 1024, exponent - 25);
+            } else {
+                value = (mantissa == 0) ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+            }
+            return (half & 0x8000) ? -value : value;
+        }
+
+        byte_reader reader_;
+        bool shared_shapes_;
+        json_builder<JsonType> builder_;
+    };
+}
+
+
+#endif
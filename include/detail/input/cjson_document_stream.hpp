@@ -0,0 +1,114 @@
+#ifndef CJSON_DOCUMENT_STREAM_HPP
+#define CJSON_DOCUMENT_STREAM_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "cjson_parser.hpp"
+
+namespace cjson::detail::input {
+    // reads back-to-back top-level values, e.g. {...}{...}[...], from one reader. a single parser
+    // and scanner serve the whole stream, so their buffers are reused from one document to the
+    // next. after a json_input_error the stream cannot be resumed
+    template <typename Reader, typename JsonType>
+    class json_document_stream {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = JsonType;
+            using difference_type = std::ptrdiff_t;
+            using pointer = JsonType*;
+            using reference = JsonType&;
+
+            iterator() noexcept = default;
+            explicit iterator(json_document_stream& stream)
+                : stream_{&stream}, current_{stream.next()} {}
+
+            auto operator*() const noexcept -> reference {
+                return *current_;
+            }
+
+            auto operator->() const noexcept -> pointer {
+                return &*current_;
+            }
+
+            auto operator++() -> iterator& {
+                current_ = stream_->next();
+                return *this;
+            }
+
+            auto operator++(int) -> void {
+                ++*this;
+            }
+
+            friend auto operator==(const iterator& iter, std::default_sentinel_t) noexcept -> bool {
+                return not iter.current_;
+            }
+
+        private:
+            json_document_stream* stream_ = nullptr;
+            mutable std::optional<JsonType> current_;
+        };
+
+        template <typename ...Args>
+        explicit json_document_stream(Args&& ...args)
+            : parser_{std::forward<Args>(args)...} {}
+
+        json_document_stream(const json_document_stream&) noexcept = delete;
+        json_document_stream(json_document_stream&&) noexcept = default;
+
+        auto operator=(const json_document_stream&) noexcept -> json_document_stream& = delete;
+        auto operator=(json_document_stream&&) noexcept -> json_document_stream& = default;
+
+        ~json_document_stream() noexcept = default;
+
+        // the next document, or nothing once the input is exhausted
+        auto next() -> std::optional<JsonType> {
+            if (parser_.at_end()) {
+                return std::nullopt;
+            }
+            ++count_;
+            return parser_.parse();
+        }
+
+        // up to size documents; fewer only at the end of the input
+        auto next_batch(const std::size_t size) -> std::vector<JsonType> {
+            auto batch = std::vector<JsonType>{};
+            batch.reserve(size);
+            while (batch.size() < size and not parser_.at_end()) {
+                ++count_;
+                batch.push_back(parser_.parse());
+            }
+            return batch;
+        }
+
+        auto at_end() const noexcept -> bool {
+            return parser_.at_end();
+        }
+
+        // number of documents read so far
+        auto count() const noexcept -> std::size_t {
+            return count_;
+        }
+
+        // documents are read as the iterator advances, so begin() starts at the next unread one
+        auto begin() -> iterator {
+            return iterator{*this};
+        }
+
+        auto end() const noexcept -> std::default_sentinel_t {
+            return std::default_sentinel;
+        }
+
+    private:
+        json_parser<Reader, JsonType> parser_;
+        std::size_t count_ = 0;
+    };
+}
+
+
+#endif
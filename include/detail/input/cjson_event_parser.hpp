@@ -0,0 +1,397 @@
+#ifndef CJSON_EVENT_PARSER_HPP
+#define CJSON_EVENT_PARSER_HPP
+
+#include <cctype>
+#include <charconv>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../cjson_error.hpp"
+#include "../cjson_generator.hpp"
+#include "cjson_reader.hpp"
+#include "cjson_scanner.hpp"
+#include "cjson_token.hpp"
+
+#define _FEED_COMPACT_SIZE 4096
+
+namespace cjson::detail::input {
+    enum class event_type: unsigned short int {
+        START_OBJECT,
+        END_OBJECT,
+        START_ARRAY,
+        END_ARRAY,
+        KEY,
+        STRING,
+        NUMBER,
+        TRUE,
+        FALSE,
+        NULL_VALUE,
+        // only yielded by a source that has run out of buffered input, see async_event_reader
+        NEED_INPUT
+    };
+
+    struct json_event {
+        // as a double, for NUMBER events
+        auto number() const noexcept -> double {
+            auto value = double{};
+            std::from_chars(spelling_.data(), spelling_.data() + spelling_.size(), value);
+            return value;
+        }
+
+        event_type type_;
+        // the unescaped text of keys and strings, the literal of numbers. it refers to the
+        // parser's token buffer, so it is only valid until the next event is asked for
+        std::string_view spelling_;
+        position pos_;
+    };
+
+    namespace events {
+        // what the next token has to be
+        enum class state: unsigned short int {
+            VALUE,
+            FIRST_VALUE,
+            KEY,
+            FIRST_KEY,
+            COLON,
+            SEPARATOR
+        };
+
+        // the tokens of a scanner over a complete input
+        template <typename Reader>
+        class scanner_source {
+        public:
+            explicit scanner_source(std::unique_ptr<Reader>&& reader)
+                : scanner_{std::move(reader)} {}
+
+            auto next(json_token& token) -> bool {
+                scanner_.get_token(token);
+                return true;
+            }
+
+        private:
+            json_scanner<Reader> scanner_;
+        };
+
+        // the tokens of input that arrives in pieces. the scanner is only asked for a token once
+        // the whole of it is buffered, and for a number or literal, the character after it too.
+        // when the scanner runs into the end of the buffer after a token, it reads that character
+        // again once more input is appended, so it never takes the end of the buffer for the end
+        // of the input
+        class feed_source {
+        public:
+            feed_source() noexcept = default;
+
+            feed_source(const feed_source&) noexcept = delete;
+            feed_source(feed_source&&) noexcept = delete;
+
+            auto operator=(const feed_source&) noexcept -> feed_source& = delete;
+            auto operator=(feed_source&&) noexcept -> feed_source& = delete;
+
+            ~feed_source() noexcept = default;
+
+            auto append(const std::string_view bytes) -> void {
+                const auto used = unread();
+                if (used > _FEED_COMPACT_SIZE and used * 2 > buffer_.size()) {
+                    buffer_.erase(0, used);
+                    reader_->pos_ -= used;
+                }
+                buffer_.append(bytes);
+                if (scanner_ and reader_->starved_ and not bytes.empty()) {
+                    reader_->starved_ = false;
+                    scanner_->reread();
+                }
+            }
+
+            auto finish() noexcept -> void {
+                finished_ = true;
+            }
+
+            // false if more input is needed first
+            auto next(json_token& token) -> bool {
+                if (not finished_ and not buffered()) {
+                    return false;
+                }
+                if (not scanner_) {
+                    auto reader = std::make_unique<feed_reader>(buffer_);
+                    reader_ = reader.get();
+                    scanner_.emplace(std::move(reader));
+                }
+                scanner_->get_token(token);
+                return true;
+            }
+
+        private:
+            class feed_reader: json_reader {
+            public:
+                explicit feed_reader(const std::string& buffer) noexcept
+                    : buffer_{&buffer} {}
+
+                ~feed_reader() noexcept override = default;
+
+                auto advance() noexcept -> char override {
+                    if (pos_ < buffer_->size()) {
+                        return (*buffer_)[pos_++];
+                    }
+                    starved_ = true;
+                    return _CHAR_END;
+                }
+
+                const std::string* buffer_;
+                std::size_t pos_ = 0;
+                // whether the scanner's current character is the end of the buffer rather than
+                // a character of it
+                bool starved_ = false;
+            };
+
+            // the offset of the scanner's current character; everything before it has been read
+            auto unread() const noexcept -> std::size_t {
+                if (not scanner_) {
+                    return 0;
+                }
+                return reader_->starved_ ? reader_->pos_ : reader_->pos_ - 1;
+            }
+
+            // whether the next token is in the buffer, with the character after it for a number
+            // or literal, which only ends where something else starts
+            auto buffered() const noexcept -> bool {
+                auto i = unread();
+                while (i < buffer_.size() and std::isspace(static_cast<unsigned char>(buffer_[i]))) {
+                    ++i;
+                }
+                if (i == buffer_.size()) {
+                    return false;
+                }
+                const auto is_literal = [](const char c) {
+                    return std::isalnum(static_cast<unsigned char>(c)) or c == _MINUS or c == _PLUS
+                        or c == _DECIMAL_POINT;
+                };
+                if (buffer_[i] == _QUOTE) {
+                    for (++i; i < buffer_.size() and buffer_[i] != _QUOTE; ++i) {
+                        if (buffer_[i] == _BACKSLASH) {
+                            ++i;
+                        }
+                    }
+                    return i < buffer_.size();
+                } else if (is_literal(buffer_[i])) {
+                    while (i < buffer_.size() and is_literal(buffer_[i])) {
+                        ++i;
+                    }
+                    return i < buffer_.size();
+                }
+                return true;
+            }
+
+            std::string buffer_;
+            bool finished_ = false;
+            feed_reader* reader_ = nullptr;
+            std::optional<json_scanner<feed_reader>> scanner_;
+        };
+
+        // the events of one json value, read from the tokens of source, which is either held by
+        // value or through a std::reference_wrapper
+        template <typename Source>
+        auto parse(Source source) -> generator<json_event> {
+            std::unwrap_reference_t<Source>& tokens = source;
+            auto token = json_token{};
+            // whether each open container is an object
+            auto objects = std::vector<bool>{};
+            auto current = state::VALUE;
+            while (true) {
+                while (not tokens.next(token)) {
+                    co_yield json_event{event_type::NEED_INPUT, {}, token.pos_};
+                }
+                auto closed = false;
+                switch (current) {
+                    case state::FIRST_KEY:
+                        if (token.tok_ == token::RIGHT_BRACE) {
+                            closed = true;
+                            break;
+                        }
+                        [[fallthrough]];
+                    case state::KEY:
+                        if (token.tok_ != token::STRING) {
+                            throw json_input_error(invalid_key_error(token.spelling_).what(), token.pos_);
+                        }
+                        co_yield json_event{event_type::KEY, token.spelling_, token.pos_};
+                        current = state::COLON;
+                        break;
+                    case state::COLON:
+                        if (token.tok_ != token::COLON) {
+                            throw json_input_error(invalid_colon_error(token.spelling_).what(), token.pos_);
+                        }
+                        current = state::VALUE;
+                        break;
+                    case state::FIRST_VALUE:
+                        if (token.tok_ == token::RIGHT_BRACKET) {
+                            closed = true;
+                            break;
+                        }
+                        [[fallthrough]];
+                    case state::VALUE:
+                        current = state::SEPARATOR;
+                        switch (token.tok_) {
+                            case token::LEFT_BRACE:
+                                co_yield json_event{event_type::START_OBJECT, token.spelling_, token.pos_};
+                                objects.push_back(true);
+                                current = state::FIRST_KEY;
+                                break;
+                            case token::LEFT_BRACKET:
+                                co_yield json_event{event_type::START_ARRAY, token.spelling_, token.pos_};
+                                objects.push_back(false);
+                                current = state::FIRST_VALUE;
+                                break;
+                            case token::NUMBER:
+                                co_yield json_event{event_type::NUMBER, token.spelling_, token.pos_};
+                                break;
+                            case token::STRING:
+                                co_yield json_event{event_type::STRING, token.spelling_, token.pos_};
+                                break;
+                            case token::TRUE:
+                                co_yield json_event{event_type::TRUE, token.spelling_, token.pos_};
+                                break;
+                            case token::FALSE:
+                                co_yield json_event{event_type::FALSE, token.spelling_, token.pos_};
+                                break;
+                            case token::NULL_VALUE:
+                                co_yield json_event{event_type::NULL_VALUE, token.spelling_, token.pos_};
+                                break;
+                            default:
+                                throw json_input_error(invalid_json_value_error(token.spelling_).what(), token.pos_);
+                        }
+                        break;
+                    case state::SEPARATOR:
+                        if (token.tok_ == token::COMMA) {
+                            current = objects.back() ? state::KEY : state::VALUE;
+                        } else if (token.tok_ == (objects.back() ? token::RIGHT_BRACE : token::RIGHT_BRACKET)) {
+                            closed = true;
+                        } else if (objects.back()) {
+                            throw json_input_error(invalid_object_error(token.spelling_).what(), token.pos_);
+                        } else {
+                            throw json_input_error(invalid_array_error(token.spelling_).what(), token.pos_);
+                        }
+                        break;
+                }
+                if (closed) {
+                    co_yield json_event{objects.back() ? event_type::END_OBJECT : event_type::END_ARRAY,
+                        token.spelling_, token.pos_};
+                    objects.pop_back();
+                    current = state::SEPARATOR;
+                }
+                if (current == state::SEPARATOR and objects.empty()) {
+                    co_return;
+                }
+            }
+        }
+    }
+
+    // the events of the first json value in the input, read lazily as the generator advances.
+    // malformed input throws json_input_error from the generator
+    template <typename Reader, typename ...Args>
+    auto parse_events(Args&& ...args) -> generator<json_event> {
+        return events::parse(events::scanner_source<Reader>{std::make_unique<Reader>(std::forward<Args>(args)...)});
+    }
+
+    // the events of one json value whose bytes arrive piecemeal, e.g. from a socket. a coroutine
+    // co_awaits next() for each event and is suspended while the bytes so far hold no complete
+    // token; feed() resumes it, on the caller's thread, once they do. many parses can so share
+    // one event loop without threads or buffering whole documents. bind what co_await returns,
+    // as in while (auto event = co_await reader.next()): gcc 12 miscompiles the unnamed form
+    class async_event_reader {
+    public:
+        class awaiter {
+        public:
+            explicit awaiter(async_event_reader& reader) noexcept
+                : reader_{reader} {}
+
+            auto await_ready() -> bool {
+                return reader_.pull();
+            }
+
+            auto await_suspend(const std::coroutine_handle<> handle) noexcept -> void {
+                reader_.waiting_ = handle;
+            }
+
+            // the next event, or nothing after the last one; the errors of the input are thrown
+            // here
+            auto await_resume() -> std::optional<json_event> {
+                return reader_.take();
+            }
+
+        private:
+            async_event_reader& reader_;
+        };
+
+        async_event_reader()
+            : events_{events::parse(std::ref(source_))} {}
+
+        async_event_reader(const async_event_reader&) noexcept = delete;
+        async_event_reader(async_event_reader&&) noexcept = delete;
+
+        auto operator=(const async_event_reader&) noexcept -> async_event_reader& = delete;
+        auto operator=(async_event_reader&&) noexcept -> async_event_reader& = delete;
+
+        ~async_event_reader() noexcept = default;
+
+        auto feed(const std::string_view bytes) -> void {
+            source_.append(bytes);
+            wake();
+        }
+
+        // no more bytes will come
+        auto finish() -> void {
+            source_.finish();
+            wake();
+        }
+
+        auto next() noexcept -> awaiter {
+            return awaiter{*this};
+        }
+
+    private:
+        // advances the parse unless it is still short of input; true once there is something for
+        // await_resume: an event, the end or an error
+        auto pull() -> bool {
+            try {
+                current_ = events_.next();
+            } catch (...) {
+                error_ = std::current_exception();
+                return true;
+            }
+            return current_ == nullptr or current_->type_ != event_type::NEED_INPUT;
+        }
+
+        auto take() -> std::optional<json_event> {
+            if (error_) {
+                std::rethrow_exception(std::exchange(error_, nullptr));
+            }
+            if (current_ == nullptr) {
+                return std::nullopt;
+            }
+            return *current_;
+        }
+
+        auto wake() -> void {
+            if (waiting_ and pull()) {
+                std::exchange(waiting_, {}).resume();
+            }
+        }
+
+        events::feed_source source_;
+        generator<json_event> events_;
+        const json_event* current_ = nullptr;
+        std::exception_ptr error_;
+        std::coroutine_handle<> waiting_;
+    };
+}
+
+
+#endif
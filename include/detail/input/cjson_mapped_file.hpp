@@ -0,0 +1,71 @@
+#ifndef CJSON_MAPPED_FILE_HPP
+#define CJSON_MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cjson::detail::input {
+    // a read-only private mapping of a whole file, unmapped on destruction
+    class mapped_file {
+    public:
+        explicit mapped_file(const std::string& path) {
+            const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "open " + path);
+            }
+            struct stat info{};
+            if (::fstat(fd, &info) < 0) {
+                const auto error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "fstat " + path);
+            }
+            size_ = static_cast<std::size_t>(info.st_size);
+            if (size_ > 0) {
+                auto* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data == MAP_FAILED) {
+                    const auto error = errno;
+                    ::close(fd);
+                    throw std::system_error(error, std::generic_category(), "mmap " + path);
+                }
+                data_ = static_cast<const char*>(data);
+            }
+            ::close(fd);
+        }
+
+        mapped_file(const mapped_file&) noexcept = delete;
+        mapped_file(mapped_file&& other) noexcept
+            : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)} {}
+
+        auto operator=(const mapped_file&) noexcept -> mapped_file& = delete;
+        auto operator=(mapped_file&& other) noexcept -> mapped_file& {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            return *this;
+        }
+
+        ~mapped_file() noexcept {
+            if (data_ != nullptr) {
+                ::munmap(const_cast<char*>(data_), size_);
+            }
+        }
+
+        auto bytes() const noexcept -> std::string_view {
+            return {data_, size_};
+        }
+
+    private:
+        const char* data_ = nullptr;
+        std::size_t size_ = 0;
+    };
+}
+
+
+#endif
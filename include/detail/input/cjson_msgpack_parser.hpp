@@ -0,0 +1,207 @@
+#ifndef CJSON_MSGPACK_PARSER_HPP
+#define CJSON_MSGPACK_PARSER_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../cjson_error.hpp"
+#include "cjson_builder.hpp"
+#include "cjson_byte_reader.hpp"
+#include "cjson_parse_options.hpp"
+
+#define _MSGPACK_EXT_TYPE_KEY "type"
+#define _MSGPACK_EXT_DATA_KEY "data"
+
+namespace cjson::detail::input {
+    // builds a json value from one messagepack object. all integer and float formats become
+    // numbers, bin becomes a string holding the raw bytes and ext becomes an object
+    // {"type": <ext type>, "data": <raw bytes>}. the mapping is one way, see msgpack_encoder.
+    // arrays and maps are made by json_builder, so they get the representations the text parser
+    // gives them; of the parse_options only shared_shapes and shape_cache_size apply
+    template <typename JsonType>
+    class msgpack_parser {
+    public:
+        explicit msgpack_parser(const std::string_view bytes, const parse_options& options = {})
+            : reader_{bytes}, shared_shapes_{options.shared_shapes}, builder_{options.shape_cache_size} {}
+
+        msgpack_parser(const msgpack_parser&) noexcept = delete;
+        msgpack_parser(msgpack_parser&&) noexcept = default;
+
+        auto operator=(const msgpack_parser&) noexcept -> msgpack_parser& = delete;
+        auto operator=(msgpack_parser&&) noexcept -> msgpack_parser& = default;
+
+        ~msgpack_parser() noexcept = default;
+
+        auto parse() -> JsonType {
+            return parse_value(0);
+        }
+
+        // number of bytes consumed so far
+        auto position() const noexcept -> std::size_t {
+            return reader_.position();
+        }
+
+    private:
+        using number = typename JsonType::number;
+
+        auto parse_value(const std::size_t depth) -> JsonType {
+            if (depth > _MAX_BINARY_DEPTH) {
+                throw json_input_error(nesting_depth_error(reader_.position()));
+            }
+            const auto offset = reader_.position();
+            const auto byte = reader_.read_byte();
+            if (byte <= 0x7F) {
+                return JsonType{static_cast<number>(byte)};
+            } else if (byte <= 0x8F) {
+                return parse_map(byte & 0x0Fu, depth);
+            } else if (byte <= 0x9F) {
+                return parse_array(byte & 0x0Fu, depth);
+            } else if (byte <= 0xBF) {
+                return JsonType{typename JsonType::string{reader_.read_bytes(byte & 0x1Fu)}};
+            } else if (byte >= 0xE0) {
+                return JsonType{static_cast<number>(static_cast<std::int8_t>(byte))};
+            }
+            switch (byte) {
+                case 0xC0:
+                    return JsonType{nullptr};
+                case 0xC2:
+                    return JsonType{false};
+                case 0xC3:
+                    return JsonType{true};
+                case 0xC4:
+                case 0xD9:
+                    return JsonType{typename JsonType::string{reader_.read_bytes(reader_.read_byte())}};
+                case 0xC5:
+                case 0xDA:
+                    return JsonType{typename JsonType::string{reader_.read_bytes(read_length<std::uint16_t>())}};
+                case 0xC6:
+                case 0xDB:
+                    return JsonType{typename JsonType::string{reader_.read_bytes(read_length<std::uint32_t>())}};
+                case 0xC7:
+                    return parse_ext(reader_.read_byte());
+                case 0xC8:
+                    return parse_ext(read_length<std::uint16_t>());
+                case 0xC9:
+                    return parse_ext(read_length<std::uint32_t>());
+                case 0xCA:
+                    return JsonType{static_cast<number>(std::bit_cast<float>(reader_.read_big_endian<std::uint32_t>()))};
+                case 0xCB:
+                    return JsonType{static_cast<number>(std::bit_cast<double>(reader_.read_big_endian<std::uint64_t>()))};
+                case 0xCC:
+                    return JsonType{static_cast<number>(reader_.read_big_endian<std::uint8_t>())};
+                case 0xCD:
+                    return JsonType{static_cast<number>(reader_.read_big_endian<std::uint16_t>())};
+                case 0xCE:
+                    return JsonType{static_cast<number>(reader_.read_big_endian<std::uint32_t>())};
+                case 0xCF:
+                    return JsonType{static_cast<number>(reader_.read_big_endian<std::uint64_t>())};
+                case 0xD0:
+                    return JsonType{static_cast<number>(reader_.read_big_endian<std::int8_t>())};
+                case 0xD1:
+                    return JsonType{static_cast<number>(reader_.read_big_endian<std::int16_t>())};
+                case 0xD2:
+                    return JsonType{static_cast<number>(reader_.read_big_endian<std::int32_t>())};
+                case 0xD3:
+                    return JsonType{static_cast<number>(reader_.read_big_endian<std::int64_t>())};
+                case 0xD4:
+                    return parse_ext(1);
+                case 0xD5:
+                    return parse_ext(2);
+                case 0xD6:
+                    return parse_ext(4);
+                case 0xD7:
+                    return parse_ext(8);
+                case 0xD8:
+                    return parse_ext(16);
+                case 0xDC:
+                    return parse_array(read_length<std::uint16_t>(), depth);
+                case 0xDD:
+                    return parse_array(read_length<std::uint32_t>(), depth);
+                case 0xDE:
+                    return parse_map(read_length<std::uint16_t>(), depth);
+                case 0xDF:
+                    return parse_map(read_length<std::uint32_t>(), depth);
+                default:
+                    throw json_input_error(invalid_type_byte_error(byte, offset));
+            }
+        }
+
+        template <typename Length>
+        auto read_length() -> std::size_t {
+            return static_cast<std::size_t>(reader_.read_big_endian<Length>());
+        }
+
+        auto parse_array(const std::size_t size, const std::size_t depth) -> JsonType {
+            auto elements = typename json_builder<JsonType>::elements{.size_ = std::min(size, reader_.remaining())};
+            for (std::size_t i = 0; i < size; ++i) {
+                json_builder<JsonType>::add_element(elements, parse_value(depth + 1));
+            }
+            return json_builder<JsonType>::make_array(elements);
+        }
+
+        auto parse_map(const std::size_t size, const std::size_t depth) -> JsonType {
+            if (shared_shapes_) {
+                return parse_shaped_map(size, depth);
+            }
+            auto members = std::vector<typename json_builder<JsonType>::member>{};
+            members.reserve(std::min(size, reader_.remaining()));
+            for (std::size_t i = 0; i < size; ++i) {
+                auto key = typename JsonType::key{typename JsonType::string{parse_key()}};
+                members.emplace_back(std::move(key), parse_value(depth + 1));
+            }
+            return JsonType{json_builder<JsonType>::make_object(members)};
+        }
+
+        auto parse_shaped_map(const std::size_t size, const std::size_t depth) -> JsonType {
+            auto members = typename json_builder<JsonType>::shaped_members{};
+            members.values_.reserve(std::min(size, reader_.remaining()));
+            for (std::size_t i = 0; i < size; ++i) {
+                const auto key = parse_key();
+                if (not builder_.follow_shape(members, key)) {
+                    members.keys_.emplace_back(typename JsonType::string{key});
+                }
+                members.values_.push_back(parse_value(depth + 1));
+            }
+            return builder_.make_shaped(members);
+        }
+
+        // the bytes of the key, which stay in the input
+        auto parse_key() -> std::string_view {
+            const auto offset = reader_.position();
+            const auto byte = reader_.read_byte();
+            if (byte >= 0xA0 and byte <= 0xBF) {
+                return reader_.read_bytes(byte & 0x1Fu);
+            }
+            switch (byte) {
+                case 0xD9:
+                    return reader_.read_bytes(reader_.read_byte());
+                case 0xDA:
+                    return reader_.read_bytes(read_length<std::uint16_t>());
+                case 0xDB:
+                    return reader_.read_bytes(read_length<std::uint32_t>());
+                default:
+                    throw json_input_error(invalid_binary_key_error(offset));
+            }
+        }
+
+        auto parse_ext(const std::size_t size) -> JsonType {
+            const auto type = reader_.read_big_endian<std::int8_t>();
+            auto json_object = typename JsonType::object{};
+            json_object.emplace(_MSGPACK_EXT_TYPE_KEY, JsonType{static_cast<number>(type)});
+            json_object.emplace(_MSGPACK_EXT_DATA_KEY, JsonType{typename JsonType::string{reader_.read_bytes(size)}});
+            return JsonType{std::move(json_object)};
+        }
+
+        byte_reader reader_;
+        bool shared_shapes_;
+        json_builder<JsonType> builder_;
+    };
+}
+
+
+#endif
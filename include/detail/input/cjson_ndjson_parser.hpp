@@ -0,0 +1,138 @@
+#ifndef CJSON_NDJSON_PARSER_HPP
+#define CJSON_NDJSON_PARSER_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <concepts>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../cjson_error.hpp"
+#include "../cjson_simd.hpp"
+#include "../cjson_thread_pool.hpp"
+#include "cjson_parse_options.hpp"
+#include "cjson_parser.hpp"
+#include "cjson_reader.hpp"
+
+#define _NDJSON_BATCH_SIZE 65536
+#define _NDJSON_BATCHES_PER_THREAD 4
+
+namespace cjson::detail::input {
+    struct ndjson_options {
+        parse_options parse = {};
+        // lines are handed to the pool in batches of about this many bytes
+        std::size_t batch_size = _NDJSON_BATCH_SIZE;
+        // parsed batches that may wait for the callback, per pool thread; bounds memory use
+        std::size_t batches_per_thread = _NDJSON_BATCHES_PER_THREAD;
+    };
+
+    template <typename JsonType>
+    struct ndjson_line {
+        // zero-based, like the line numbers in position
+        std::size_t line_number;
+        JsonType value;
+        // set instead of value if the line is not valid json; its position is in the whole text
+        std::optional<json_input_error> error;
+    };
+
+    namespace ndjson {
+        template <typename JsonType>
+        struct batch {
+            std::vector<ndjson_line<JsonType>> lines;
+            std::size_t line_count;
+        };
+
+        // parses the lines of text, numbering them from zero; blank lines are skipped
+        template <typename JsonType>
+        auto parse_batch(const std::string_view text, const parse_options& options) -> batch<JsonType> {
+            auto result = batch<JsonType>{{}, 0};
+            for (std::size_t first = 0; first < text.size(); ++result.line_count) {
+                const auto length = simd::find_newline(text.data() + first, text.size() - first);
+                const auto line = text.substr(first, length);
+                first += length + 1;
+                if (std::all_of(line.begin(), line.end(), [](const char c) {
+                    return std::isspace(static_cast<unsigned char>(c));
+                })) {
+                    continue;
+                }
+                auto parser = json_parser<string_reader, JsonType>{options, std::string_view{line}};
+                auto parsed = parser.try_parse();
+                if (parsed and not parser.at_end()) {
+                    parsed = parse_result<JsonType>{parser.trailing_error()};
+                }
+                if (parsed) {
+                    result.lines.push_back({result.line_count, std::move(*parsed), std::nullopt});
+                } else {
+                    auto error = json_input_error(parsed.error().message(), parsed.error().pos_);
+                    error.pos_.line_start_ += result.line_count;
+                    error.pos_.line_end_ += result.line_count;
+                    result.lines.push_back({result.line_count, JsonType{}, std::move(error)});
+                }
+            }
+            return result;
+        }
+    }
+
+    // parses newline-delimited json on pool and calls callback(ndjson_line&&) on the calling
+    // thread for every non-blank line, in input order. a line that fails to parse is reported
+    // through ndjson_line::error and does not stop the rest. returns the number of lines
+    // delivered
+    template <typename JsonType, typename Callback>
+    requires std::invocable<Callback&, ndjson_line<JsonType>&&>
+    auto parse_ndjson(const std::string_view text, thread_pool& pool, Callback&& callback,
+        const ndjson_options& options = {}) -> std::size_t {
+        auto in_flight = std::deque<std::future<ndjson::batch<JsonType>>>{};
+        const auto max_in_flight = std::max<std::size_t>(1, pool.size() * options.batches_per_thread);
+        auto line_offset = std::size_t{0};
+        auto delivered = std::size_t{0};
+
+        // batches count their lines from zero and are renumbered here, in order
+        const auto deliver = [&] {
+            auto batch = in_flight.front().get();
+            in_flight.pop_front();
+            for (auto& line : batch.lines) {
+                line.line_number += line_offset;
+                if (line.error) {
+                    line.error->pos_.line_start_ += line_offset;
+                    line.error->pos_.line_end_ += line_offset;
+                }
+                callback(std::move(line));
+                ++delivered;
+            }
+            line_offset += batch.line_count;
+        };
+
+        try {
+            for (std::size_t first = 0; first < text.size();) {
+                auto last = std::min(text.size(), first + std::max<std::size_t>(options.batch_size, 1));
+                last += simd::find_newline(text.data() + last, text.size() - last);
+                last = std::min(text.size(), last + 1);
+                if (in_flight.size() == max_in_flight) {
+                    deliver();
+                }
+                in_flight.push_back(pool.submit([batch = text.substr(first, last - first), &options] {
+                    return ndjson::parse_batch<JsonType>(batch, options.parse);
+                }));
+                first = last;
+            }
+            while (not in_flight.empty()) {
+                deliver();
+            }
+        } catch (...) {
+            // the remaining tasks read text and options, so they finish before the error leaves
+            for (const auto& batch : in_flight) {
+                batch.wait();
+            }
+            throw;
+        }
+        return delivered;
+    }
+}
+
+
+#endif
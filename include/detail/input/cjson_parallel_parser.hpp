@@ -0,0 +1,306 @@
+#ifndef CJSON_PARALLEL_PARSER_HPP
+#define CJSON_PARALLEL_PARSER_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <future>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../cjson_error.hpp"
+#include "../cjson_simd.hpp"
+#include "../cjson_thread_pool.hpp"
+#include "cjson_parse_options.hpp"
+#include "cjson_parser.hpp"
+#include "cjson_reader.hpp"
+
+#define _PARALLEL_MIN_CHUNK_SIZE 65536
+#define _PARALLEL_CHUNKS_PER_THREAD 4
+
+namespace cjson::detail::input {
+    // reads a run of array elements as if it were a whole array, i.e. wrapped in brackets
+    class array_chunk_reader: json_reader {
+    public:
+        array_chunk_reader() noexcept = default;
+        array_chunk_reader(std::string_view&& elements) noexcept
+            : elements_{elements} {}
+
+        array_chunk_reader(array_chunk_reader&&) noexcept = default;
+
+        auto operator=(array_chunk_reader&&) noexcept -> array_chunk_reader& = default;
+
+        ~array_chunk_reader() noexcept override = default;
+
+        auto advance() noexcept -> char override {
+            if (pos_ == 0) {
+                ++pos_;
+                return _LEFT_BRACKET_TOK;
+            } else if (pos_ <= elements_.size()) {
+                return elements_[pos_++ - 1];
+            } else if (pos_ == elements_.size() + 1) {
+                ++pos_;
+                return _RIGHT_BRACKET_TOK;
+            }
+            return _CHAR_END;
+        }
+
+    private:
+        std::string_view elements_;
+        std::size_t pos_ = 0;
+    };
+
+    namespace parallel {
+        // byte offsets of the elements of one chunk: [first, last)
+        struct chunk {
+            std::size_t first;
+            std::size_t last;
+        };
+
+        // what scanning a segment of the array from a given string state found. depths are
+        // relative to the segment's start, so that commas[d] is the first comma at which the
+        // nesting is d levels below where the segment started, and closers[d] the first bracket
+        // or brace that closes d + 1 levels. npos where there is none
+        struct segment_scan {
+            std::ptrdiff_t depth = 0;
+            bool in_string = false;
+            std::vector<std::size_t> commas;
+            std::vector<std::size_t> closers;
+        };
+
+        // a segment scanned both as if it started outside a string and as if it started inside one
+        struct segment {
+            std::size_t first;
+            segment_scan outside;
+            segment_scan inside;
+        };
+
+        inline auto record(std::vector<std::size_t>& found, const std::size_t depth, const std::size_t i) -> void {
+            if (found.size() <= depth) {
+                found.resize(depth + 1, std::string_view::npos);
+            }
+            if (found[depth] == std::string_view::npos) {
+                found[depth] = i;
+            }
+        }
+
+        // scans text[first, last) for the bytes that change the nesting, skipping strings and,
+        // while nested, commas
+        inline auto scan_segment(const std::string_view text, const std::size_t first, const std::size_t last,
+            bool in_string) -> segment_scan {
+            auto scan = segment_scan{};
+            auto depth = std::ptrdiff_t{0};
+            auto i = first;
+            if (in_string) {
+                // an odd run of backslashes before the segment escapes its first byte
+                auto run = std::size_t{0};
+                while (run < first and text[first - run - 1] == _BACKSLASH) {
+                    ++run;
+                }
+                i += run % 2;
+            }
+            while (i < last) {
+                if (in_string) {
+                    i += simd::find_escape(text.data() + i, last - i, false);
+                    if (i < last and text[i] == _BACKSLASH) {
+                        ++i;
+                    } else if (i < last and text[i] == _QUOTE) {
+                        in_string = false;
+                    }
+                    ++i;
+                    continue;
+                }
+                i += simd::find_structural(text.data() + i, last - i, depth <= 0);
+                if (i == last) {
+                    break;
+                }
+                switch (text[i]) {
+                    case _QUOTE:
+                        in_string = true;
+                        break;
+                    case _LEFT_BRACE_TOK:
+                    case _LEFT_BRACKET_TOK:
+                        ++depth;
+                        break;
+                    case _RIGHT_BRACE_TOK:
+                    case _RIGHT_BRACKET_TOK:
+                        if (depth <= 0) {
+                            record(scan.closers, static_cast<std::size_t>(-depth), i);
+                        }
+                        --depth;
+                        break;
+                    default:
+                        record(scan.commas, static_cast<std::size_t>(-depth), i);
+                        break;
+                }
+                ++i;
+            }
+            scan.depth = depth;
+            scan.in_string = in_string;
+            return scan;
+        }
+
+        // splits the elements of the top-level array opening at text[open] into chunks of about
+        // target bytes, cutting only at top-level commas outside strings. segments of target
+        // bytes are scanned on pool, each from both string states, so that only the summaries
+        // are walked in order on the calling thread. returns no chunks if the array is not
+        // closed by a bracket, or if anything but whitespace follows it, so that the caller
+        // reports the error sequentially
+        inline auto split_array(const std::string_view text, const std::size_t open, const std::size_t target,
+            thread_pool& pool) -> std::vector<chunk> {
+            if (text.size() - open - 1 < 2 * target) {
+                return {};
+            }
+            auto scans = std::vector<std::future<segment>>{};
+            for (auto first = open + 1; first < text.size(); first += target) {
+                const auto last = std::min(first + target, text.size());
+                scans.push_back(pool.submit([text, first, last, start = first == open + 1] {
+                    auto outside = scan_segment(text, first, last, false);
+                    auto inside = start ? segment_scan{} : scan_segment(text, first, last, true);
+                    return segment{first, std::move(outside), std::move(inside)};
+                }));
+            }
+            // every task refers to text, so all of them finish before an exception propagates
+            for (const auto& scan : scans) {
+                scan.wait();
+            }
+
+            auto chunks = std::vector<chunk>{};
+            auto first = open + 1;
+            auto depth = std::size_t{0};
+            auto in_string = false;
+            for (auto& future : scans) {
+                const auto segment = future.get();
+                const auto& scan = in_string ? segment.inside : segment.outside;
+                const auto comma = depth < scan.commas.size() ? scan.commas[depth] : std::string_view::npos;
+                const auto closer = depth < scan.closers.size() ? scan.closers[depth] : std::string_view::npos;
+                if (comma < closer and segment.first != open + 1) {
+                    chunks.push_back({first, comma});
+                    first = comma + 1;
+                }
+                if (closer != std::string_view::npos) {
+                    const auto rest = text.substr(closer + 1);
+                    if (text[closer] != _RIGHT_BRACKET_TOK or not std::all_of(rest.begin(), rest.end(),
+                            [](const char c) { return std::isspace(static_cast<unsigned char>(c)); })) {
+                        return {};
+                    }
+                    chunks.push_back({first, closer});
+                    return chunks;
+                }
+                depth = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(depth) + scan.depth);
+                in_string = scan.in_string;
+            }
+            return {};
+        }
+
+        // the scanner's line and char numbers of text[offset], see json_scanner::accept
+        inline auto locate(const std::string_view text, const std::size_t offset) noexcept
+            -> std::pair<std::size_t, std::size_t> {
+            auto line_number = std::size_t{0};
+            auto char_number = std::size_t{0};
+            for (std::size_t i = 0; i < offset; ++i) {
+                if (text[i] == _NEWLINE) {
+                    ++line_number;
+                    char_number = 0;
+                } else if (text[i] == _TAB) {
+                    char_number += (_DEFAULT_TAB_WIDTH + 1) - (char_number % _DEFAULT_TAB_WIDTH);
+                }
+                ++char_number;
+            }
+            return {line_number, char_number};
+        }
+
+        // moves a position reported inside a chunk, whose first byte the chunk parser sees
+        // as char 1 of line 0, to the coordinates of the whole text
+        inline auto relocate(position& pos, const std::pair<std::size_t, std::size_t> start) noexcept -> void {
+            const auto shift = [&](std::size_t& line_number, std::size_t& char_number) {
+                if (line_number == 0) {
+                    char_number = char_number + start.second - 1;
+                }
+                line_number += start.first;
+            };
+            shift(pos.line_start_, pos.char_start_);
+            shift(pos.line_end_, pos.char_end_);
+        }
+    }
+
+    // parses text like json_parser, except that a top-level array is split into chunks that are
+    // parsed on pool and joined in order. other values and small arrays are parsed on the calling
+    // thread. errors are the ones the sequential parser reports, with positions in text
+    template <typename JsonType>
+    auto parse_parallel(const std::string_view text, thread_pool& pool, const parse_options& options = {})
+        -> JsonType {
+        const auto sequential = [&] {
+            return json_parser<string_reader, JsonType>{options, std::string_view{text}}.parse();
+        };
+        auto open = std::size_t{0};
+        while (open < text.size() and std::isspace(static_cast<unsigned char>(text[open]))) {
+            ++open;
+        }
+        if (open == text.size() or text[open] != _LEFT_BRACKET_TOK) {
+            return sequential();
+        }
+        const auto target = std::max<std::size_t>(_PARALLEL_MIN_CHUNK_SIZE,
+            text.size() / (pool.size() * _PARALLEL_CHUNKS_PER_THREAD));
+        const auto chunks = parallel::split_array(text, open, target, pool);
+        if (chunks.size() < 2) {
+            return sequential();
+        }
+
+        auto results = std::vector<std::future<JsonType>>{};
+        results.reserve(chunks.size());
+        for (const auto& chunk : chunks) {
+            results.push_back(pool.submit([&text, &options, chunk] {
+                try {
+                    return json_parser<array_chunk_reader, JsonType>{
+                        options, text.substr(chunk.first, chunk.last - chunk.first)}.parse();
+                } catch (json_input_error& error) {
+                    parallel::relocate(error.pos_, parallel::locate(text, chunk.first));
+                    throw;
+                }
+            }));
+        }
+        // every task refers to text, so all of them finish before the first error propagates
+        for (const auto& result : results) {
+            result.wait();
+        }
+
+        auto parts = std::vector<JsonType>{};
+        parts.reserve(results.size());
+        auto size = std::size_t{0};
+        auto numbers_only = true;
+        for (auto& result : results) {
+            parts.push_back(result.get());
+            size += parts.back().size();
+            numbers_only = numbers_only and parts.back().is_number_array();
+        }
+
+        if (numbers_only) {
+            auto numbers = typename JsonType::number_array{};
+            numbers.reserve(size);
+            for (const auto& part : parts) {
+                part.visit([&](const auto& value) {
+                    if constexpr (std::is_same_v<std::remove_cvref_t<decltype(value)>, typename JsonType::number_array>) {
+                        numbers.insert(numbers.end(), value.begin(), value.end());
+                    }
+                });
+            }
+            return JsonType{std::move(numbers)};
+        }
+        // elements are moved into the result in place; wrapping a finished array would copy it
+        auto joined = JsonType{typename JsonType::array{}};
+        auto& json_array = static_cast<typename JsonType::array&>(joined);
+        json_array.reserve(size);
+        for (auto& part : parts) {
+            auto& elements = static_cast<typename JsonType::array&>(part);
+            std::move(elements.begin(), elements.end(), std::back_inserter(json_array));
+        }
+        return joined;
+    }
+}
+
+
+#endif
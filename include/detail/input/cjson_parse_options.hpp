@@ -0,0 +1,46 @@
+#ifndef CJSON_PARSE_OPTIONS_HPP
+#define CJSON_PARSE_OPTIONS_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+#define _DEFAULT_SHAPE_CACHE_SIZE 8
+#define _DEFAULT_MAX_ERRORS 100
+
+namespace cjson::detail::input {
+    // how closely json_scanner::skip_value checks the value it skips
+    enum class skip_mode: unsigned short int {
+        // only strings and the nesting depth are followed, so any kind of bracket closes
+        BALANCED,
+        // closing brackets must also match their opening ones
+        MATCHED,
+        // every token is scanned as well, though the commas and colons between them are not
+        // checked
+        VALIDATED
+    };
+
+    struct parse_options {
+        // objects sharing a key sequence with a recently parsed object reuse its shape. a shaped
+        // object has no generic object behind it, so casting a const json holding one to const
+        // object& throws json_type_error. items() reads the members of any object in place, as
+        // do at, contains, visit and iteration; casting a non-const json to object& promotes it
+        // to a generic object first
+        bool shared_shapes = false;
+        std::size_t shape_cache_size = _DEFAULT_SHAPE_CACHE_SIZE;
+        // errors json_parser::parse_recovering collects before it gives up
+        std::size_t max_errors = _DEFAULT_MAX_ERRORS;
+        // when set, object members whose key it rejects are left out without being parsed:
+        // their values are skipped with json_scanner::skip_value. depth is 1 for the members of
+        // a top-level object and grows by one with each enclosing array or object
+        std::function<bool(std::string_view key, std::size_t depth)> member_filter = {};
+        skip_mode skip = skip_mode::MATCHED;
+        // arrays are reserved and large objects built from a sorted run, with element counts
+        // taken by a prepass over each top-level value, see json_scanner::count_elements. only
+        // readers that hold their input in one piece, such as string_reader, support it
+        bool presize = false;
+    };
+}
+
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef CJSON_PARSE_RESULT_HPP
+#define CJSON_PARSE_RESULT_HPP
+
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "../cjson_error.hpp"
+
+namespace cjson::detail::input {
+    // a parsed value or the parse_error that stopped it, in the manner of std::expected
+    template <typename T>
+    class parse_result {
+    public:
+        explicit parse_result(T&& value)
+            : result_{std::in_place_index<0>, std::move(value)} {}
+
+        explicit parse_result(parse_error&& error) noexcept
+            : result_{std::in_place_index<1>, std::move(error)} {}
+
+        parse_result(const parse_result&) = default;
+        parse_result(parse_result&&) noexcept = default;
+
+        auto operator=(const parse_result&) -> parse_result& = default;
+        auto operator=(parse_result&&) noexcept -> parse_result& = default;
+
+        ~parse_result() noexcept = default;
+
+        auto has_value() const noexcept -> bool {
+            return result_.index() == 0;
+        }
+
+        explicit operator bool() const noexcept {
+            return has_value();
+        }
+
+        // the value, or the json_input_error the throwing api would have raised
+        auto value() & -> T& {
+            check();
+            return std::get<0>(result_);
+        }
+
+        auto value() const& -> const T& {
+            check();
+            return std::get<0>(result_);
+        }
+
+        auto value() && -> T&& {
+            check();
+            return std::get<0>(std::move(result_));
+        }
+
+        auto operator*() & -> T& {
+            return std::get<0>(result_);
+        }
+
+        auto operator*() const& -> const T& {
+            return std::get<0>(result_);
+        }
+
+        auto operator->() -> T* {
+            return &std::get<0>(result_);
+        }
+
+        auto operator->() const -> const T* {
+            return &std::get<0>(result_);
+        }
+
+        auto error() const -> const parse_error& {
+            return std::get<1>(result_);
+        }
+
+    private:
+        auto check() const -> void {
+            if (not has_value()) {
+                throw json_input_error(error().message(), error().pos_);
+            }
+        }
+
+        std::variant<T, parse_error> result_;
+    };
+
+    template <typename T>
+    struct recovery_result {
+        // what could be read; malformed elements and members are left out
+        T value;
+        // in input order
+        std::vector<parse_error> errors;
+    };
+}
+
+
+#endif
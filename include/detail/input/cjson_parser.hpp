@@ -1,22 +1,44 @@
 #ifndef CJSON_PARSER_HPP
 #define CJSON_PARSER_HPP
 
+#include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <concepts>
 #include <exception>
 #include <memory>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "../cjson_error.hpp"
+#include "cjson_builder.hpp"
+#include "cjson_parse_options.hpp"
+#include "cjson_parse_result.hpp"
 #include "cjson_reader.hpp"
 #include "cjson_scanner.hpp"
 
+#define _PRESIZE_MIN_MEMBERS 16
+
 namespace cjson::detail::input {
     template <typename Reader, typename JsonType>
     class json_parser {
     public:
         template <typename ...Args>
-        explicit json_parser(Args&& ...args) noexcept
+        requires (not (std::same_as<std::remove_cvref_t<Args>, parse_options> or ...))
+        explicit json_parser(Args&& ...args)
+            : scanner_{std::make_unique<Reader>(std::forward<Args>(args)...)} {
+            prime();
+        }
+
+        template <typename ...Args>
+        explicit json_parser(const parse_options& options, Args&& ...args)
             : scanner_{std::make_unique<Reader>(std::forward<Args>(args)...)}
-            , current_token_{scanner_.get_token()} {}
+            , options_{options}
+            , builder_{options.shape_cache_size} {
+            prime();
+        }
 
         json_parser(const json_parser&) noexcept = delete;
         json_parser(json_parser&&) noexcept = default;
@@ -26,22 +48,170 @@ namespace cjson::detail::input {
 
         ~json_parser() noexcept = default;
 
+        // starts over on a new input. the scanner, its token buffer and the shape cache are
+        // kept, which saves their setup when parsing many small documents
+        template <typename ...Args>
+        auto reset(Args&& ...args) -> void {
+            scanner_.reset(std::forward<Args>(args)...);
+            error_.code_ = error_code::NONE;
+            prime();
+        }
+
+        // reads one value; on concatenated input each call reads the next one. once a value
+        // fails to parse, every later call reports the same error
         auto parse() -> JsonType {
-            return parse_json_value();
+            auto value = failed() ? JsonType{} : parse_json_value();
+            if (failed()) {
+                throw json_input_error(error_.message(), error_.pos_);
+            }
+            return value;
+        }
+
+        // like parse, but malformed input is returned as a parse_error instead of thrown
+        auto try_parse() -> parse_result<JsonType> {
+            auto value = failed() ? JsonType{} : parse_json_value();
+            if (failed()) {
+                return parse_result<JsonType>{parse_error{error_}};
+            }
+            return parse_result<JsonType>{std::move(value)};
+        }
+
+        // reads one value, carrying on past malformed elements and members: after an error the
+        // parser skips to the next comma or closing bracket of the enclosing array or object and
+        // resumes there, leaving the broken part out of the value. it gives up after
+        // parse_options::max_errors errors, or at an error outside any array or object, and
+        // then returns a null value
+        auto parse_recovering() -> recovery_result<JsonType> {
+            auto result = recovery_result<JsonType>{};
+            if (failed()) {
+                result.errors.push_back(error_);
+                return result;
+            }
+            recovering_ = true;
+            result.value = parse_json_value();
+            recovering_ = false;
+            result.errors = std::move(errors_);
+            errors_.clear();
+            // a token that could not be read stays the lookahead; the next call reports it
+            if (current_token_.tok_ == token::INVALID) {
+                error_ = result.errors.back();
+            }
+            return result;
+        }
+
+        // whether only whitespace is left after the values read so far
+        auto at_end() const noexcept -> bool {
+            return not failed() and current_token_.tok_ == token::END;
+        }
+
+        // for inputs that hold a single value: what to report when at_end() is false after it,
+        // which is the token that follows the value, or the error reading that token
+        auto trailing_error() const -> parse_error {
+            if (failed()) {
+                return error_;
+            }
+            return parse_error{error_code::TRAILING_CONTENT, scanner_.token_offset(), current_token_.pos_,
+                current_token_.spelling_};
         }
 
     private:
-        auto accept() -> void {
+        // all apis share the grammar below, which does not throw on malformed input: the first
+        // error is kept in error_, and every function returns as soon as it is set. when
+        // recovering, errors are also logged in errors_, and arrays and objects resume after
+        // them through recover()
+
+        auto failed() const noexcept -> bool {
+            return error_.code_ != error_code::NONE;
+        }
+
+        auto fail(const error_code code) -> JsonType {
+            // an unreadable token was logged when it was read, see prime
+            if (current_token_.tok_ == token::INVALID) {
+                error_ = errors_.back();
+            } else {
+                error_ = parse_error{code, scanner_.token_offset(), current_token_.pos_, current_token_.spelling_};
+                if (recovering_) {
+                    errors_.push_back(error_);
+                }
+            }
+            return JsonType{};
+        }
+
+        auto prime() -> void {
+            if (not scanner_.scan(current_token_)) {
+                scanner_failed();
+            }
+        }
+
+        auto scanner_failed() -> void {
+            if (recovering_) {
+                errors_.push_back(scanner_.error());
+                current_token_.tok_ = token::INVALID;
+            } else {
+                error_ = scanner_.error();
+            }
+        }
+
+        // after a failed element or member, skips to the next comma or closer at this depth and
+        // consumes it. a closer always ends the innermost open container, whatever its kind, so
+        // a stray or mismatched one never ends the containers around it and the input after it
+        // is still read. returns whether the container is still open; failed() stays set if
+        // parsing has to stop
+        auto recover() -> bool {
+            auto depth = std::size_t{0};
+            while (recovering_ and errors_.size() < options_.max_errors and current_token_.tok_ != token::END) {
+                const auto tok = current_token_.tok_;
+                if (depth == 0 and (tok == token::COMMA or tok == token::RIGHT_BRACE or tok == token::RIGHT_BRACKET)) {
+                    error_.code_ = error_code::NONE;
+                    accept();
+                    return tok == token::COMMA;
+                }
+                if (tok == token::LEFT_BRACE or tok == token::LEFT_BRACKET) {
+                    ++depth;
+                } else if (tok == token::RIGHT_BRACE or tok == token::RIGHT_BRACKET) {
+                    --depth;
+                }
+                accept();
+            }
+            return false;
+        }
+
+        // after an element or member: true if another one follows, false if the container is
+        // closed or the separator is wrong
+        auto next_element(const token closer, const error_code code) -> bool {
+            if (current_token_.tok_ == closer) {
+                accept();
+                return false;
+            } else if (current_token_.tok_ != token::COMMA) {
+                fail(code);
+                return false;
+            }
+            return accept();
+        }
+
+        auto accept() -> bool {
             if (current_token_.tok_ != token::END) {
-                current_token_ = scanner_.get_token();
+                prime();
             }
+            return not failed();
         }
 
         auto parse_json_value() -> JsonType {
+            if (options_.presize and depth_ == 0
+                and (current_token_.tok_ == token::LEFT_BRACE or current_token_.tok_ == token::LEFT_BRACKET)) {
+                scanner_.count_elements(sizes_);
+                next_size_ = 0;
+            }
             if (current_token_.tok_ == token::LEFT_BRACE) {
-                return JsonType{parse_json_object()};
+                ++depth_;
+                auto json_object = parse_json_object();
+                --depth_;
+                return json_object;
             } else if (current_token_.tok_ == token::LEFT_BRACKET) {
-                return JsonType{parse_json_array()};
+                ++depth_;
+                auto json_array = parse_json_array();
+                --depth_;
+                return json_array;
             } else if (current_token_.tok_ == token::NUMBER) {
                 return JsonType{parse_json_number()};
             } else if (current_token_.tok_ == token::TRUE or current_token_.tok_ == token::FALSE) {
@@ -51,54 +221,225 @@ namespace cjson::detail::input {
             } else if (current_token_.tok_ == token::NULL_VALUE) {
                 return JsonType{parse_json_null()};
             } else {
-                throw json_input_error(invalid_json_value_error(current_token_.spelling_));
+                return fail(error_code::INVALID_JSON_VALUE);
             }
         }
 
-        auto parse_json_object() -> typename JsonType::object {
+        auto parse_json_object() -> JsonType {
+            if (options_.shared_shapes and not recovering_) {
+                return parse_json_shaped_object();
+            }
+            const auto size = presized();
+            if (size >= _PRESIZE_MIN_MEMBERS) {
+                auto members = std::vector<member>{};
+                members.reserve(size);
+                if (not parse_json_members(members)) {
+                    return {};
+                }
+                return JsonType{json_builder<JsonType>::make_object(members)};
+            }
             auto json_object = typename JsonType::object{};
-            accept();
+            if (not parse_json_members(json_object)) {
+                return {};
+            }
+            return JsonType{std::move(json_object)};
+        }
+
+        using member = typename json_builder<JsonType>::member;
+
+        // reads the members of an object into an object or, to build one later, a vector of them
+        template <typename Members>
+        auto parse_json_members(Members& members) -> bool {
+            if (not accept()) {
+                return false;
+            }
+            while (true) {
+                if (failed()) {
+                    if (recover()) {
+                        continue;
+                    } else if (failed()) {
+                        return false;
+                    }
+                    break;
+                }
+                parse_json_member(members);
+                if (not failed() and not next_element(token::RIGHT_BRACE, error_code::INVALID_OBJECT)
+                    and not failed()) {
+                    break;
+                }
+            }
+            return true;
+        }
+
+        static auto add_member(typename JsonType::object& json_object, typename JsonType::key&& key, JsonType&& value)
+            -> void {
+            json_object.emplace(std::move(key), std::move(value));
+        }
+
+        static auto add_member(std::vector<member>& members, typename JsonType::key&& key, JsonType&& value) -> void {
+            members.emplace_back(std::move(key), std::move(value));
+        }
+
+        // the prepass count of the container opening at the current token, or 0 if there is none
+        auto presized() noexcept -> std::size_t {
+            const auto offset = scanner_.token_offset();
+            while (next_size_ < sizes_.size() and sizes_[next_size_].offset_ < offset) {
+                ++next_size_;
+            }
+            return next_size_ < sizes_.size() and sizes_[next_size_].offset_ == offset ? sizes_[next_size_].count_ : 0;
+        }
+
+        // a member is only added once its key, colon and value have all been read
+        template <typename Members>
+        auto parse_json_member(Members& members) -> void {
+            if (current_token_.tok_ != token::STRING) {
+                fail(error_code::INVALID_KEY);
+                return;
+            } else if (skipped()) {
+                skip_member();
+                return;
+            }
+            auto key = parse_json_string();
+            if (failed()) {
+                return;
+            }
+            if (current_token_.tok_ != token::COLON) {
+                fail(error_code::INVALID_COLON);
+                return;
+            }
+            if (not accept()) {
+                return;
+            }
+            auto value = parse_json_value();
+            if (not failed()) {
+                add_member(members, std::move(key), std::move(value));
+            }
+        }
+
+        // whether parse_options::member_filter rejects the member whose key is the current token
+        auto skipped() const -> bool {
+            return options_.member_filter and not options_.member_filter(current_token_.spelling_, depth_);
+        }
+
+        // passes over a rejected member. its value is skipped by the scanner, which is then just
+        // past the colon, so the colon is checked but not accepted
+        auto skip_member() -> void {
+            if (not accept()) {
+                return;
+            }
+            if (current_token_.tok_ != token::COLON) {
+                fail(error_code::INVALID_COLON);
+                return;
+            }
+            if (not scanner_.skip_value(options_.skip)) {
+                scanner_failed();
+                return;
+            }
+            prime();
+        }
+
+        auto parse_json_shaped_object() -> JsonType {
+            auto members = typename json_builder<JsonType>::shaped_members{};
+            members.values_.reserve(presized());
+            if (not accept()) {
+                return {};
+            }
             while (true) {
                 if (current_token_.tok_ != token::STRING) {
-                    throw json_input_error(invalid_key_error(current_token_.spelling_));
+                    return fail(error_code::INVALID_KEY);
                 }
-                const auto key = parse_json_string();
-                if (current_token_.tok_ != token::COLON) {
-                    throw json_input_error(invalid_colon_error(current_token_.spelling_));
+                if (skipped()) {
+                    skip_member();
+                    if (failed()) {
+                        return {};
+                    }
+                } else {
+                    if (builder_.follow_shape(members, current_token_.spelling_)) {
+                        if (not accept()) {
+                            return {};
+                        }
+                    } else {
+                        members.keys_.emplace_back(parse_json_string());
+                        if (failed()) {
+                            return {};
+                        }
+                    }
+                    if (current_token_.tok_ != token::COLON) {
+                        return fail(error_code::INVALID_COLON);
+                    }
+                    if (not accept()) {
+                        return {};
+                    }
+                    members.values_.emplace_back(parse_json_value());
+                    if (failed()) {
+                        return {};
+                    }
                 }
-                accept();
-                json_object.emplace(key, parse_json_value());
                 if (current_token_.tok_ == token::RIGHT_BRACE) {
-                    accept();
+                    if (not accept()) {
+                        return {};
+                    }
                     break;
                 } else if (current_token_.tok_ != token::COMMA) {
-                    throw json_input_error(invalid_object_error(current_token_.spelling_));
+                    return fail(error_code::INVALID_OBJECT);
+                }
+                if (not accept()) {
+                    return {};
                 }
-                accept();
             }
-            return json_object;
+            return builder_.make_shaped(members);
         }
 
-        auto parse_json_array() -> typename JsonType::array {
-            auto json_array = typename JsonType::array{};
-            accept();
+        auto parse_json_array() -> JsonType {
+            auto elements = typename json_builder<JsonType>::elements{.size_ = presized()};
+            if (not accept()) {
+                return {};
+            }
+            while (current_token_.tok_ == token::NUMBER) {
+                const auto json_number = parse_json_number();
+                if (failed()) {
+                    break;
+                }
+                json_builder<JsonType>::add_number(elements, json_number);
+                if (not next_element(token::RIGHT_BRACKET, error_code::INVALID_ARRAY)) {
+                    if (not failed()) {
+                        return json_builder<JsonType>::make_array(elements);
+                    }
+                    break;
+                }
+            }
+
+            json_builder<JsonType>::make_generic(elements);
             while (true) {
-                json_array.emplace_back(parse_json_value());
-                if (current_token_.tok_ == token::RIGHT_BRACKET) {
-                    accept();
+                if (failed()) {
+                    if (recover()) {
+                        continue;
+                    } else if (failed()) {
+                        return {};
+                    }
                     break;
-                } else if (current_token_.tok_ != token::COMMA) {
-                    throw json_input_error(invalid_array_error(current_token_.spelling_));
                 }
-                accept();
+                auto value = parse_json_value();
+                if (not failed()) {
+                    json_builder<JsonType>::add_element(elements, std::move(value));
+                    if (not next_element(token::RIGHT_BRACKET, error_code::INVALID_ARRAY) and not failed()) {
+                        break;
+                    }
+                }
             }
-            return json_array;
+            return json_builder<JsonType>::make_array(elements);
         }
 
         auto parse_json_number() -> typename JsonType::number {
-            const auto& json_number = typename JsonType::number{std::stod(current_token_.spelling_)};
+            const auto& spelling = current_token_.spelling_;
+            auto json_number = double{};
+            const auto [end, ec] = std::from_chars(spelling.data(), spelling.data() + spelling.size(), json_number);
+            if (ec != std::errc{}) {
+                fail(error_code::NUMBER_OUT_OF_RANGE);
+                return {};
+            }
             accept();
-            return json_number;
+            return typename JsonType::number(json_number);
         }
 
         auto parse_json_boolean() -> typename JsonType::boolean {
@@ -108,7 +449,7 @@ namespace cjson::detail::input {
         }
 
         auto parse_json_string() -> typename JsonType::string {
-            const auto& json_string = typename JsonType::string{current_token_.spelling_};
+            auto json_string = typename JsonType::string{current_token_.spelling_};
             accept();
             return json_string;
         }
@@ -120,6 +461,17 @@ namespace cjson::detail::input {
 
         json_scanner<Reader> scanner_;
         json_token current_token_;
+        parse_options options_;
+        json_builder<JsonType> builder_{options_.shape_cache_size};
+        parse_error error_;
+        bool recovering_ = false;
+        std::vector<parse_error> errors_;
+        // arrays and objects open around the current token, see parse_options::member_filter
+        std::size_t depth_ = 0;
+        // element counts from the prepass, see parse_options::presize, and the first one that
+        // may still be looked up
+        std::vector<container_size> sizes_;
+        std::size_t next_size_ = 0;
     };
 }
 
@@ -34,10 +34,10 @@ namespace cjson::detail::input {
 
         friend auto operator==(const position& pos1, const position& pos2) noexcept -> bool = default;
 
-        std::size_t line_start_;
-        std::size_t char_start_;
-        std::size_t line_end_;
-        std::size_t char_end_;
+        std::size_t line_start_ = 0;
+        std::size_t char_start_ = 0;
+        std::size_t line_end_ = 0;
+        std::size_t char_end_ = 0;
     };
 }
 
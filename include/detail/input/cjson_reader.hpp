@@ -1,6 +1,7 @@
 #ifndef CJSON_READER_HPP
 #define CJSON_READER_HPP
 
+#include <cstddef>
 #include <string_view>
 
 #define _CHAR_END '\0'
@@ -26,6 +27,10 @@ namespace cjson::detail::input {
         string_reader(std::string_view&& str) noexcept
             : str_{str}, cur_{str.begin()} {}
 
+        string_reader(string_reader&&) noexcept = default;
+
+        auto operator=(string_reader&&) noexcept -> string_reader& = default;
+
         ~string_reader() noexcept override = default;
 
         auto advance() noexcept -> char override {
@@ -36,6 +41,15 @@ namespace cjson::detail::input {
             }
         }
 
+        // the input not read yet, which scanners can search in bulk before skipping over it
+        auto remaining() const noexcept -> std::string_view {
+            return {cur_, str_.end()};
+        }
+
+        auto skip(const std::size_t count) noexcept -> void {
+            cur_ += static_cast<std::ptrdiff_t>(count);
+        }
+
     private:
         std::string_view str_;
         std::string_view::const_iterator cur_;
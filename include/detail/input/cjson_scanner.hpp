@@ -4,9 +4,14 @@
 #include <cctype>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "../cjson_error.hpp"
+#include "../cjson_simd.hpp"
+#include "cjson_parse_options.hpp"
 #include "cjson_reader.hpp"
 #include "cjson_token.hpp"
 
@@ -36,6 +41,12 @@
 #define _FALSE_TOK "false"
 
 namespace cjson::detail::input {
+    // the number of elements or members of the array or object opening at byte offset_
+    struct container_size {
+        std::size_t offset_;
+        std::size_t count_;
+    };
+
     template <typename Reader>
     class json_scanner {
     public:
@@ -59,30 +70,169 @@ namespace cjson::detail::input {
 
         ~json_scanner() noexcept = default;
 
+        // starts over on a new input, keeping the reader's allocation
+        template <typename ...Args>
+        auto reset(Args&& ...args) -> void {
+            *reader_ = Reader(std::forward<Args>(args)...);
+            current_char_ = reader_->advance();
+            line_number_ = 0;
+            char_number_ = 0;
+            offset_ = 0;
+        }
+
+        // takes the current character from the reader again, for a reader that has reported the
+        // end of its input before more of it arrived
+        auto reread() noexcept -> void {
+            current_char_ = reader_->advance();
+        }
+
         auto get_token() -> json_token {
-            auto spelling = std::string{};
-            auto pos = position{};
+            auto current = json_token{};
+            get_token(current);
+            return current;
+        }
+
+        // reads the next token into current, reusing the buffer of its spelling
+        auto get_token(json_token& current) -> void {
+            if (not scan(current)) {
+                throw json_input_error(error_.message(), error_.pos_);
+            }
+        }
+
+        // reads the next token into current like get_token, but reports a malformed token by
+        // returning false and leaving the details in error()
+        auto scan(json_token& current) -> bool {
+            auto& spelling = current.spelling_;
+            auto& pos = current.pos_;
             auto tok = token{};
+            spelling.clear();
             skip_spaces();
 
             pos.start(line_number_, char_number_);
-            try {
-                tok = next_token(spelling, tok);
-                pos.end(line_number_, char_number_);
-                return json_token(tok, std::move(spelling), std::move(pos));
-            } catch (json_input_error& error) {
-                pos.end(line_number_, char_number_);
-                error.pos_ = std::move(pos);
+            token_offset_ = offset_;
+            const auto scanned = next_token(spelling, tok);
+            pos.end(line_number_, char_number_);
+            if (not scanned) {
+                error_.offset_ = token_offset_;
+                error_.pos_ = pos;
+                // the rest of the token is skipped so that scanning can go on after it
                 if (tok == token::STRING) {
                     while (current_char_ != _NULL_TERMINATOR and current_char_ != _QUOTE) {
                         accept();
                     }
                     accept();
+                } else if (offset_ == token_offset_) {
+                    accept();
+                }
+                return false;
+            }
+            current.tok_ = tok;
+            return true;
+        }
+
+        // passes over the next value without reading it into a token, e.g. an object member
+        // nobody asked for: an array or object is skipped up to and including its closing
+        // bracket. mode sets how much of the value is checked on the way. unless it is
+        // VALIDATED, strings and brackets are found with simd when the reader holds its input
+        // in one piece, as string_reader does. like scan, it reports malformed input by
+        // returning false and leaving the details in error()
+        auto skip_value(const skip_mode mode = skip_mode::MATCHED) -> bool {
+            skip_spaces();
+            if (mode == skip_mode::VALIDATED) {
+                return skip_tokens();
+            }
+            switch (current_char_) {
+                case _NULL_TERMINATOR:
+                    return fail_skip(error_code::TRUNCATED_INPUT, std::string{});
+                case _COMMA_TOK:
+                case _COLON_TOK:
+                case _RIGHT_BRACE_TOK:
+                case _RIGHT_BRACKET_TOK:
+                    return fail_skip(error_code::INVALID_JSON_VALUE, std::string(1, current_char_));
+                case _QUOTE:
+                case _LEFT_BRACE_TOK:
+                case _LEFT_BRACKET_TOK:
+                    break;
+                default:
+                    // a number or literal runs up to the next space or delimiter
+                    while (current_char_ != _NULL_TERMINATOR and not std::isspace(current_char_)
+                        and current_char_ != _COMMA_TOK and current_char_ != _COLON_TOK
+                        and current_char_ != _RIGHT_BRACE_TOK and current_char_ != _RIGHT_BRACKET_TOK) {
+                        accept();
+                    }
+                    return true;
+            }
+            closers_.clear();
+            if constexpr (requires (Reader& reader) { reader.remaining(); reader.skip(std::size_t{}); }) {
+                return skip_contiguous(mode == skip_mode::MATCHED);
+            } else {
+                return skip_nested(mode == skip_mode::MATCHED);
+            }
+        }
+
+        // a prepass for presizing containers: counts the elements of the array or object whose
+        // opening bracket was scanned last, and of every one nested in it, without moving the
+        // scanner. the counts are filed by the byte offsets of the opening brackets, in input
+        // order; malformed input only makes them inexact. only readers that hold their input in
+        // one piece are supported, and false is returned for the others
+        auto count_elements(std::vector<container_size>& sizes) -> bool {
+            sizes.clear();
+            if constexpr (requires (Reader& reader) { reader.remaining(); }) {
+                const auto remaining = reader_->remaining();
+                // the current character is the last one the reader handed out
+                const auto text = current_char_ == _NULL_TERMINATOR ? std::string_view{}
+                    : std::string_view{remaining.data() - 1, remaining.size() + 1};
+                // a container opening just before text[first] has no elements if a closer
+                // follows, and one plus a comma count otherwise
+                const auto open = [&](const std::size_t offset, std::size_t first) {
+                    while (first < text.size() and std::isspace(static_cast<unsigned char>(text[first]))) {
+                        ++first;
+                    }
+                    const auto empty = first < text.size()
+                        and (text[first] == _RIGHT_BRACE_TOK or text[first] == _RIGHT_BRACKET_TOK);
+                    open_.push_back(sizes.size());
+                    sizes.push_back({offset, empty ? std::size_t{0} : std::size_t{1}});
+                };
+                open_.clear();
+                open(token_offset_, 0);
+                // an unclosed string ends the prepass with i past the end
+                for (auto i = std::size_t{0}; not open_.empty() and i < text.size(); ++i) {
+                    i += simd::find_structural(text.data() + i, text.size() - i, true);
+                    if (i == text.size()) {
+                        break;
+                    }
+                    switch (text[i]) {
+                        case _QUOTE:
+                            i = string_end(text, i);
+                            break;
+                        case _LEFT_BRACE_TOK:
+                        case _LEFT_BRACKET_TOK:
+                            open(offset_ + i, i + 1);
+                            break;
+                        case _RIGHT_BRACE_TOK:
+                        case _RIGHT_BRACKET_TOK:
+                            open_.pop_back();
+                            break;
+                        default:
+                            ++sizes[open_.back()].count_;
+                            break;
+                    }
                 }
-                throw error;
+                return true;
+            } else {
+                return false;
             }
         }
 
+        // byte offset of the token read last
+        auto token_offset() const noexcept -> std::size_t {
+            return token_offset_;
+        }
+
+        auto error() const noexcept -> const parse_error& {
+            return error_;
+        }
+
     private:
         inline static const std::unordered_set<char> hex_digits = {
             '0', '1', '2', '3', '4', '5', '6',
@@ -99,6 +249,7 @@ namespace cjson::detail::input {
             }
             current_char_ = reader_->advance();
             ++char_number_;
+            ++offset_;
         }
 
         auto skip_spaces() noexcept -> void {
@@ -107,7 +258,17 @@ namespace cjson::detail::input {
             }
         }
 
-        auto next_token(std::string& spelling, token& tok) -> token {
+        auto fail(const error_code code, std::string&& reason) -> bool {
+            error_.code_ = code;
+            error_.reason_ = std::move(reason);
+            return false;
+        }
+
+        auto fail(const error_code code, const char reason) -> bool {
+            return fail(code, std::string(1, reason));
+        }
+
+        auto next_token(std::string& spelling, token& tok) -> bool {
             switch (current_char_) {
                 case _NULL_TERMINATOR:
                     break;
@@ -144,7 +305,9 @@ namespace cjson::detail::input {
                 case _QUOTE:
                     accept();
                     tok = token::STRING;
-                    scan_string(spelling);
+                    if (not scan_string(spelling)) {
+                        return false;
+                    }
                     accept();
                     break;
                 default:
@@ -158,24 +321,208 @@ namespace cjson::detail::input {
                             tok = token::NULL_VALUE;
                         }
                     } else {
-                        scan_number(spelling);
+                        if (not scan_number(spelling)) {
+                            return false;
+                        }
                         if (not spelling.empty()) {
                             tok = token::NUMBER;
                         }
                     }
 
                     if (tok == token::END) {
-                        throw json_input_error(invalid_character_error(spelling.front()));
+                        return fail(error_code::INVALID_CHARACTER, spelling.empty() ? current_char_ : spelling.front());
                     }
                     break;
             };
-            return tok;
+            return true;
+        }
+
+        // skip_value errors point at the character where skipping stopped
+        auto fail_skip(const error_code code, std::string&& reason) -> bool {
+            error_.offset_ = offset_;
+            error_.pos_.start(line_number_, char_number_);
+            return fail(code, std::move(reason));
+        }
+
+        // pops the innermost open bracket at a closing one, which has to be of the same kind if
+        // matched is set
+        auto close_nested(const char closer, const bool matched) -> bool {
+            if (matched and closer != closers_.back()) {
+                return fail_skip(closers_.back() == _RIGHT_BRACE_TOK ? error_code::INVALID_OBJECT
+                    : error_code::INVALID_ARRAY, std::string(1, closer));
+            }
+            closers_.pop_back();
+            return true;
+        }
+
+        // skips the string or bracketed value at the current character one character at a time
+        auto skip_nested(const bool matched) -> bool {
+            do {
+                switch (current_char_) {
+                    case _NULL_TERMINATOR:
+                        return fail_skip(error_code::TRUNCATED_INPUT, std::string{});
+                    case _QUOTE:
+                        accept();
+                        while (current_char_ != _QUOTE) {
+                            if (current_char_ == _NULL_TERMINATOR) {
+                                return fail_skip(error_code::UNTERMINATED_STRING, std::string{});
+                            } else if (current_char_ == _BACKSLASH) {
+                                accept();
+                                if (current_char_ == _NULL_TERMINATOR) {
+                                    continue;
+                                }
+                            }
+                            accept();
+                        }
+                        accept();
+                        break;
+                    case _LEFT_BRACE_TOK:
+                        closers_.push_back(_RIGHT_BRACE_TOK);
+                        accept();
+                        break;
+                    case _LEFT_BRACKET_TOK:
+                        closers_.push_back(_RIGHT_BRACKET_TOK);
+                        accept();
+                        break;
+                    case _RIGHT_BRACE_TOK:
+                    case _RIGHT_BRACKET_TOK:
+                        if (not close_nested(current_char_, matched)) {
+                            return false;
+                        }
+                        accept();
+                        break;
+                    default:
+                        accept();
+                        break;
+                }
+            } while (not closers_.empty());
+            return true;
+        }
+
+        // skips like skip_nested, but searches the reader's remaining input for the next quote or
+        // bracket and accepts everything before it at once
+        auto skip_contiguous(const bool matched) -> bool {
+            // the current character is the last one the reader handed out
+            const auto remaining = reader_->remaining();
+            const auto text = std::string_view{remaining.data() - 1, remaining.size() + 1};
+            auto i = std::size_t{0};
+            do {
+                i += simd::find_structural(text.data() + i, text.size() - i, false);
+                if (i == text.size()) {
+                    accept_bulk(text, i);
+                    return fail_skip(error_code::TRUNCATED_INPUT, std::string{});
+                }
+                const auto c = text[i];
+                if (c == _QUOTE) {
+                    const auto first = i;
+                    i = string_end(text, i);
+                    if (i >= text.size()) {
+                        accept_bulk(text, text.size());
+                        return fail_skip(error_code::UNTERMINATED_STRING, std::string{text.substr(first + 1)});
+                    }
+                } else if (c == _LEFT_BRACE_TOK or c == _LEFT_BRACKET_TOK) {
+                    // '}' and ']' follow their opening brackets two places on in ascii
+                    closers_.push_back(static_cast<char>(c + 2));
+                } else if (matched and c != closers_.back()) {
+                    accept_bulk(text, i);
+                    return close_nested(c, matched);
+                } else {
+                    closers_.pop_back();
+                }
+                ++i;
+            } while (not closers_.empty());
+            accept_bulk(text, i);
+            return true;
+        }
+
+        // the index of the quote closing the string that opens at text[first], or text.size() or
+        // beyond if it is not closed
+        static auto string_end(const std::string_view text, std::size_t first) noexcept -> std::size_t {
+            for (++first; first < text.size() and text[first] != _QUOTE; ) {
+                first += simd::find_escape(text.data() + first, text.size() - first, false);
+                if (first < text.size() and text[first] != _QUOTE) {
+                    first += text[first] == _BACKSLASH ? std::size_t{2} : std::size_t{1};
+                }
+            }
+            return first;
+        }
+
+        // accepts the first count characters of text, which starts at the current character, as
+        // count calls to accept would
+        auto accept_bulk(const std::string_view text, const std::size_t count) noexcept -> void {
+            if (count == 0) {
+                return;
+            }
+            auto line = text.substr(0, count);
+            const auto newlines = simd::count(line.data(), line.size(), _NEWLINE);
+            if (newlines > 0) {
+                line_number_ += newlines;
+                line = line.substr(line.rfind(_NEWLINE) + 1);
+                char_number_ = 1;
+            }
+            if (simd::count(line.data(), line.size(), _TAB) == 0) {
+                char_number_ += line.size();
+            } else {
+                for (const auto c : line) {
+                    if (c == _TAB) {
+                        char_number_ += (tab_width_ + 1) - (char_number_ % tab_width_);
+                    }
+                    ++char_number_;
+                }
+            }
+            offset_ += count;
+            reader_->skip(count - 1);
+            current_char_ = reader_->advance();
+        }
+
+        // skips a value token by token, checking each one as scan does
+        auto skip_tokens() -> bool {
+            const auto fail_token = [this](const error_code code) {
+                error_.offset_ = token_offset_;
+                error_.pos_ = skipped_.pos_;
+                return fail(code, std::string{skipped_.spelling_});
+            };
+            closers_.clear();
+            do {
+                if (not scan(skipped_)) {
+                    return false;
+                }
+                switch (skipped_.tok_) {
+                    case token::END:
+                        return fail_skip(error_code::TRUNCATED_INPUT, std::string{});
+                    case token::LEFT_BRACE:
+                        closers_.push_back(_RIGHT_BRACE_TOK);
+                        break;
+                    case token::LEFT_BRACKET:
+                        closers_.push_back(_RIGHT_BRACKET_TOK);
+                        break;
+                    case token::RIGHT_BRACE:
+                    case token::RIGHT_BRACKET:
+                        if (closers_.empty()) {
+                            return fail_token(error_code::INVALID_JSON_VALUE);
+                        } else if (closers_.back() != skipped_.spelling_.front()) {
+                            return fail_token(closers_.back() == _RIGHT_BRACE_TOK ? error_code::INVALID_OBJECT
+                                : error_code::INVALID_ARRAY);
+                        }
+                        closers_.pop_back();
+                        break;
+                    case token::COMMA:
+                    case token::COLON:
+                        if (closers_.empty()) {
+                            return fail_token(error_code::INVALID_JSON_VALUE);
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            } while (not closers_.empty());
+            return true;
         }
 
-        auto scan_string(std::string& spelling) -> void {
+        auto scan_string(std::string& spelling) -> bool {
             while (current_char_ != _QUOTE) {
                 if (current_char_ == _NULL_TERMINATOR) {
-                    throw json_input_error(unterminated_string_error(spelling));
+                    return fail(error_code::UNTERMINATED_STRING, std::string{spelling});
                 } else if (current_char_ == _BACKSLASH) {
                     accept();
                     if (current_char_ == 'b') {
@@ -199,7 +546,7 @@ namespace cjson::detail::input {
                             }
                         }
                         if (error) {
-                            throw json_input_error(invalid_unicode_escape_error(hex_str));
+                            return fail(error_code::INVALID_UNICODE_ESCAPE, std::move(hex_str));
                         }
                         spelling.append(1, static_cast<char>(std::stoi(hex_str, nullptr, 16)));
                     } else if (current_char_ == '"') {
@@ -209,21 +556,22 @@ namespace cjson::detail::input {
                     } else if (current_char_ == '\\') {
                         spelling.append(1, _BACKSLASH);
                     } else {
-                        throw json_input_error(illegal_escape_error(current_char_));
+                        return fail(error_code::ILLEGAL_ESCAPE, current_char_);
                     }
                 } else {
                     spelling.append(1, current_char_);
                 }
                 accept();
             }
+            return true;
         }
 
-        auto scan_number(std::string& spelling) -> void {
+        auto scan_number(std::string& spelling) -> bool {
             if (current_char_ == _MINUS) {
                 spelling.append(1, _MINUS);
                 accept();
                 if (not std::isdigit(current_char_)) {
-                    throw json_input_error(invalid_minus_error(current_char_));
+                    return fail(error_code::INVALID_MINUS, current_char_);
                 }
             }
 
@@ -239,7 +587,7 @@ namespace cjson::detail::input {
                     spelling.append(1, _DECIMAL_POINT);
                     accept();
                     if (not std::isdigit(current_char_)) {
-                        throw json_input_error(invalid_fraction_error(current_char_));
+                        return fail(error_code::INVALID_FRACTION, current_char_);
                     }
                     scan_digits(spelling);
                 }
@@ -252,15 +600,16 @@ namespace cjson::detail::input {
                     if (not (std::isdigit(prev_char) or ((prev_char == _PLUS or prev_char == _MINUS)
                         and std::isdigit(current_char_)))) {
                         if ((prev_char == _PLUS or prev_char == _MINUS)) {
-                            throw json_input_error(invalid_exponent_error(current_char_, true));
+                            return fail(error_code::INVALID_EXPONENT_SIGN, current_char_);
                         } else {
-                            throw json_input_error(invalid_exponent_error(prev_char, false));
+                            return fail(error_code::INVALID_EXPONENT, prev_char);
                         }
                     }
                     spelling.append(1, prev_char);
                     scan_digits(spelling);
                 }
             }
+            return true;
         }
 
         auto scan_digits(std::string& spelling) -> void {
@@ -282,6 +631,14 @@ namespace cjson::detail::input {
         std::size_t line_number_;
         std::size_t char_number_;
         std::size_t tab_width_;
+        std::size_t offset_ = 0;
+        std::size_t token_offset_ = 0;
+        parse_error error_;
+        // the closing brackets skip_value expects, innermost last
+        std::string closers_;
+        json_token skipped_;
+        // the indexes of the sizes of the containers count_elements has open, innermost last
+        std::vector<std::size_t> open_;
     };
 }
 
@@ -0,0 +1,285 @@
+#ifndef CJSON_SNAPSHOT_VIEW_HPP
+#define CJSON_SNAPSHOT_VIEW_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../cjson_error.hpp"
+#include "../cjson_snapshot_format.hpp"
+#include "cjson_byte_reader.hpp"
+
+namespace cjson::detail::input {
+    // a read-only json value inside a snapshot written by snapshot_writer. views are two words
+    // plus a slot and navigate the bytes in place; every offset is bounds-checked when it is
+    // followed, so a corrupt snapshot throws json_input_error instead of reading out of range.
+    // the bytes must outlive every view into them
+    class snapshot_view {
+    public:
+        // checks the header and returns the root value; bytes past the recorded size are ignored
+        static auto root(const std::string_view bytes) -> snapshot_view {
+            if (bytes.size() < sizeof(snapshot::header)) {
+                throw json_input_error(truncated_input_error(bytes.size()));
+            }
+            auto head = snapshot::header{};
+            std::memcpy(&head, bytes.data(), sizeof(head));
+            if (std::memcmp(head.magic, _SNAPSHOT_MAGIC, _SNAPSHOT_MAGIC_SIZE) != 0) {
+                throw json_input_error(invalid_snapshot_error("bad magic", 0));
+            } else if (head.endian_mark != _SNAPSHOT_ENDIAN_MARK) {
+                throw json_input_error(invalid_snapshot_error("byte order mismatch", _SNAPSHOT_MAGIC_SIZE));
+            } else if (head.size > bytes.size()) {
+                throw json_input_error(truncated_input_error(bytes.size()));
+            }
+            auto view = snapshot_view{bytes.substr(0, static_cast<std::size_t>(head.size)), head.root, head.dictionary};
+            view.block(head.dictionary, sizeof(snapshot::dictionary_entry));
+            return view;
+        }
+
+        auto is_null() const noexcept -> bool {
+            return slot_.type == snapshot::slot_type::_NULL;
+        }
+
+        auto is_number() const noexcept -> bool {
+            return slot_.type == snapshot::slot_type::_NUMBER;
+        }
+
+        auto is_boolean() const noexcept -> bool {
+            return slot_.type == snapshot::slot_type::_BOOLEAN;
+        }
+
+        auto is_string() const noexcept -> bool {
+            return slot_.type == snapshot::slot_type::_STRING;
+        }
+
+        auto is_object() const noexcept -> bool {
+            return slot_.type == snapshot::slot_type::_OBJECT;
+        }
+
+        // number arrays are arrays too
+        auto is_array() const noexcept -> bool {
+            return slot_.type == snapshot::slot_type::_ARRAY or slot_.type == snapshot::slot_type::_NUMBER_ARRAY;
+        }
+
+        auto number() const -> double {
+            check_type(is_number(), "number");
+            return std::bit_cast<double>(slot_.payload);
+        }
+
+        auto boolean() const -> bool {
+            check_type(is_boolean(), "boolean");
+            return slot_.payload != 0;
+        }
+
+        auto string() const -> std::string_view {
+            check_type(is_string(), "string");
+            const auto size = block(slot_.payload, 1);
+            return {element(0, 1), size};
+        }
+
+        // number of elements or members; zero for scalars
+        auto size() const -> std::size_t {
+            switch (slot_.type) {
+                case snapshot::slot_type::_OBJECT:
+                case snapshot::slot_type::_ARRAY:
+                    return block(slot_.payload, sizeof(snapshot::slot));
+                case snapshot::slot_type::_NUMBER_ARRAY:
+                    return block(slot_.payload, sizeof(double));
+                default:
+                    return 0;
+            }
+        }
+
+        auto empty() const -> bool {
+            return size() == 0;
+        }
+
+        // the nth element of an array or the nth member value of an object in key order
+        auto operator[](const std::size_t n) const -> snapshot_view {
+            check_type(is_array() or is_object(), "array");
+            if (n >= size()) {
+                throw std::out_of_range("index out of range in json snapshot");
+            }
+            if (slot_.type == snapshot::slot_type::_NUMBER_ARRAY) {
+                auto number = 0.0;
+                std::memcpy(&number, element(n, sizeof(double)), sizeof(number));
+                auto result = snapshot::slot{};
+                result.type = snapshot::slot_type::_NUMBER;
+                result.payload = std::bit_cast<std::uint64_t>(number);
+                return {bytes_, result, dictionary_};
+            }
+            return {bytes_, member(n), dictionary_};
+        }
+
+        // the key of the nth member of an object, in bytewise order
+        auto key(const std::size_t n) const -> std::string_view {
+            check_type(is_object(), "object");
+            if (n >= size()) {
+                throw std::out_of_range("index out of range in json snapshot");
+            }
+            return dictionary_key(member(n).key);
+        }
+
+        auto find(const std::string_view key) const -> std::optional<snapshot_view> {
+            check_type(is_object(), "object");
+            const auto index = find_key(key);
+            if (not index) {
+                return std::nullopt;
+            }
+            auto lo = std::size_t{0};
+            auto hi = size();
+            while (lo < hi) {
+                const auto mid = lo + (hi - lo) / 2;
+                const auto candidate = member(mid);
+                if (candidate.key == *index) {
+                    return snapshot_view{bytes_, candidate, dictionary_};
+                } else if (candidate.key < *index) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            return std::nullopt;
+        }
+
+        auto at(const std::string_view key) const -> snapshot_view {
+            if (auto value = find(key)) {
+                return *value;
+            }
+            throw std::out_of_range("key not found in json snapshot");
+        }
+
+        auto operator[](const std::string_view key) const -> snapshot_view {
+            return at(key);
+        }
+
+        // copies the value out of the snapshot
+        template <typename JsonType>
+        auto to_json() const -> JsonType {
+            return to_json<JsonType>(0);
+        }
+
+    private:
+        snapshot_view(const std::string_view bytes, const snapshot::slot& slot, const std::uint64_t dictionary) noexcept
+            : bytes_{bytes}, slot_{slot}, dictionary_{dictionary} {}
+
+        template <typename JsonType>
+        auto to_json(const std::size_t depth) const -> JsonType {
+            if (depth > _MAX_BINARY_DEPTH) {
+                throw json_input_error(nesting_depth_error(static_cast<std::size_t>(slot_.payload)));
+            }
+            switch (slot_.type) {
+                case snapshot::slot_type::_NULL:
+                    return JsonType{nullptr};
+                case snapshot::slot_type::_NUMBER:
+                    return JsonType{static_cast<typename JsonType::number>(number())};
+                case snapshot::slot_type::_BOOLEAN:
+                    return JsonType{boolean()};
+                case snapshot::slot_type::_STRING:
+                    return JsonType{typename JsonType::string{string()}};
+                case snapshot::slot_type::_OBJECT: {
+                    auto json_object = typename JsonType::object{};
+                    for (std::size_t i = 0, n = size(); i < n; ++i) {
+                        json_object.emplace_hint(json_object.end(), key(i), (*this)[i].template to_json<JsonType>(depth + 1));
+                    }
+                    return JsonType{std::move(json_object)};
+                }
+                case snapshot::slot_type::_ARRAY: {
+                    auto json_array = typename JsonType::array{};
+                    json_array.reserve(size());
+                    for (std::size_t i = 0, n = size(); i < n; ++i) {
+                        json_array.push_back((*this)[i].template to_json<JsonType>(depth + 1));
+                    }
+                    return JsonType{std::move(json_array)};
+                }
+                case snapshot::slot_type::_NUMBER_ARRAY: {
+                    auto numbers = typename JsonType::number_array(size());
+                    for (std::size_t i = 0; i < numbers.size(); ++i) {
+                        auto number = 0.0;
+                        std::memcpy(&number, element(i, sizeof(double)), sizeof(number));
+                        numbers[i] = static_cast<typename JsonType::number>(number);
+                    }
+                    return JsonType{std::move(numbers)};
+                }
+                default:
+                    throw json_input_error(invalid_snapshot_error("unknown slot type", static_cast<std::size_t>(slot_.payload)));
+            }
+        }
+
+        // returns the element count of the block at offset after checking it fits in the bytes
+        auto block(const std::uint64_t offset, const std::size_t element_size) const -> std::size_t {
+            if (offset > bytes_.size() or bytes_.size() - offset < sizeof(std::uint64_t)) {
+                throw json_input_error(invalid_snapshot_error("block out of range", static_cast<std::size_t>(offset)));
+            }
+            auto count = std::uint64_t{0};
+            std::memcpy(&count, bytes_.data() + offset, sizeof(count));
+            if (count > (bytes_.size() - offset - sizeof(count)) / element_size) {
+                throw json_input_error(invalid_snapshot_error("block out of range", static_cast<std::size_t>(offset)));
+            }
+            return static_cast<std::size_t>(count);
+        }
+
+        // callers check n against the block size
+        auto element(const std::size_t n, const std::size_t element_size) const noexcept -> const char* {
+            return bytes_.data() + slot_.payload + sizeof(std::uint64_t) + n * element_size;
+        }
+
+        auto member(const std::size_t n) const noexcept -> snapshot::slot {
+            auto result = snapshot::slot{};
+            std::memcpy(&result, element(n, sizeof(snapshot::slot)), sizeof(result));
+            return result;
+        }
+
+        auto dictionary_entry(const std::size_t i) const noexcept -> snapshot::dictionary_entry {
+            auto entry = snapshot::dictionary_entry{};
+            std::memcpy(&entry, bytes_.data() + dictionary_ + sizeof(std::uint64_t) + i * sizeof(entry), sizeof(entry));
+            return entry;
+        }
+
+        auto dictionary_key(const std::uint32_t i) const -> std::string_view {
+            if (i >= block(dictionary_, sizeof(snapshot::dictionary_entry))) {
+                throw json_input_error(invalid_snapshot_error("key index out of range", static_cast<std::size_t>(slot_.payload)));
+            }
+            const auto entry = dictionary_entry(i);
+            if (entry.offset > bytes_.size() or entry.size > bytes_.size() - entry.offset) {
+                throw json_input_error(invalid_snapshot_error("key out of range", static_cast<std::size_t>(entry.offset)));
+            }
+            return bytes_.substr(static_cast<std::size_t>(entry.offset), static_cast<std::size_t>(entry.size));
+        }
+
+        auto find_key(const std::string_view key) const -> std::optional<std::uint32_t> {
+            auto lo = std::size_t{0};
+            auto hi = block(dictionary_, sizeof(snapshot::dictionary_entry));
+            while (lo < hi) {
+                const auto mid = lo + (hi - lo) / 2;
+                const auto candidate = dictionary_key(static_cast<std::uint32_t>(mid));
+                if (candidate == key) {
+                    return static_cast<std::uint32_t>(mid);
+                } else if (candidate < key) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            return std::nullopt;
+        }
+
+        static auto check_type(const bool matches, const char* type_name) -> void {
+            if (not matches) {
+                throw json_type_error(std::string{"json value is not a "} + type_name);
+            }
+        }
+
+        std::string_view bytes_;
+        snapshot::slot slot_;
+        std::uint64_t dictionary_;
+    };
+}
+
+
+#endif
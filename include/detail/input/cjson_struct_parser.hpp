@@ -0,0 +1,323 @@
+#ifndef CJSON_STRUCT_PARSER_HPP
+#define CJSON_STRUCT_PARSER_HPP
+
+#include <charconv>
+#include <concepts>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "../cjson_describe.hpp"
+#include "../cjson_error.hpp"
+#include "cjson_parse_options.hpp"
+#include "cjson_parse_result.hpp"
+#include "cjson_reader.hpp"
+#include "cjson_scanner.hpp"
+
+namespace cjson::detail::input {
+    namespace targets {
+        template <typename T>
+        struct is_optional: std::false_type {};
+
+        template <typename T>
+        struct is_optional<std::optional<T>>: std::true_type {};
+
+        template <typename T>
+        concept string_like = requires (T& value, std::string_view text) {
+            typename T::traits_type;
+            value.assign(text.data(), text.size());
+        };
+
+        template <typename T>
+        concept map_like = requires (T& value, std::string_view text) {
+            typename T::mapped_type;
+            value.try_emplace(typename T::key_type{text});
+            value.clear();
+        };
+
+        // emplace_back has to give a reference to the new element, which rules out
+        // std::vector<bool>
+        template <typename T>
+        concept sequence_like = requires (T& value) {
+            { value.emplace_back() } -> std::same_as<typename T::value_type&>;
+            value.clear();
+        };
+    }
+
+    // reads json straight into structs described with CJSON_DESCRIBE, skipping the basic_json
+    // tree. members are bool, arithmetic types, strings, std::optional, vector-like and
+    // map-like containers, and other described structs. object members that the struct does not
+    // describe are skipped with json_scanner::skip_value, and described members missing from the
+    // object keep the value they were constructed with
+    template <typename Reader>
+    class struct_parser {
+    public:
+        template <typename ...Args>
+        requires (not (std::same_as<std::remove_cvref_t<Args>, parse_options> or ...))
+        explicit struct_parser(Args&& ...args)
+            : scanner_{std::make_unique<Reader>(std::forward<Args>(args)...)} {
+            prime();
+        }
+
+        template <typename ...Args>
+        explicit struct_parser(const parse_options& options, Args&& ...args)
+            : scanner_{std::make_unique<Reader>(std::forward<Args>(args)...)}
+            , options_{options} {
+            prime();
+        }
+
+        struct_parser(const struct_parser&) noexcept = delete;
+        struct_parser(struct_parser&&) noexcept = default;
+
+        auto operator=(const struct_parser&) noexcept -> struct_parser& = delete;
+        auto operator=(struct_parser&&) noexcept -> struct_parser& = default;
+
+        ~struct_parser() noexcept = default;
+
+        template <typename ...Args>
+        auto reset(Args&& ...args) -> void {
+            scanner_.reset(std::forward<Args>(args)...);
+            error_.code_ = error_code::NONE;
+            prime();
+        }
+
+        // reads one value into a T; on concatenated input each call reads the next one
+        template <typename T>
+        auto parse() -> T {
+            auto value = T{};
+            if (failed() or not read(value)) {
+                throw json_input_error(error_.message(), error_.pos_);
+            }
+            return value;
+        }
+
+        // like parse, but malformed input, or input that does not fit T, is returned as a
+        // parse_error instead of thrown
+        template <typename T>
+        auto try_parse() -> parse_result<T> {
+            auto value = T{};
+            if (failed() or not read(value)) {
+                return parse_result<T>{parse_error{error_}};
+            }
+            return parse_result<T>{std::move(value)};
+        }
+
+        auto at_end() const noexcept -> bool {
+            return not failed() and current_token_.tok_ == token::END;
+        }
+
+    private:
+        // as in json_parser, nothing below throws on malformed input: the first error is kept in
+        // error_ and every read returns false once it is set
+
+        auto failed() const noexcept -> bool {
+            return error_.code_ != error_code::NONE;
+        }
+
+        auto fail(const error_code code) -> bool {
+            error_ = parse_error{code, scanner_.token_offset(), current_token_.pos_, current_token_.spelling_};
+            return false;
+        }
+
+        // a value of the wrong kind for the target, as opposed to no value at all
+        auto mismatch() -> bool {
+            switch (current_token_.tok_) {
+                case token::LEFT_BRACE:
+                case token::LEFT_BRACKET:
+                case token::NUMBER:
+                case token::STRING:
+                case token::TRUE:
+                case token::FALSE:
+                case token::NULL_VALUE:
+                    return fail(error_code::TYPE_MISMATCH);
+                default:
+                    return fail(error_code::INVALID_JSON_VALUE);
+            }
+        }
+
+        auto prime() -> void {
+            if (not scanner_.scan(current_token_)) {
+                error_ = scanner_.error();
+            }
+        }
+
+        auto accept() -> bool {
+            if (current_token_.tok_ != token::END) {
+                prime();
+            }
+            return not failed();
+        }
+
+        // after an element or member: true if another one follows, false if the container is
+        // closed or the separator is wrong
+        auto next_element(const token closer, const error_code code) -> bool {
+            if (current_token_.tok_ == closer) {
+                accept();
+                return false;
+            } else if (current_token_.tok_ != token::COMMA) {
+                fail(code);
+                return false;
+            }
+            return accept();
+        }
+
+        template <typename T>
+        auto read(T& value) -> bool {
+            if constexpr (reflect::described<T>) {
+                return read_struct(value);
+            } else if constexpr (std::same_as<T, bool>) {
+                if (current_token_.tok_ != token::TRUE and current_token_.tok_ != token::FALSE) {
+                    return mismatch();
+                }
+                value = current_token_.tok_ == token::TRUE;
+                return accept();
+            } else if constexpr (std::is_arithmetic_v<T>) {
+                return read_number(value);
+            } else if constexpr (targets::string_like<T>) {
+                if (current_token_.tok_ != token::STRING) {
+                    return mismatch();
+                }
+                value.assign(current_token_.spelling_.data(), current_token_.spelling_.size());
+                return accept();
+            } else if constexpr (targets::is_optional<T>::value) {
+                if (current_token_.tok_ == token::NULL_VALUE) {
+                    value.reset();
+                    return accept();
+                }
+                return read(value.emplace());
+            } else if constexpr (targets::map_like<T>) {
+                return read_map(value);
+            } else if constexpr (targets::sequence_like<T>) {
+                return read_sequence(value);
+            } else {
+                static_assert(not std::is_same_v<T, T>, "no json mapping for this type: describe it with CJSON_DESCRIBE");
+            }
+        }
+
+        // an integer target takes the whole literal, so 1.5 and 1e3 do not fit an int
+        template <typename T>
+        auto read_number(T& value) -> bool {
+            if (current_token_.tok_ != token::NUMBER) {
+                return mismatch();
+            }
+            const auto& spelling = current_token_.spelling_;
+            const auto [end, ec] = std::from_chars(spelling.data(), spelling.data() + spelling.size(), value);
+            if (ec == std::errc::result_out_of_range) {
+                return fail(error_code::NUMBER_OUT_OF_RANGE);
+            } else if (ec != std::errc{} or end != spelling.data() + spelling.size()) {
+                return fail(error_code::TYPE_MISMATCH);
+            }
+            return accept();
+        }
+
+        // keys are looked up in the perfect hash of the struct's member names
+        template <reflect::described T>
+        auto read_struct(T& value) -> bool {
+            if (current_token_.tok_ != token::LEFT_BRACE) {
+                return mismatch();
+            }
+            if (not accept()) {
+                return false;
+            }
+            if (current_token_.tok_ == token::RIGHT_BRACE) {
+                return accept();
+            }
+            while (true) {
+                if (current_token_.tok_ != token::STRING) {
+                    return fail(error_code::INVALID_KEY);
+                }
+                const auto index = reflect::key_index<T>::find(current_token_.spelling_);
+                if (not accept()) {
+                    return false;
+                }
+                if (current_token_.tok_ != token::COLON) {
+                    return fail(error_code::INVALID_COLON);
+                }
+                if (index == reflect::key_index<T>::size) {
+                    // the scanner is just past the colon, where skip_value expects it
+                    if (not scanner_.skip_value(options_.skip)) {
+                        error_ = scanner_.error();
+                        return false;
+                    }
+                    prime();
+                    if (failed()) {
+                        return false;
+                    }
+                } else if (not accept() or not reflect::visit_field<T>(index, [&](const auto& field) {
+                    return read(value.*field.member_);
+                })) {
+                    return false;
+                }
+                if (not next_element(token::RIGHT_BRACE, error_code::INVALID_OBJECT)) {
+                    return not failed();
+                }
+            }
+        }
+
+        // the elements replace what the container held; a later duplicate key overwrites
+        template <targets::map_like T>
+        auto read_map(T& value) -> bool {
+            if (current_token_.tok_ != token::LEFT_BRACE) {
+                return mismatch();
+            }
+            value.clear();
+            if (not accept()) {
+                return false;
+            }
+            if (current_token_.tok_ == token::RIGHT_BRACE) {
+                return accept();
+            }
+            while (true) {
+                if (current_token_.tok_ != token::STRING) {
+                    return fail(error_code::INVALID_KEY);
+                }
+                auto key = typename T::key_type{std::string_view{current_token_.spelling_}};
+                if (not accept()) {
+                    return false;
+                }
+                if (current_token_.tok_ != token::COLON) {
+                    return fail(error_code::INVALID_COLON);
+                }
+                if (not accept() or not read(value.try_emplace(std::move(key)).first->second)) {
+                    return false;
+                }
+                if (not next_element(token::RIGHT_BRACE, error_code::INVALID_OBJECT)) {
+                    return not failed();
+                }
+            }
+        }
+
+        template <targets::sequence_like T>
+        auto read_sequence(T& value) -> bool {
+            if (current_token_.tok_ != token::LEFT_BRACKET) {
+                return mismatch();
+            }
+            value.clear();
+            if (not accept()) {
+                return false;
+            }
+            if (current_token_.tok_ == token::RIGHT_BRACKET) {
+                return accept();
+            }
+            while (true) {
+                if (not read(value.emplace_back())) {
+                    return false;
+                }
+                if (not next_element(token::RIGHT_BRACKET, error_code::INVALID_ARRAY)) {
+                    return not failed();
+                }
+            }
+        }
+
+        json_scanner<Reader> scanner_;
+        json_token current_token_;
+        parse_options options_;
+        parse_error error_;
+    };
+}
+
+
+#endif
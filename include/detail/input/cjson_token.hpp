@@ -18,7 +18,9 @@ namespace cjson::detail::input {
         TRUE,
         FALSE,
         NUMBER,
-        STRING
+        STRING,
+        // stands in for a token that could not be read
+        INVALID
     };
 
     struct json_token {
@@ -0,0 +1,209 @@
+#ifndef CJSON_CBOR_ENCODER_HPP
+#define CJSON_CBOR_ENCODER_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cjson_sink.hpp"
+
+#define _CBOR_MAX_INTEGER 18446744073709551616.0
+
+namespace cjson::detail::output {
+    struct cbor_options {
+        // deterministic encoding (rfc 8949, section 4.2.1): map keys sorted by their encoded
+        // bytes and floats in the shortest width that keeps their value
+        bool canonical = false;
+    };
+
+    // writes a json value as cbor with definite lengths. whole numbers use the smallest
+    // integer encoding, other numbers are written as float64 unless canonical is set
+    template <json_sink Sink>
+    class cbor_encoder {
+    public:
+        explicit cbor_encoder(Sink& sink, const cbor_options& options = {}) noexcept
+            : sink_{sink}, options_{options} {}
+
+        template <typename JsonType>
+        auto dump(const JsonType& js) -> void {
+            js.visit([&](const auto& value) {
+                using T = std::remove_cvref_t<decltype(value)>;
+                if constexpr (std::is_null_pointer_v<T>) {
+                    put(0xF6);
+                } else if constexpr (std::is_same_v<T, typename JsonType::boolean>) {
+                    put(value ? 0xF5 : 0xF4);
+                } else if constexpr (std::is_same_v<T, typename JsonType::number>) {
+                    write_number(value);
+                } else if constexpr (std::is_same_v<T, typename JsonType::string>) {
+                    write_text(value);
+                } else if constexpr (std::is_same_v<T, typename JsonType::object>) {
+                    write_head(_MAP, value.size());
+                    if (options_.canonical) {
+                        auto members = std::vector<std::pair<std::string_view, const JsonType*>>{};
+                        members.reserve(value.size());
+                        for (const auto& [key, val] : value) {
+                            members.emplace_back(std::string_view{key}, &val);
+                        }
+                        write_sorted(members);
+                    } else {
+                        for (const auto& [key, val] : value) {
+                            write_text(std::string_view{key});
+                            dump(val);
+                        }
+                    }
+                } else if constexpr (requires { value.shape_; }) {
+                    write_head(_MAP, value.values_.size());
+                    if (options_.canonical) {
+                        auto members = std::vector<std::pair<std::string_view, const JsonType*>>{};
+                        members.reserve(value.values_.size());
+                        for (std::size_t i = 0; i < value.values_.size(); ++i) {
+                            members.emplace_back(std::string_view{value.shape_->key(i)}, &value.values_[i]);
+                        }
+                        write_sorted(members);
+                    } else {
+                        for (std::size_t i = 0; i < value.values_.size(); ++i) {
+                            write_text(std::string_view{value.shape_->key(i)});
+                            dump(value.values_[i]);
+                        }
+                    }
+                } else {
+                    write_head(_ARRAY, value.size());
+                    for (const auto& val : value) {
+                        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(val)>, JsonType>) {
+                            dump(val);
+                        } else {
+                            write_number(val);
+                        }
+                    }
+                }
+            });
+        }
+
+    private:
+        static constexpr std::uint8_t _UNSIGNED = 0;
+        static constexpr std::uint8_t _NEGATIVE = 1;
+        static constexpr std::uint8_t _TEXT = 3;
+        static constexpr std::uint8_t _ARRAY = 4;
+        static constexpr std::uint8_t _MAP = 5;
+
+        // text keys encode as their length followed by their bytes, so the encoded order is
+        // shorter keys first, then bytewise
+        template <typename Members>
+        auto write_sorted(Members& members) -> void {
+            std::sort(members.begin(), members.end(), [](const auto& m1, const auto& m2) {
+                return m1.first.size() != m2.first.size() ? m1.first.size() < m2.first.size() : m1.first < m2.first;
+            });
+            for (const auto& [key, val] : members) {
+                write_text(key);
+                dump(*val);
+            }
+        }
+
+        template <typename Number>
+        auto write_number(const Number n) -> void {
+            if (n == std::trunc(n) and not (n == 0 and std::signbit(n))) {
+                if (n >= 0 and n < _CBOR_MAX_INTEGER) {
+                    write_head(_UNSIGNED, static_cast<std::uint64_t>(n));
+                    return;
+                } else if (n < 0 and -n < _CBOR_MAX_INTEGER) {
+                    write_head(_NEGATIVE, static_cast<std::uint64_t>(-n) - 1);
+                    return;
+                }
+            }
+            write_float(static_cast<double>(n));
+        }
+
+        auto write_float(const double d) -> void {
+            if (options_.canonical) {
+                if (const auto half = to_half(d); half.second) {
+                    put(0xF9);
+                    write_big_endian(half.first);
+                    return;
+                } else if (static_cast<double>(static_cast<float>(d)) == d) {
+                    put(0xFA);
+                    write_big_endian(std::bit_cast<std::uint32_t>(static_cast<float>(d)));
+                    return;
+                }
+            }
+            put(0xFB);
+            write_big_endian(std::bit_cast<std::uint64_t>(d));
+        }
+
+        // returns the half precision encoding of d and whether it is exact; nan is canonicalized
+        static auto to_half(const double d) noexcept -> std::pair<std::uint16_t, bool> {
+            const auto sign = static_cast<std::uint16_t>(std::signbit(d) ? 0x8000 : 0);
+            if (std::isnan(d)) {
+                return {0x7E00, true};
+            } else if (std::isinf(d)) {
+                return {static_cast<std::uint16_t>(sign | 0x7C00), true};
+            } else if (d == 0) {
+                return {sign, true};
+            }
+            auto exponent = 0;
+            const auto fraction = std::frexp(std::fabs(d), &exponent);
+            --exponent;
+            if (exponent >= -14 and exponent <= 15) {
+                const auto mantissa = (fraction * 2 - 1) * 1024;
+                if (mantissa == std::trunc(mantissa)) {
+                    return {static_cast<std::uint16_t>(sign | ((exponent + 15) << 10) | static_cast<int>(mantissa)), true};
+                }
+            } else if (exponent >= -24 and exponent < -14) {
+                const auto mantissa = std::ldexp(std::fabs(d), 24);
+                if (mantissa == std::trunc(mantissa)) {
+                    return {static_cast<std::uint16_t>(sign | static_cast<int>(mantissa)), true};
+                }
+            }
+            return {0, false};
+        }
+
+        auto write_text(const std::string_view str) -> void {
+            write_head(_TEXT, str.size());
+            sink_.write(str.data(), str.size());
+        }
+
+        auto write_head(const std::uint8_t major, const std::uint64_t argument) -> void {
+            const auto type = static_cast<std::uint8_t>(major << 5);
+            if (argument < 24) {
+                put(static_cast<std::uint8_t>(type | argument));
+            } else if (argument <= 0xFF) {
+                put(static_cast<std::uint8_t>(type | 24));
+                put(static_cast<std::uint8_t>(argument));
+            } else if (argument <= 0xFFFF) {
+                put(static_cast<std::uint8_t>(type | 25));
+                write_big_endian(static_cast<std::uint16_t>(argument));
+            } else if (argument <= 0xFFFF'FFFF) {
+                put(static_cast<std::uint8_t>(type | 26));
+                write_big_endian(static_cast<std::uint32_t>(argument));
+            } else {
+                put(static_cast<std::uint8_t>(type | 27));
+                write_big_endian(argument);
+            }
+        }
+
+        template <typename T>
+        auto write_big_endian(T value) -> void {
+            char bytes[sizeof(T)];
+            for (auto i = sizeof(T); i > 0; --i) {
+                bytes[i - 1] = static_cast<char>(value & 0xFF);
+                value = static_cast<T>(value >> 8);
+            }
+            sink_.write(bytes, sizeof(T));
+        }
+
+        auto put(const std::uint8_t byte) -> void {
+            sink_.put(static_cast<char>(byte));
+        }
+
+        Sink& sink_;
+        cbor_options options_;
+    };
+}
+
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef CJSON_DUMP_OPTIONS_HPP
+#define CJSON_DUMP_OPTIONS_HPP
+
+#include <cstddef>
+
+namespace cjson::detail::output {
+    struct dump_options {
+        // number of spaces per nesting level; 0 writes everything on one line
+        std::size_t indent = 0;
+        // escape every non-ascii character as \uXXXX, using surrogate pairs outside the bmp
+        bool ascii_only = false;
+    };
+}
+
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef CJSON_FD_SINK_HPP
+#define CJSON_FD_SINK_HPP
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <system_error>
+#include <utility>
+#include <unistd.h>
+
+#define _FD_SINK_BUFFER_SIZE 65536
+
+namespace cjson::detail::output {
+    // buffers the output and writes it to a posix file descriptor, which it does not own
+    class fd_sink {
+    public:
+        explicit fd_sink(const int fd) noexcept
+            : fd_{fd} {}
+
+        fd_sink(const fd_sink&) noexcept = delete;
+        fd_sink(fd_sink&&) noexcept = delete;
+
+        auto operator=(const fd_sink&) noexcept -> fd_sink& = delete;
+        auto operator=(fd_sink&&) noexcept -> fd_sink& = delete;
+
+        ~fd_sink() noexcept {
+            try {
+                flush();
+            } catch (const std::system_error&) {
+            }
+        }
+
+        auto put(const char c) -> void {
+            if (size_ == buffer_.size()) {
+                flush();
+            }
+            buffer_[size_++] = c;
+        }
+
+        auto write(const char* str, std::size_t n) -> void {
+            if (size_ + n > buffer_.size()) {
+                flush();
+                if (n >= buffer_.size()) {
+                    write_all(str, n);
+                    return;
+                }
+            }
+            std::copy(str, str + n, buffer_.data() + size_);
+            size_ += n;
+        }
+
+        auto flush() -> void {
+            const auto size = std::exchange(size_, 0);
+            write_all(buffer_.data(), size);
+        }
+
+    private:
+        auto write_all(const char* str, std::size_t n) -> void {
+            while (n > 0) {
+                const auto written = ::write(fd_, str, n);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "write");
+                }
+                str += written;
+                n -= static_cast<std::size_t>(written);
+            }
+        }
+
+        int fd_;
+        std::size_t size_ = 0;
+        std::array<char, _FD_SINK_BUFFER_SIZE> buffer_;
+    };
+}
+
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef CJSON_FRAGMENT_CACHE_HPP
+#define CJSON_FRAGMENT_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cjson_dump_options.hpp"
+
+#define _FRAGMENT_MIN_SIZE 256
+
+namespace cjson::detail::output {
+    // caches the serialized bytes of the containers dumped through it, together with a digest of
+    // every revision under the json holding each container. a json whose types track revisions,
+    // such as tracked_json, takes a new revision whenever it is modified, and only the value
+    // modified does, so before rendering the serializer stamps each container with the digest
+    // of its subtree, in the order it renders them in; a change anywhere under a container, even
+    // through a reference held across dumps, then re-renders that container and the ones around
+    // it, and the rest is reused. stamping visits every value but formats none. the revisions
+    // live in the values, so a change made on any thread is seen. fragments that a dump does
+    // not reach are dropped at its end, so a cache is meant for dumping one document
+    class fragment_cache {
+    public:
+        explicit fragment_cache(const dump_options& options = {}) noexcept
+            : options_{options} {}
+
+        auto options() const noexcept -> const dump_options& {
+            return options_;
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return fragments_.size();
+        }
+
+        auto clear() noexcept -> void {
+            fragments_.clear();
+        }
+
+        // the number of fragments the last dump wrote out of the cache
+        auto reused() const noexcept -> std::size_t {
+            return reused_;
+        }
+
+        // small fragments are cheaper to re-render than to keep track of
+        static auto worth_storing(const std::size_t size) noexcept -> bool {
+            return size >= _FRAGMENT_MIN_SIZE;
+        }
+
+        auto find(const void* container, const std::uint64_t digest, const std::size_t level) const noexcept
+            -> const std::string* {
+            const auto iter = fragments_.find(container);
+            return (iter != fragments_.end() and iter->second.digest_ == digest and iter->second.level_ == level)
+                ? &iter->second.bytes_ : nullptr;
+        }
+
+        // the serializer brackets each dump with start and finish. between them it first stamps
+        // every container in rendering order, opening a stamp before its children and closing it
+        // after them with the digest of the subtree, then renders: the digest of the next
+        // container is stamp(), a fragment found with it is used with reuse, which skips the
+        // stamps of the containers inside it, and rendering a container is bracketed by enter
+        // and leave so that the cache knows which fragments each stored fragment contains
+        auto start() -> void {
+            ++dump_;
+            reused_ = 0;
+            open_.assign(1, {});
+            stamps_.clear();
+            cursor_ = 0;
+        }
+
+        auto open_stamp() -> std::size_t {
+            stamps_.emplace_back();
+            return stamps_.size() - 1;
+        }
+
+        auto close_stamp(const std::size_t slot, const std::uint64_t digest) noexcept -> void {
+            stamps_[slot] = {digest, stamps_.size()};
+        }
+
+        auto stamp() const noexcept -> std::uint64_t {
+            return stamps_[cursor_].digest_;
+        }
+
+        auto reuse(const void* container) -> void {
+            cursor_ = stamps_[cursor_].end_;
+            ++reused_;
+            reach(container);
+            open_.back().push_back(container);
+        }
+
+        auto enter() -> void {
+            ++cursor_;
+            open_.emplace_back();
+        }
+
+        auto leave(const void* container, const std::uint64_t digest, const std::size_t level, std::string bytes)
+            -> void {
+            auto nested = std::move(open_.back());
+            open_.pop_back();
+            if (worth_storing(bytes.size())) {
+                fragments_.insert_or_assign(container, fragment{digest, level, dump_, std::move(bytes), std::move(nested)});
+                open_.back().push_back(container);
+            } else {
+                open_.back().insert(open_.back().end(), nested.begin(), nested.end());
+            }
+        }
+
+        auto finish() -> void {
+            std::erase_if(fragments_, [&](const auto& entry) {
+                return entry.second.dump_ != dump_;
+            });
+        }
+
+    private:
+        struct subtree {
+            std::uint64_t digest_;
+            // one past the stamps of the containers inside
+            std::size_t end_;
+        };
+
+        struct fragment {
+            std::uint64_t digest_;
+            std::size_t level_;
+            std::size_t dump_;
+            std::string bytes_;
+            std::vector<const void*> nested_;
+        };
+
+        // a reused fragment keeps the fragments inside it
+        auto reach(const void* container) -> void {
+            const auto iter = fragments_.find(container);
+            if (iter != fragments_.end() and iter->second.dump_ != dump_) {
+                iter->second.dump_ = dump_;
+                for (const auto nested : iter->second.nested_) {
+                    reach(nested);
+                }
+            }
+        }
+
+        dump_options options_;
+        std::unordered_map<const void*, fragment> fragments_;
+        std::vector<std::vector<const void*>> open_;
+        std::vector<subtree> stamps_;
+        std::size_t cursor_ = 0;
+        std::size_t dump_ = 0;
+        std::size_t reused_ = 0;
+    };
+}
+
+
+#endif
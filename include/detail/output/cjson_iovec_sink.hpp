@@ -0,0 +1,120 @@
+#ifndef CJSON_IOVEC_SINK_HPP
+#define CJSON_IOVEC_SINK_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <vector>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define _IOVEC_CHUNK_SIZE 16384
+#define _IOVEC_REF_THRESHOLD 512
+
+namespace cjson::detail::output {
+    // collects the output as a list of iovecs; punctuation and numbers are copied into owned
+    // chunks while long string runs are referenced in place, so the serialized value must
+    // outlive the sink and must not be modified until the iovecs have been written
+    class iovec_sink {
+    public:
+        iovec_sink() noexcept = default;
+        iovec_sink(const iovec_sink&) noexcept = delete;
+        iovec_sink(iovec_sink&&) noexcept = default;
+
+        auto operator=(const iovec_sink&) noexcept -> iovec_sink& = delete;
+        auto operator=(iovec_sink&&) noexcept -> iovec_sink& = default;
+
+        ~iovec_sink() noexcept = default;
+
+        auto put(const char c) -> void {
+            write(&c, 1);
+        }
+
+        auto write(const char* str, std::size_t n) -> void {
+            while (n > 0) {
+                if (used_ == _IOVEC_CHUNK_SIZE or chunks_.empty()) {
+                    chunks_.push_back(std::make_unique_for_overwrite<char[]>(_IOVEC_CHUNK_SIZE));
+                    used_ = 0;
+                }
+                const auto count = std::min(n, _IOVEC_CHUNK_SIZE - used_);
+                const auto dest = chunks_.back().get() + used_;
+                std::copy_n(str, count, dest);
+                append(dest, count);
+                used_ += count;
+                str += count;
+                n -= count;
+            }
+        }
+
+        // references str instead of copying it when it is long enough to be worth an iovec
+        auto write_ref(const char* str, const std::size_t n) -> void {
+            if (n < _IOVEC_REF_THRESHOLD) {
+                write(str, n);
+                return;
+            }
+            iovecs_.push_back({const_cast<char*>(str), n});
+        }
+
+        auto iovecs() const noexcept -> std::span<const iovec> {
+            return iovecs_;
+        }
+
+        auto size() const noexcept -> std::size_t {
+            auto size = std::size_t{0};
+            for (const auto& iov : iovecs_) {
+                size += iov.iov_len;
+            }
+            return size;
+        }
+
+    private:
+        // extends the last iovec when the new bytes directly follow it in the same chunk
+        auto append(char* dest, const std::size_t n) -> void {
+            if (not iovecs_.empty()) {
+                auto& last = iovecs_.back();
+                if (static_cast<char*>(last.iov_base) + last.iov_len == dest) {
+                    last.iov_len += n;
+                    return;
+                }
+            }
+            iovecs_.push_back({dest, n});
+        }
+
+        std::vector<std::unique_ptr<char[]>> chunks_;
+        std::size_t used_ = 0;
+        std::vector<iovec> iovecs_;
+    };
+
+    // writes all iovecs to fd, batching by IOV_MAX and resuming after short writes
+    inline auto write_iovecs(const int fd, const std::span<const iovec> iovecs) -> void {
+        auto pending = std::vector<iovec>(iovecs.begin(), iovecs.end());
+        auto first = pending.data();
+        auto remaining = pending.size();
+        while (remaining > 0) {
+            const auto count = static_cast<int>(std::min<std::size_t>(remaining, IOV_MAX));
+            auto written = ::writev(fd, first, count);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "writev");
+            }
+            while (remaining > 0 and static_cast<std::size_t>(written) >= first->iov_len) {
+                written -= static_cast<ssize_t>(first->iov_len);
+                ++first;
+                --remaining;
+            }
+            if (remaining > 0) {
+                first->iov_base = static_cast<char*>(first->iov_base) + written;
+                first->iov_len -= static_cast<std::size_t>(written);
+            }
+        }
+    }
+}
+
+
+#endif
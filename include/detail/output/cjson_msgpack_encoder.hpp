@@ -0,0 +1,156 @@
+#ifndef CJSON_MSGPACK_ENCODER_HPP
+#define CJSON_MSGPACK_ENCODER_HPP
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+#include "cjson_sink.hpp"
+
+namespace cjson::detail::output {
+    // writes a json value as messagepack. whole numbers that fit an int64 use the smallest
+    // integer format, every other number is written as a float64. bin and ext are never
+    // written: json has no type for them, so the strings and {"type", "data"} objects that
+    // msgpack_parser makes of them are written back as str and map
+    template <json_sink Sink>
+    class msgpack_encoder {
+    public:
+        explicit msgpack_encoder(Sink& sink) noexcept
+            : sink_{sink} {}
+
+        template <typename JsonType>
+        auto dump(const JsonType& js) -> void {
+            js.visit([&](const auto& value) {
+                using T = std::remove_cvref_t<decltype(value)>;
+                if constexpr (std::is_null_pointer_v<T>) {
+                    put(0xC0);
+                } else if constexpr (std::is_same_v<T, typename JsonType::boolean>) {
+                    put(value ? 0xC3 : 0xC2);
+                } else if constexpr (std::is_same_v<T, typename JsonType::number>) {
+                    write_number(value);
+                } else if constexpr (std::is_same_v<T, typename JsonType::string>) {
+                    write_string(value);
+                } else if constexpr (std::is_same_v<T, typename JsonType::object>) {
+                    write_header(value.size(), 0x80, 0xDE);
+                    for (const auto& [key, val] : value) {
+                        write_string(std::string_view{key});
+                        dump(val);
+                    }
+                } else if constexpr (requires { value.shape_; }) {
+                    write_header(value.values_.size(), 0x80, 0xDE);
+                    for (std::size_t i = 0; i < value.values_.size(); ++i) {
+                        write_string(std::string_view{value.shape_->key(i)});
+                        dump(value.values_[i]);
+                    }
+                } else {
+                    write_header(value.size(), 0x90, 0xDC);
+                    for (const auto& val : value) {
+                        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(val)>, JsonType>) {
+                            dump(val);
+                        } else {
+                            write_number(val);
+                        }
+                    }
+                }
+            });
+        }
+
+    private:
+        template <typename Number>
+        auto write_number(const Number n) -> void {
+            constexpr auto int64_limit = 9223372036854775808.0;
+            if (n >= -int64_limit and n < int64_limit and n == std::trunc(n) and not (n == 0 and std::signbit(n))) {
+                write_integer(static_cast<std::int64_t>(n));
+            } else {
+                put(0xCB);
+                write_big_endian(std::bit_cast<std::uint64_t>(static_cast<double>(n)));
+            }
+        }
+
+        auto write_integer(const std::int64_t i) -> void {
+            if (i >= 0) {
+                if (i <= 0x7F) {
+                    put(static_cast<std::uint8_t>(i));
+                } else if (i <= std::numeric_limits<std::uint8_t>::max()) {
+                    put(0xCC);
+                    put(static_cast<std::uint8_t>(i));
+                } else if (i <= std::numeric_limits<std::uint16_t>::max()) {
+                    put(0xCD);
+                    write_big_endian(static_cast<std::uint16_t>(i));
+                } else if (i <= std::numeric_limits<std::uint32_t>::max()) {
+                    put(0xCE);
+                    write_big_endian(static_cast<std::uint32_t>(i));
+                } else {
+                    put(0xCF);
+                    write_big_endian(static_cast<std::uint64_t>(i));
+                }
+            } else if (i >= -32) {
+                put(static_cast<std::uint8_t>(static_cast<std::int8_t>(i)));
+            } else if (i >= std::numeric_limits<std::int8_t>::min()) {
+                put(0xD0);
+                put(static_cast<std::uint8_t>(static_cast<std::int8_t>(i)));
+            } else if (i >= std::numeric_limits<std::int16_t>::min()) {
+                put(0xD1);
+                write_big_endian(static_cast<std::uint16_t>(static_cast<std::int16_t>(i)));
+            } else if (i >= std::numeric_limits<std::int32_t>::min()) {
+                put(0xD2);
+                write_big_endian(static_cast<std::uint32_t>(static_cast<std::int32_t>(i)));
+            } else {
+                put(0xD3);
+                write_big_endian(static_cast<std::uint64_t>(i));
+            }
+        }
+
+        auto write_string(const std::string_view str) -> void {
+            if (str.size() <= 31) {
+                put(static_cast<std::uint8_t>(0xA0 | str.size()));
+            } else if (str.size() <= std::numeric_limits<std::uint8_t>::max()) {
+                put(0xD9);
+                put(static_cast<std::uint8_t>(str.size()));
+            } else if (str.size() <= std::numeric_limits<std::uint16_t>::max()) {
+                put(0xDA);
+                write_big_endian(static_cast<std::uint16_t>(str.size()));
+            } else {
+                put(0xDB);
+                write_big_endian(static_cast<std::uint32_t>(str.size()));
+            }
+            sink_.write(str.data(), str.size());
+        }
+
+        // fix formats hold up to 15 entries; the 32 bit format code directly follows the 16 bit one
+        auto write_header(const std::size_t size, const std::uint8_t fix, const std::uint8_t wide) -> void {
+            if (size <= 15) {
+                put(static_cast<std::uint8_t>(fix | size));
+            } else if (size <= std::numeric_limits<std::uint16_t>::max()) {
+                put(wide);
+                write_big_endian(static_cast<std::uint16_t>(size));
+            } else {
+                put(static_cast<std::uint8_t>(wide + 1));
+                write_big_endian(static_cast<std::uint32_t>(size));
+            }
+        }
+
+        template <typename T>
+        auto write_big_endian(T value) -> void {
+            char bytes[sizeof(T)];
+            for (auto i = sizeof(T); i > 0; --i) {
+                bytes[i - 1] = static_cast<char>(value & 0xFF);
+                value = static_cast<T>(value >> 8);
+            }
+            sink_.write(bytes, sizeof(T));
+        }
+
+        auto put(const std::uint8_t byte) -> void {
+            sink_.put(static_cast<char>(byte));
+        }
+
+        Sink& sink_;
+    };
+}
+
+
+#endif
@@ -0,0 +1,388 @@
+#ifndef CJSON_SERIALIZER_HPP
+#define CJSON_SERIALIZER_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "../cjson_simd.hpp"
+#include "cjson_dump_options.hpp"
+#include "cjson_fragment_cache.hpp"
+#include "cjson_sink.hpp"
+
+#define _NULL_LITERAL "null"
+#define _TRUE_LITERAL "true"
+#define _FALSE_LITERAL "false"
+#define _NUMBER_BUFFER_SIZE 32
+#define _MAX_EXACT_INTEGER 9007199254740992.0
+#define _REPLACEMENT_CHARACTER 0xFFFD
+
+namespace cjson::detail::output {
+    // writes the shortest representation that parses back to n; whole numbers take an integer
+    // fast path and non-finite values, which json cannot represent, are written as null
+    template <typename Number>
+    auto format_number(char* first, char* last, const Number n) noexcept -> char* {
+        if constexpr (std::is_floating_point_v<Number>) {
+            if (not std::isfinite(n)) {
+                return std::copy_n(_NULL_LITERAL, 4, first);
+            }
+            if (std::abs(n) < _MAX_EXACT_INTEGER and n == std::trunc(n) and not (n == 0 and std::signbit(n))) {
+                return std::to_chars(first, last, static_cast<std::int64_t>(n)).ptr;
+            }
+        }
+        return std::to_chars(first, last, n).ptr;
+    }
+
+    // the length format_number gives n. whole numbers, which most numbers in json are, are
+    // measured by their digits instead of being formatted
+    template <typename Number>
+    auto formatted_size(const Number n) noexcept -> std::size_t {
+        if constexpr (std::is_floating_point_v<Number>) {
+            if (not std::isfinite(n)) {
+                return 4;
+            }
+            if (std::abs(n) < _MAX_EXACT_INTEGER and n == std::trunc(n) and not (n == 0 and std::signbit(n))) {
+                return formatted_size(static_cast<std::int64_t>(n));
+            }
+            char buffer[_NUMBER_BUFFER_SIZE];
+            return static_cast<std::size_t>(format_number(buffer, buffer + _NUMBER_BUFFER_SIZE, n) - buffer);
+        } else {
+            auto size = std::size_t{1};
+            auto magnitude = n / 10;
+            if constexpr (std::is_signed_v<Number>) {
+                if (n < 0) {
+                    ++size;
+                    magnitude = -magnitude;
+                }
+            }
+            for (; magnitude != 0; magnitude /= 10) {
+                ++size;
+            }
+            return size;
+        }
+    }
+
+    template <json_sink Sink>
+    class struct_serializer;
+
+    template <json_sink Sink>
+    class json_serializer {
+    public:
+        explicit json_serializer(Sink& sink, const dump_options& options = {}) noexcept
+            : sink_{sink}, options_{options} {}
+
+        // containers are looked up in and stored to cache, which also supplies the options
+        json_serializer(Sink& sink, fragment_cache& cache) noexcept
+            : sink_{sink}, options_{cache.options()}, cache_{&cache} {}
+
+        template <typename JsonType>
+        auto dump(const JsonType& js) -> void {
+            if (cache_ != nullptr) {
+                cache_->start();
+                if constexpr (requires { js.revision(); }) {
+                    stamp_value(js);
+                }
+                dump_value(js, 0);
+                cache_->finish();
+            } else {
+                dump_value(js, 0);
+            }
+        }
+
+    private:
+        template <json_sink>
+        friend class json_serializer;
+
+        template <json_sink>
+        friend class struct_serializer;
+
+        template <typename JsonType>
+        auto dump_value(const JsonType& js, const std::size_t level) -> void {
+            js.visit([&](const auto& value) {
+                using T = std::remove_cvref_t<decltype(value)>;
+                if constexpr (std::is_null_pointer_v<T>) {
+                    write(_NULL_LITERAL);
+                } else if constexpr (std::is_same_v<T, typename JsonType::boolean>) {
+                    value ? write(_TRUE_LITERAL) : write(_FALSE_LITERAL);
+                } else if constexpr (std::is_same_v<T, typename JsonType::number>) {
+                    write_number(value);
+                } else if constexpr (std::is_same_v<T, typename JsonType::string>) {
+                    write_string(value);
+                } else if (cache_ != nullptr) {
+                    if constexpr (requires { js.revision(); }) {
+                        dump_cached<JsonType>(value, level);
+                    } else {
+                        dump_container<JsonType>(value, level);
+                    }
+                } else {
+                    dump_container<JsonType>(value, level);
+                }
+            });
+        }
+
+        // stamps the containers under js in the order dump_value renders them, and returns the
+        // digest of every revision under js, which changes when any of them does
+        template <typename JsonType>
+        auto stamp_value(const JsonType& js) -> std::uint64_t {
+            return js.visit([&](const auto& value) -> std::uint64_t {
+                using T = std::remove_cvref_t<decltype(value)>;
+                auto digest = mix(js.revision());
+                if constexpr (std::is_same_v<T, typename JsonType::object>) {
+                    const auto slot = cache_->open_stamp();
+                    for (const auto& member : value) {
+                        digest = mix(digest ^ stamp_value(member.second));
+                    }
+                    cache_->close_stamp(slot, digest);
+                } else if constexpr (std::is_same_v<T, typename JsonType::array>) {
+                    const auto slot = cache_->open_stamp();
+                    for (const auto& val : value) {
+                        digest = mix(digest ^ stamp_value(val));
+                    }
+                    cache_->close_stamp(slot, digest);
+                } else if constexpr (requires { value.shape_; }) {
+                    const auto slot = cache_->open_stamp();
+                    for (const auto& val : value.values_) {
+                        digest = mix(digest ^ stamp_value(val));
+                    }
+                    cache_->close_stamp(slot, digest);
+                } else if constexpr (std::is_same_v<T, typename JsonType::number_array>) {
+                    cache_->close_stamp(cache_->open_stamp(), digest);
+                }
+                return digest;
+            });
+        }
+
+        // the splitmix64 finalizer, so that the digest depends on the order of the revisions
+        static auto mix(std::uint64_t x) noexcept -> std::uint64_t {
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+            return x ^ (x >> 31);
+        }
+
+        template <typename JsonType, typename Container>
+        auto dump_cached(const Container& value, const std::size_t level) -> void {
+            const auto digest = cache_->stamp();
+            if (const auto bytes = cache_->find(&value, digest, level)) {
+                sink_.write(bytes->data(), bytes->size());
+                cache_->reuse(&value);
+                return;
+            }
+            cache_->enter();
+            if constexpr (std::is_same_v<Sink, string_sink>) {
+                const auto start = sink_.str().size();
+                dump_container<JsonType>(value, level);
+                const auto size = sink_.str().size() - start;
+                cache_->leave(&value, digest, level,
+                    cache_->worth_storing(size) ? sink_.str().substr(start) : std::string{});
+            } else {
+                auto bytes = std::string{};
+                auto sink = string_sink{bytes};
+                auto serializer = json_serializer<string_sink>{sink, *cache_};
+                serializer.template dump_container<JsonType>(value, level);
+                sink_.write(bytes.data(), bytes.size());
+                cache_->leave(&value, digest, level, std::move(bytes));
+            }
+        }
+
+        template <typename JsonType, typename Container>
+        auto dump_container(const Container& value, const std::size_t level) -> void {
+            if constexpr (std::is_same_v<Container, typename JsonType::object>) {
+                auto first = true;
+                open('{', value.empty());
+                for (const auto& [key, val] : value) {
+                    write_member(key, val, level, first);
+                }
+                close('}', value.empty(), level);
+            } else if constexpr (requires { value.shape_; }) {
+                auto first = true;
+                open('{', value.values_.empty());
+                for (std::size_t i = 0; i < value.values_.size(); ++i) {
+                    write_member(value.shape_->key(i), value.values_[i], level, first);
+                }
+                close('}', value.values_.empty(), level);
+            } else {
+                auto first = true;
+                open('[', value.empty());
+                for (const auto& val : value) {
+                    separate(level + 1, first);
+                    if constexpr (std::is_same_v<std::remove_cvref_t<decltype(val)>, JsonType>) {
+                        dump_value(val, level + 1);
+                    } else {
+                        write_number(val);
+                    }
+                }
+                close(']', value.empty(), level);
+            }
+        }
+
+        template <typename Key, typename JsonType>
+        auto write_member(const Key& key, const JsonType& val, const std::size_t level, bool& first) -> void {
+            separate(level + 1, first);
+            write_string(std::string_view{key});
+            sink_.write(": ", 2);
+            dump_value(val, level + 1);
+        }
+
+        auto open(const char bracket, const bool empty) -> void {
+            sink_.put(bracket);
+            if (not empty and options_.indent != 0) {
+                sink_.put('\n');
+            }
+        }
+
+        auto close(const char bracket, const bool empty, const std::size_t level) -> void {
+            if (not empty and options_.indent != 0) {
+                sink_.put('\n');
+                write_indent(level);
+            }
+            sink_.put(bracket);
+        }
+
+        auto separate(const std::size_t level, bool& first) -> void {
+            if (not first) {
+                (options_.indent != 0) ? sink_.write(",\n", 2) : sink_.write(", ", 2);
+            }
+            first = false;
+            write_indent(level);
+        }
+
+        auto write_indent(const std::size_t level) -> void {
+            if constexpr (measuring) {
+                sink_.skip(level * options_.indent);
+                return;
+            }
+            for (auto n = level * options_.indent; n > 0; --n) {
+                sink_.put(' ');
+            }
+        }
+
+        template <typename Number>
+        auto write_number(const Number n) -> void {
+            if constexpr (measuring) {
+                sink_.skip(formatted_size(n));
+                return;
+            }
+            char buffer[_NUMBER_BUFFER_SIZE];
+            const auto last = format_number(buffer, buffer + _NUMBER_BUFFER_SIZE, n);
+            sink_.write(buffer, static_cast<std::size_t>(last - buffer));
+        }
+
+        auto write_string(const std::string_view str) -> void {
+            sink_.put('"');
+            auto i = std::size_t{0};
+            while (i < str.size()) {
+                const auto clean = simd::find_escape(str.data() + i, str.size() - i, options_.ascii_only);
+                if constexpr (requires { sink_.write_ref(str.data(), clean); }) {
+                    sink_.write_ref(str.data() + i, clean);
+                } else {
+                    sink_.write(str.data() + i, clean);
+                }
+                i += clean;
+                if (i < str.size()) {
+                    i = write_escaped(str, i);
+                }
+            }
+            sink_.put('"');
+        }
+
+        // escapes the character starting at str[i] and returns the index of the next one
+        auto write_escaped(const std::string_view str, const std::size_t i) -> std::size_t {
+            const auto c = static_cast<unsigned char>(str[i]);
+            switch (c) {
+                case '"':
+                    sink_.write("\\\"", 2);
+                    break;
+                case '\\':
+                    sink_.write("\\\\", 2);
+                    break;
+                case '\b':
+                    sink_.write("\\b", 2);
+                    break;
+                case '\f':
+                    sink_.write("\\f", 2);
+                    break;
+                case '\n':
+                    sink_.write("\\n", 2);
+                    break;
+                case '\r':
+                    sink_.write("\\r", 2);
+                    break;
+                case '\t':
+                    sink_.write("\\t", 2);
+                    break;
+                default:
+                    if (c < 0x80) {
+                        write_unicode_escape(c);
+                        break;
+                    }
+                    return write_escaped_utf8(str, i);
+            }
+            return i + 1;
+        }
+
+        // decodes one utf-8 sequence; malformed bytes are replaced with U+FFFD one at a time
+        auto write_escaped_utf8(const std::string_view str, const std::size_t i) -> std::size_t {
+            const auto c = static_cast<unsigned char>(str[i]);
+            const auto length = (c >= 0xF0 and c < 0xF5) ? 4u : (c >= 0xE0) ? 3u : (c >= 0xC2) ? 2u : 0u;
+            if (length == 0 or c >= 0xF5 or i + length > str.size()) {
+                write_unicode_escape(_REPLACEMENT_CHARACTER);
+                return i + 1;
+            }
+            auto code_point = static_cast<std::uint32_t>(c & (0x7Fu >> length));
+            for (std::size_t k = 1; k < length; ++k) {
+                const auto continuation = static_cast<unsigned char>(str[i + k]);
+                if ((continuation & 0xC0) != 0x80) {
+                    write_unicode_escape(_REPLACEMENT_CHARACTER);
+                    return i + 1;
+                }
+                code_point = (code_point << 6) | (continuation & 0x3Fu);
+            }
+            const auto overlong = (length == 3 and code_point < 0x800) or (length == 4 and code_point < 0x10000);
+            if (overlong or code_point > 0x10FFFF or (code_point >= 0xD800 and code_point < 0xE000)) {
+                write_unicode_escape(_REPLACEMENT_CHARACTER);
+                return i + 1;
+            }
+            if (code_point >= 0x10000) {
+                code_point -= 0x10000;
+                write_unicode_escape(0xD800 + (code_point >> 10));
+                write_unicode_escape(0xDC00 + (code_point & 0x3FF));
+            } else {
+                write_unicode_escape(code_point);
+            }
+            return i + length;
+        }
+
+        auto write_unicode_escape(const std::uint32_t code_unit) -> void {
+            if constexpr (measuring) {
+                sink_.skip(6);
+                return;
+            }
+            constexpr auto hex_digits = "0123456789abcdef";
+            const char escape[6] = {
+                '\\', 'u', hex_digits[(code_unit >> 12) & 0xF], hex_digits[(code_unit >> 8) & 0xF],
+                hex_digits[(code_unit >> 4) & 0xF], hex_digits[code_unit & 0xF]
+            };
+            sink_.write(escape, 6);
+        }
+
+        auto write(const std::string_view str) -> void {
+            sink_.write(str.data(), str.size());
+        }
+
+        // a counting_sink only needs the length of the output, which for indentation, numbers
+        // and unicode escapes is worked out without forming them
+        static constexpr auto measuring = std::is_same_v<Sink, counting_sink>;
+
+        Sink& sink_;
+        dump_options options_;
+        fragment_cache* cache_ = nullptr;
+    };
+}
+
+
+#endif
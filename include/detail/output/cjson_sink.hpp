@@ -0,0 +1,116 @@
+#ifndef CJSON_SINK_HPP
+#define CJSON_SINK_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace cjson::detail::output {
+    template <typename Sink>
+    concept json_sink = requires (Sink sink, char c, const char* str, std::size_t n) {
+        sink.put(c);
+        sink.write(str, n);
+    };
+
+    class string_sink {
+    public:
+        explicit string_sink(std::string& str) noexcept
+            : str_{str} {}
+
+        auto put(const char c) -> void {
+            str_.push_back(c);
+        }
+
+        auto write(const char* str, const std::size_t n) -> void {
+            str_.append(str, n);
+        }
+
+        auto str() const noexcept -> const std::string& {
+            return str_;
+        }
+
+    private:
+        std::string& str_;
+    };
+
+    // discards the output and only counts its length
+    class counting_sink {
+    public:
+        auto put(const char) noexcept -> void {
+            ++size_;
+        }
+
+        auto write(const char*, const std::size_t n) noexcept -> void {
+            size_ += n;
+        }
+
+        // counts n bytes that the serializer did not form
+        auto skip(const std::size_t n) noexcept -> void {
+            size_ += n;
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return size_;
+        }
+
+    private:
+        std::size_t size_ = 0;
+    };
+
+    // writes into the caller-provided buffer [first, last), e.g. sized with counting_sink
+    // beforehand. a write that does not fit throws std::length_error, leaving what was written
+    // before it in place
+    class span_sink {
+    public:
+        span_sink(char* first, char* last) noexcept
+            : first_{first}, current_{first}, last_{last} {}
+
+        auto put(const char c) -> void {
+            check_room(1);
+            *current_++ = c;
+        }
+
+        auto write(const char* str, const std::size_t n) -> void {
+            check_room(n);
+            current_ = std::copy_n(str, n, current_);
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return static_cast<std::size_t>(current_ - first_);
+        }
+
+    private:
+        auto check_room(const std::size_t n) const -> void {
+            if (n > static_cast<std::size_t>(last_ - current_)) {
+                throw std::length_error("json output does not fit the buffer");
+            }
+        }
+
+        char* first_;
+        char* current_;
+        char* last_;
+    };
+
+    class stream_sink {
+    public:
+        explicit stream_sink(std::ostream& os) noexcept
+            : os_{os} {}
+
+        auto put(const char c) -> void {
+            os_.put(c);
+        }
+
+        auto write(const char* str, const std::size_t n) -> void {
+            os_.write(str, static_cast<std::streamsize>(n));
+        }
+
+    private:
+        std::ostream& os_;
+    };
+}
+
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef CJSON_SNAPSHOT_WRITER_HPP
+#define CJSON_SNAPSHOT_WRITER_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../cjson_snapshot_format.hpp"
+
+namespace cjson::detail::output {
+    // lays out a json value in the snapshot format (see cjson_snapshot_format.hpp) so that it
+    // can be written to a file once and navigated in place with snapshot_view afterwards
+    class snapshot_writer {
+    public:
+        explicit snapshot_writer(std::string& buffer) noexcept
+            : buffer_{buffer} {}
+
+        template <typename JsonType>
+        auto dump(const JsonType& js) -> void {
+            buffer_.clear();
+            buffer_.resize(sizeof(snapshot::header));
+            write_dictionary(js);
+            const auto root = write_value(js);
+
+            auto head = snapshot::header{};
+            std::memcpy(head.magic, _SNAPSHOT_MAGIC, _SNAPSHOT_MAGIC_SIZE);
+            head.endian_mark = _SNAPSHOT_ENDIAN_MARK;
+            head.size = buffer_.size();
+            head.dictionary = sizeof(snapshot::header);
+            head.root = root;
+            std::memcpy(buffer_.data(), &head, sizeof(head));
+            keys_.clear();
+        }
+
+    private:
+        template <typename JsonType>
+        auto write_dictionary(const JsonType& js) -> void {
+            auto keys = std::vector<std::string_view>{};
+            collect_keys(js, keys);
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+            if (keys.size() > std::numeric_limits<std::uint32_t>::max()) {
+                throw std::length_error("too many distinct keys for a snapshot");
+            }
+
+            const auto table = begin_block(keys.size(), sizeof(snapshot::dictionary_entry));
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                const auto entry = snapshot::dictionary_entry{write_bytes(keys[i]), keys[i].size()};
+                std::memcpy(buffer_.data() + table + i * sizeof(entry), &entry, sizeof(entry));
+                keys_.emplace(keys[i], static_cast<std::uint32_t>(i));
+            }
+        }
+
+        template <typename JsonType>
+        static auto collect_keys(const JsonType& js, std::vector<std::string_view>& keys) -> void {
+            js.visit([&](const auto& value) {
+                using T = std::remove_cvref_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, typename JsonType::object>) {
+                    for (const auto& [key, val] : value) {
+                        keys.emplace_back(key);
+                        collect_keys(val, keys);
+                    }
+                } else if constexpr (requires { value.shape_; }) {
+                    for (std::size_t i = 0; i < value.values_.size(); ++i) {
+                        keys.emplace_back(value.shape_->key(i));
+                        collect_keys(value.values_[i], keys);
+                    }
+                } else if constexpr (std::is_same_v<T, typename JsonType::array>) {
+                    for (const auto& val : value) {
+                        collect_keys(val, keys);
+                    }
+                }
+            });
+        }
+
+        template <typename JsonType>
+        auto write_value(const JsonType& js) -> snapshot::slot {
+            return js.visit([&](const auto& value) {
+                using T = std::remove_cvref_t<decltype(value)>;
+                if constexpr (std::is_null_pointer_v<T>) {
+                    return make_slot(snapshot::slot_type::_NULL, 0);
+                } else if constexpr (std::is_same_v<T, typename JsonType::boolean>) {
+                    return make_slot(snapshot::slot_type::_BOOLEAN, value ? 1 : 0);
+                } else if constexpr (std::is_same_v<T, typename JsonType::number>) {
+                    return make_slot(snapshot::slot_type::_NUMBER, std::bit_cast<std::uint64_t>(static_cast<double>(value)));
+                } else if constexpr (std::is_same_v<T, typename JsonType::string>) {
+                    return make_slot(snapshot::slot_type::_STRING, write_string(value));
+                } else if constexpr (std::is_same_v<T, typename JsonType::object>) {
+                    auto members = std::vector<std::pair<std::uint32_t, const JsonType*>>{};
+                    members.reserve(value.size());
+                    for (const auto& [key, val] : value) {
+                        members.emplace_back(keys_.at(std::string_view{key}), &val);
+                    }
+                    return make_slot(snapshot::slot_type::_OBJECT, write_members(members));
+                } else if constexpr (requires { value.shape_; }) {
+                    auto members = std::vector<std::pair<std::uint32_t, const JsonType*>>{};
+                    members.reserve(value.values_.size());
+                    for (std::size_t i = 0; i < value.values_.size(); ++i) {
+                        members.emplace_back(keys_.at(std::string_view{value.shape_->key(i)}), &value.values_[i]);
+                    }
+                    return make_slot(snapshot::slot_type::_OBJECT, write_members(members));
+                } else if constexpr (std::is_same_v<T, typename JsonType::array>) {
+                    const auto block = begin_block(value.size(), sizeof(snapshot::slot));
+                    for (std::size_t i = 0; i < value.size(); ++i) {
+                        const auto element = write_value(value[i]);
+                        std::memcpy(slot_address(block, i), &element, sizeof(element));
+                    }
+                    return make_slot(snapshot::slot_type::_ARRAY, block - sizeof(std::uint64_t));
+                } else {
+                    const auto block = begin_block(value.size(), sizeof(double));
+                    for (std::size_t i = 0; i < value.size(); ++i) {
+                        const auto number = static_cast<double>(value[i]);
+                        std::memcpy(buffer_.data() + block + i * sizeof(double), &number, sizeof(number));
+                    }
+                    return make_slot(snapshot::slot_type::_NUMBER_ARRAY, block - sizeof(std::uint64_t));
+                }
+            });
+        }
+
+        // members are written in key order, which is the dictionary order
+        template <typename JsonType>
+        auto write_members(std::vector<std::pair<std::uint32_t, const JsonType*>>& members) -> std::uint64_t {
+            std::sort(members.begin(), members.end(), [](const auto& m1, const auto& m2) {
+                return m1.first < m2.first;
+            });
+            const auto block = begin_block(members.size(), sizeof(snapshot::slot));
+            for (std::size_t i = 0; i < members.size(); ++i) {
+                auto member = write_value(*members[i].second);
+                member.key = members[i].first;
+                std::memcpy(slot_address(block, i), &member, sizeof(member));
+            }
+            return block - sizeof(std::uint64_t);
+        }
+
+        auto write_string(const std::string_view str) -> std::uint64_t {
+            const auto block = begin_block(str.size(), 1);
+            std::memcpy(buffer_.data() + block, str.data(), str.size());
+            return block - sizeof(std::uint64_t);
+        }
+
+        // key bytes in the dictionary go without a count, their size is in the table
+        auto write_bytes(const std::string_view str) -> std::uint64_t {
+            const auto offset = buffer_.size();
+            buffer_.append(str);
+            buffer_.resize(snapshot::align(buffer_.size()));
+            return offset;
+        }
+
+        // appends an aligned block holding count and room for count elements of element_size
+        // bytes, and returns the offset of the first element
+        auto begin_block(const std::size_t count, const std::size_t element_size) -> std::size_t {
+            const auto offset = buffer_.size();
+            const auto count_field = static_cast<std::uint64_t>(count);
+            buffer_.resize(snapshot::align(offset + sizeof(count_field) + count * element_size));
+            std::memcpy(buffer_.data() + offset, &count_field, sizeof(count_field));
+            return offset + sizeof(count_field);
+        }
+
+        auto slot_address(const std::size_t block, const std::size_t i) noexcept -> char* {
+            return buffer_.data() + block + i * sizeof(snapshot::slot);
+        }
+
+        static auto make_slot(const snapshot::slot_type type, const std::uint64_t payload) noexcept -> snapshot::slot {
+            auto result = snapshot::slot{};
+            result.type = type;
+            result.payload = payload;
+            return result;
+        }
+
+        std::string& buffer_;
+        std::unordered_map<std::string_view, std::uint32_t> keys_;
+    };
+}
+
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef CJSON_STRUCT_SERIALIZER_HPP
+#define CJSON_STRUCT_SERIALIZER_HPP
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../cjson_describe.hpp"
+#include "cjson_dump_options.hpp"
+#include "cjson_serializer.hpp"
+#include "cjson_sink.hpp"
+
+#define _MEMBER_SEPARATOR_SIZE 2
+
+namespace cjson::detail::output {
+    namespace members {
+        // the json spelling of a key, quotes included: only quotes, backslashes and control
+        // characters are escaped, so ascii_only does not apply to keys
+        constexpr auto escaped_size(const std::string_view key) noexcept -> std::size_t {
+            auto size = std::size_t{2};
+            for (const auto c : key) {
+                if (c == '"' or c == '\\') {
+                    size += 2;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    size += 6;
+                } else {
+                    ++size;
+                }
+            }
+            return size;
+        }
+
+        // ", " then the escaped key and ": ", so that a member after the first costs one write
+        // when not indenting, and the key alone is the part from _MEMBER_SEPARATOR_SIZE on
+        template <std::size_t N>
+        constexpr auto member_prefix(const std::string_view key) noexcept -> std::array<char, N> {
+            constexpr auto hex_digits = "0123456789abcdef";
+            auto prefix = std::array<char, N>{',', ' ', '"'};
+            auto i = std::size_t{3};
+            for (const auto c : key) {
+                const auto byte = static_cast<unsigned char>(c);
+                if (c == '"' or c == '\\') {
+                    prefix[i++] = '\\';
+                    prefix[i++] = c;
+                } else if (byte < 0x20) {
+                    for (const auto e : {'\\', 'u', '0', '0', hex_digits[byte >> 4], hex_digits[byte & 0xF]}) {
+                        prefix[i++] = e;
+                    }
+                } else {
+                    prefix[i++] = c;
+                }
+            }
+            prefix[i++] = '"';
+            prefix[i++] = ':';
+            prefix[i] = ' ';
+            return prefix;
+        }
+
+        template <reflect::described T, std::size_t I>
+        inline constexpr auto prefix_v = member_prefix<escaped_size(std::get<I>(reflect::fields_v<T>).name_) + 4>(
+            std::get<I>(reflect::fields_v<T>).name_);
+
+        template <typename T>
+        struct is_optional: std::false_type {};
+
+        template <typename T>
+        struct is_optional<std::optional<T>>: std::true_type {};
+
+        template <typename T>
+        concept map_like = std::ranges::input_range<T> and requires (const T& value) {
+            typename T::mapped_type;
+            std::string_view{value.begin()->first};
+        };
+    }
+
+    // writes structs described with CJSON_DESCRIBE, and the types struct_parser reads, straight
+    // to a sink in the layout json_serializer gives the equivalent basic_json. the quoted keys are
+    // spelled out at compile time. a disengaged std::optional is written as null
+    template <json_sink Sink>
+    class struct_serializer {
+    public:
+        explicit struct_serializer(Sink& sink, const dump_options& options = {}) noexcept
+            : json_{sink, options} {}
+
+        template <typename T>
+        auto dump(const T& value) -> void {
+            dump_value(value, 0);
+        }
+
+    private:
+        template <typename T>
+        auto dump_value(const T& value, const std::size_t level) -> void {
+            if constexpr (reflect::described<T>) {
+                dump_struct(value, level);
+            } else if constexpr (std::same_as<T, bool>) {
+                value ? json_.write(_TRUE_LITERAL) : json_.write(_FALSE_LITERAL);
+            } else if constexpr (std::is_arithmetic_v<T>) {
+                json_.write_number(value);
+            } else if constexpr (std::is_null_pointer_v<T>) {
+                json_.write(_NULL_LITERAL);
+            } else if constexpr (std::convertible_to<const T&, std::string_view>) {
+                json_.write_string(std::string_view{value});
+            } else if constexpr (members::is_optional<T>::value) {
+                value ? dump_value(*value, level) : json_.write(_NULL_LITERAL);
+            } else if constexpr (members::map_like<T>) {
+                auto first = true;
+                json_.open('{', std::ranges::empty(value));
+                for (const auto& [key, val] : value) {
+                    json_.separate(level + 1, first);
+                    json_.write_string(std::string_view{key});
+                    json_.write(": ");
+                    dump_value(val, level + 1);
+                }
+                json_.close('}', std::ranges::empty(value), level);
+            } else if constexpr (std::ranges::input_range<T>) {
+                auto first = true;
+                json_.open('[', std::ranges::empty(value));
+                for (const auto& val : value) {
+                    json_.separate(level + 1, first);
+                    dump_value(val, level + 1);
+                }
+                json_.close(']', std::ranges::empty(value), level);
+            } else {
+                static_assert(not std::is_same_v<T, T>, "no json mapping for this type: describe it with CJSON_DESCRIBE");
+            }
+        }
+
+        template <reflect::described T>
+        auto dump_struct(const T& value, const std::size_t level) -> void {
+            constexpr auto empty = reflect::field_count<T> == 0;
+            json_.open('{', empty);
+            [&]<std::size_t ...I>(std::index_sequence<I...>) {
+                (dump_member<T, I>(value, level), ...);
+            }(std::make_index_sequence<reflect::field_count<T>>{});
+            json_.close('}', empty, level);
+        }
+
+        template <typename T, std::size_t I>
+        auto dump_member(const T& value, const std::size_t level) -> void {
+            constexpr auto& prefix = members::prefix_v<T, I>;
+            if (json_.options_.indent == 0) {
+                constexpr auto skip = std::size_t{I == 0 ? _MEMBER_SEPARATOR_SIZE : 0};
+                json_.sink_.write(prefix.data() + skip, prefix.size() - skip);
+            } else {
+                auto first = I == 0;
+                json_.separate(level + 1, first);
+                json_.sink_.write(prefix.data() + _MEMBER_SEPARATOR_SIZE, prefix.size() - _MEMBER_SEPARATOR_SIZE);
+            }
+            dump_value(value.*std::get<I>(reflect::fields_v<T>).member_, level + 1);
+        }
+
+        json_serializer<Sink> json_;
+    };
+}
+
+
+#endif
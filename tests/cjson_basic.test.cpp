@@ -0,0 +1,388 @@
+#include <catch2/catch.hpp>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+auto parse(std::string_view str) -> cjson::json {
+    return cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{std::move(str)}.parse();
+}
+
+auto dump(const cjson::json& js) -> std::string {
+    auto os = std::ostringstream{};
+    os << js;
+    return os.str();
+}
+
+TEST_CASE("Numeric arrays are parsed into the typed representation") {
+    auto js = parse("[1, -2.5, 3e2, 0]");
+    REQUIRE(js.is_number_array());
+    REQUIRE(js.size() == 4);
+    REQUIRE(js.sum() == Approx(298.5));
+    REQUIRE(js.min() == -2.5);
+    REQUIRE(js.max() == 300.0);
+
+    auto mixed = parse(R"([1, 2, "three", 4])");
+    REQUIRE_FALSE(mixed.is_number_array());
+    REQUIRE(mixed.size() == 4);
+    REQUIRE_THROWS_AS(mixed.sum(), cjson::detail::json_type_error);
+}
+
+TEST_CASE("Numeric arrays compare equal to their generic form") {
+    const auto typed = parse("[1, 2, 3]");
+    const auto generic = cjson::json{cjson::json{1}, cjson::json{2}, cjson::json{3}};
+    REQUIRE(typed.is_number_array());
+    REQUIRE_FALSE(generic.is_number_array());
+    REQUIRE(typed == generic);
+    REQUIRE(generic == typed);
+    REQUIRE(typed == parse("[1, 2, 3]"));
+    REQUIRE_FALSE(typed == parse("[1, 2, 4]"));
+    REQUIRE(generic.sum() == 6.0);
+}
+
+TEST_CASE("A const numeric array hands out its elements as json values and stays typed") {
+    const auto js = parse("[1, 2.5, -3]");
+    REQUIRE(js.is_number_array());
+    auto seen = std::vector<cjson::json>{};
+    for (const auto& val : js) {
+        REQUIRE(val.is_number());
+        seen.push_back(val);
+    }
+    REQUIRE(seen == std::vector<cjson::json>{cjson::json{1}, cjson::json{2.5}, cjson::json{-3}});
+    REQUIRE(std::distance(js.cbegin(), js.cend()) == 3);
+    REQUIRE(js[1] == cjson::json{2.5});
+    REQUIRE(&js[1] == &js.at(1));
+    REQUIRE(&js.front() == &js[0]);
+    REQUIRE(js.back() == cjson::json{-3});
+    REQUIRE_THROWS_AS(js.at(3), std::out_of_range);
+    REQUIRE(static_cast<const cjson::json::array&>(js).size() == 3);
+    REQUIRE(js.is_number_array());
+
+    auto other = parse("[1, 2, 3]");
+    const auto& const_other = other;
+    const auto& second = const_other[1];
+    other.numbers()[1] = cjson::json{7};
+    REQUIRE(second == cjson::json{7});
+    REQUIRE(other.is_number_array());
+    other.push_back(cjson::json{4});
+    REQUIRE(const_other.back() == cjson::json{4});
+    REQUIRE(const_other.size() == 4);
+    REQUIRE(other.is_number_array());
+    const auto& first = const_other[0];
+    other[0] = cjson::json{"one"};
+    REQUIRE(&first == &other[0]);
+    REQUIRE(first == cjson::json{"one"});
+    REQUIRE_FALSE(other.is_number_array());
+}
+
+TEST_CASE("Numeric arrays stay typed on numeric appends and writes, and promote on generic element access") {
+    auto js = parse("[1, 2, 3]");
+    js.push_back(cjson::json{4});
+    js.pop_back();
+    js.push_back(cjson::json{5});
+    REQUIRE(js.is_number_array());
+    REQUIRE(dump(js) == dump(parse("[1, 2, 3, 5]")));
+
+    js.push_back(cjson::json{"six"});
+    REQUIRE_FALSE(js.is_number_array());
+    REQUIRE(js.size() == 5);
+
+    auto other = parse("[1, 2, 3]");
+    const auto& const_other = other;
+    auto total = 0;
+    for (const auto val : const_other.numbers()) {
+        REQUIRE(val == cjson::json{++total});
+    }
+    REQUIRE(total == 3);
+    REQUIRE(const_other.numbers().size() == 3);
+    STATIC_REQUIRE(std::bidirectional_iterator<cjson::json::const_number_view::iterator>);
+    REQUIRE(const_other.numbers()[0] == cjson::json{1});
+    REQUIRE(static_cast<double>(const_other.numbers().at(2)) == 3.0);
+    REQUIRE_THROWS_AS(const_other.numbers().at(3), std::out_of_range);
+    REQUIRE(std::ranges::prev(const_other.numbers().end()) == std::ranges::next(const_other.numbers().begin(), 2));
+    REQUIRE(*const_other.begin() == cjson::json{1});
+    REQUIRE(const_other[0] == cjson::json{1});
+    REQUIRE(static_cast<const cjson::json::array&>(const_other).size() == 3);
+    REQUIRE_THROWS_AS(parse(R"([1, "2"])").numbers(), cjson::detail::json_type_error);
+    REQUIRE(other.is_number_array());
+
+    other.numbers()[1] = cjson::json{7};
+    *std::ranges::next(other.numbers().begin(), 2) = cjson::json{8};
+    REQUIRE(other.is_number_array());
+    REQUIRE(other == parse("[1, 7, 8]"));
+
+    cjson::json& first = other[0];
+    REQUIRE_FALSE(other.is_number_array());
+    REQUIRE(first == cjson::json{1});
+    first = cjson::json{true};
+    REQUIRE(other == cjson::json{cjson::json{true}, cjson::json{7}, cjson::json{8}});
+    other.erase(std::next(other.cbegin()));
+    REQUIRE(other == cjson::json{cjson::json{true}, cjson::json{8}});
+}
+
+TEST_CASE("Assigning a non-number while iterating a numeric array promotes it in place") {
+    auto js = parse("[1, 2, 3]");
+    auto seen = std::vector<double>{};
+    for (auto element : js.numbers()) {
+        seen.push_back(static_cast<double>(element));
+        element = cjson::json{"s"};
+        REQUIRE(element == cjson::json{"s"});
+    }
+    REQUIRE(seen == std::vector<double>{1, 2, 3});
+    REQUIRE_FALSE(js.is_number_array());
+    REQUIRE(js == cjson::json{cjson::json{"s"}, cjson::json{"s"}, cjson::json{"s"}});
+
+    auto other = parse("[4, 5]");
+    const auto numbers = other.numbers();
+    const auto second = numbers[1];
+    numbers[0] = cjson::json{nullptr};
+    REQUIRE(static_cast<double>(second) == 5.0);
+    REQUIRE_THROWS_AS(static_cast<double>(numbers.front()), cjson::detail::json_type_error);
+}
+
+TEST_CASE("Element access hands out references to the stored values") {
+    auto js = parse(R"([{"a": 1}, "b", [1, 2]])");
+    cjson::json& first = js[0];
+    cjson::json& front = js.front();
+    cjson::json& back = js.back();
+    cjson::json& element = *js.begin();
+    REQUIRE(&first == &front);
+    REQUIRE(&first == &element);
+    REQUIRE(&back == &js.at(2));
+    REQUIRE(&std::as_const(js)[1] == &*std::next(js.begin()));
+    REQUIRE(back.is_array());
+    REQUIRE(back.is_number_array());
+    REQUIRE(std::vector<cjson::json>{js.rbegin(), js.rend()}.front() == back);
+
+    auto numbers = parse("[1, 2]");
+    REQUIRE(numbers.front() == cjson::json{1});
+    REQUIRE_FALSE(numbers.is_number_array());
+}
+
+TEST_CASE("Numeric reductions over long arrays") {
+    auto str = std::string{"["};
+    for (int i = 1; i <= 1001; ++i) {
+        str += std::to_string(i) + (i < 1001 ? "," : "]");
+    }
+    const auto js = parse(str);
+    REQUIRE(js.is_number_array());
+    REQUIRE(js.sum() == 501501.0);
+    REQUIRE(js.min() == 1.0);
+    REQUIRE(js.max() == 1001.0);
+    REQUIRE(parse("[1]").sum() == 1.0);
+    const auto generic = cjson::json{cjson::json{2}, cjson::json{-1}, cjson::json{5}};
+    REQUIRE(generic.sum() == 6.0);
+    REQUIRE(generic.min() == -1.0);
+    REQUIRE(generic.max() == 5.0);
+    REQUIRE_THROWS_AS(cjson::json{}.min(), cjson::detail::json_type_error);
+    REQUIRE_THROWS_AS(parse(R"([1, "2"])").max(), cjson::detail::json_type_error);
+    REQUIRE_THROWS_AS(cjson::json{cjson::json::array{}}.min(), std::out_of_range);
+}
+
+TEST_CASE("Objects with the same key sequence share one shape") {
+    auto parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{
+        cjson::detail::input::parse_options{.shared_shapes = true},
+        std::string_view{R"([{"b": 1, "a": "x"}, {"b": 2, "a": "y"}, {"b": 3, "c": true}, {"a": 4, "a": 5}])"}};
+    auto js = parser.parse();
+    REQUIRE(js.size() == 4);
+    REQUIRE(js[0].is_shaped_object());
+    REQUIRE(js[1].is_shaped_object());
+    REQUIRE(js[2].is_shaped_object());
+    REQUIRE_FALSE(js[3].is_shaped_object());
+
+    REQUIRE(js[0].at("a") == cjson::json{"x"});
+    REQUIRE(js[1].at("b") == cjson::json{2});
+    REQUIRE(js[2].contains("c"));
+    REQUIRE_FALSE(js[2].contains("a"));
+    REQUIRE_THROWS_AS(js[2].at("a"), std::out_of_range);
+    REQUIRE(js[3].at("a") == cjson::json{4});
+
+    REQUIRE(js[0] == parse(R"({"a": "x", "b": 1})"));
+    REQUIRE(parse(R"({"a": "x", "b": 1})") == js[0]);
+    REQUIRE_FALSE(js[0] == js[1]);
+    REQUIRE(dump(js[1]) == R"({"a": "y", "b": 2})");
+
+    const auto& shaped = std::as_const(js)[0];
+    auto values = std::vector<cjson::json>{shaped.begin(), shaped.end()};
+    REQUIRE(values == std::vector<cjson::json>{cjson::json{"x"}, cjson::json{1}});
+    REQUIRE(shaped.is_shaped_object());
+    REQUIRE_THROWS_AS(static_cast<const cjson::json::object&>(shaped), cjson::detail::json_type_error);
+    auto members = std::vector<std::pair<std::string, cjson::json>>{};
+    for (const auto& [key, val] : shaped.items()) {
+        members.emplace_back(key, val);
+    }
+    REQUIRE(members == std::vector<std::pair<std::string, cjson::json>>{{"a", cjson::json{"x"}}, {"b", cjson::json{1}}});
+    REQUIRE(shaped.items().size() == 2);
+    REQUIRE(shaped.items().at("b") == cjson::json{1});
+    REQUIRE(shaped.items().contains("a"));
+    REQUIRE(shaped.items().find("c") == shaped.items().end());
+    REQUIRE(js[3].items().at("a") == cjson::json{4});
+    REQUIRE_THROWS_AS(js.items(), cjson::detail::json_type_error);
+
+    for (auto&& val : js[1]) {
+        REQUIRE_FALSE(val.is_null());
+    }
+    *js[1].begin() = cjson::json{"w"};
+    REQUIRE(js[1].is_shaped_object());
+    REQUIRE(js[1].at("a") == cjson::json{"w"});
+    REQUIRE(static_cast<cjson::json::object&>(js[2]).size() == 2);
+    REQUIRE_FALSE(js[2].is_shaped_object());
+    REQUIRE(js[2] == parse(R"({"b": 3, "c": true})"));
+    js[0].erase(js[0].cbegin());
+    REQUIRE(js[0] == parse(R"({"b": 1})"));
+
+    js[1].at("a") = cjson::json{"z"};
+    REQUIRE(js[1].is_shaped_object());
+    REQUIRE(js[1].erase(cjson::json::object::key_type{"c"}) == 0);
+    REQUIRE(js[1].is_shaped_object());
+    js[1].emplace("c", cjson::json{nullptr});
+    REQUIRE_FALSE(js[1].is_shaped_object());
+    REQUIRE(js[1] == parse(R"({"a": "z", "b": 2, "c": null})"));
+
+    auto cleared = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{
+        cjson::detail::input::parse_options{.shared_shapes = true}, std::string_view{R"([{"a": 1}, {"a": 2}])"}}.parse();
+    REQUIRE(cleared[1].is_shaped_object());
+    cleared[1].clear();
+    REQUIRE(cleared[1].empty());
+    REQUIRE(cleared[1].is_object());
+    REQUIRE_FALSE(cleared[1].is_shaped_object());
+    REQUIRE(cleared[1] == cjson::json{cjson::json::object{}});
+}
+
+TEST_CASE("Typed values can be read from several threads at once") {
+    auto parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{
+        cjson::detail::input::parse_options{.shared_shapes = true},
+        std::string_view{R"([[1, 2, 3, 4, 5, 6, 7, 8], {"a": 1, "b": 2}, {"a": 3, "b": 4}])"}};
+    const auto js = parser.parse();
+    const auto read = [&] {
+        auto total = 0.0;
+        for (int round = 0; round < 1000; ++round) {
+            for (const auto element : js[0].numbers()) {
+                total += static_cast<double>(element);
+            }
+            for (const auto& element : js[0]) {
+                total += static_cast<double>(element);
+            }
+            for (const auto& val : js) {
+                if (val.is_shaped_object()) {
+                    for (const auto& element : val) {
+                        total += static_cast<double>(element);
+                    }
+                }
+            }
+        }
+        return total;
+    };
+    auto other = 0.0;
+    auto thread = std::thread{[&] { other = read(); }};
+    const auto total = read();
+    thread.join();
+    REQUIRE(total == 82000.0);
+    REQUIRE(other == total);
+    REQUIRE(js[0].is_number_array());
+    REQUIRE(js[1].is_shaped_object());
+}
+
+TEST_CASE("Interned object keys share storage across documents") {
+    using interned_parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::interned_json>;
+    const auto js1 = interned_parser{std::string_view{R"({"interned_id": 1, "interned_name": "a"})"}}.parse();
+    const auto pool_size = cjson::detail::string_pool::global().size();
+    const auto js2 = interned_parser{std::string_view{R"({"interned_name": "a", "interned_id": 1})"}}.parse();
+    REQUIRE(cjson::detail::string_pool::global().size() == pool_size);
+
+    REQUIRE(js1 == js2);
+    REQUIRE(js1.at("interned_name") == cjson::interned_json{"a"});
+    REQUIRE(js2.contains("interned_id"));
+    REQUIRE_FALSE(js2.contains("interned_missing"));
+
+    const auto key1 = cjson::interned_string{"interned_id"};
+    const auto key2 = cjson::interned_string{std::string{"interned_id"}};
+    REQUIRE(key1 == key2);
+    REQUIRE(key1.data() == key2.data());
+    REQUIRE(key1 == "interned_id");
+    REQUIRE(key1 < cjson::interned_string{"interned_name"});
+
+    auto shaped_parser = interned_parser{cjson::detail::input::parse_options{.shared_shapes = true},
+        std::string_view{R"([{"interned_id": 1, "interned_name": "a"}, {"interned_id": 2, "interned_name": "b"}])"}};
+    const auto shaped = shaped_parser.parse();
+    REQUIRE(shaped[0].is_shaped_object());
+    REQUIRE(shaped[0] == js1);
+    REQUIRE(shaped[1].at("interned_id") == cjson::interned_json{2});
+}
+
+TEST_CASE("Lookups on interned keys leave the pool as it is") {
+    using interned_parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::interned_json>;
+    auto js = interned_parser{std::string_view{R"({"lookup_a": 1, "lookup_b": 2})"}}.parse();
+    auto shaped_parser = interned_parser{cjson::detail::input::parse_options{.shared_shapes = true},
+        std::string_view{R"([{"lookup_a": 1}, {"lookup_a": 2}])"}};
+    auto shaped = shaped_parser.parse();
+    const auto pool_size = cjson::detail::string_pool::global().size();
+
+    REQUIRE_FALSE(js.contains("lookup_missing"));
+    REQUIRE_FALSE(shaped[0].contains(std::string{"lookup_missing"}));
+    REQUIRE_THROWS_AS(js.at(std::string_view{"lookup_missing"}), std::out_of_range);
+    REQUIRE_THROWS_AS(std::as_const(shaped)[1].at("lookup_missing"), std::out_of_range);
+    REQUIRE(js.erase("lookup_missing") == 0);
+    REQUIRE(shaped[0].erase("lookup_missing") == 0);
+    REQUIRE(shaped[0].is_shaped_object());
+    REQUIRE(cjson::detail::string_pool::global().size() == pool_size);
+
+    REQUIRE(std::as_const(shaped)[1].at("lookup_a") == cjson::interned_json{2});
+    REQUIRE(js.erase(std::string{"lookup_a"}) == 1);
+    REQUIRE(js == interned_parser{std::string_view{R"({"lookup_b": 2})"}}.parse());
+
+    const auto global_key = cjson::interned_string{"lookup_b"};
+    auto pool = cjson::detail::string_pool{};
+    {
+        const auto scope = cjson::detail::string_pool::scope{pool};
+        const auto scoped = interned_parser{std::string_view{R"({"scoped_key": 1, "lookup_b": 2})"}}.parse();
+        REQUIRE(pool.size() > 0);
+        REQUIRE(scoped.at("scoped_key") == cjson::interned_json{1});
+        REQUIRE(scoped.at("lookup_b") == js.at("lookup_b"));
+        REQUIRE(cjson::interned_string{"lookup_b"} == global_key);
+        REQUIRE(cjson::interned_string{"lookup_b"}.data() != global_key.data());
+    }
+    REQUIRE(cjson::detail::string_pool::global().size() == pool_size);
+}
+
+TEST_CASE("Interned keys are freed with the last handle to them") {
+    using interned_parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::interned_json>;
+    const auto pool_size = cjson::detail::string_pool::global().size();
+    {
+        const auto js = interned_parser{std::string_view{R"({"freed_a": 1, "freed_b": {"freed_a": 2}})"}}.parse();
+        REQUIRE(cjson::detail::string_pool::global().size() == pool_size + 2);
+        auto copy = js;
+        copy.at("freed_b").erase("freed_a");
+        REQUIRE(cjson::detail::string_pool::global().size() == pool_size + 2);
+    }
+    REQUIRE(cjson::detail::string_pool::global().size() == pool_size);
+
+    const auto empty = cjson::interned_string{};
+    REQUIRE(empty == cjson::interned_string{""});
+    REQUIRE(empty.data() == cjson::interned_string{std::string{}}.data());
+    REQUIRE(cjson::detail::string_pool::global().size() == pool_size);
+
+    auto threads = std::vector<std::thread>{};
+    auto matched = std::vector<int>(4, 0);
+    for (std::size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([t, &matched] {
+            for (int i = 0; i < 1000; ++i) {
+                const auto shared = cjson::interned_string{"freed_shared_" + std::to_string(i % 10)};
+                const auto own = cjson::interned_string{"freed_" + std::to_string(t) + "_" + std::to_string(i)};
+                const auto copy = shared;
+                matched[t] += (copy == shared and not (copy == own)) ? 1 : 0;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(matched == std::vector<int>(4, 1000));
+    REQUIRE(cjson::detail::string_pool::global().size() == pool_size);
+}
@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/cjson_thread_pool.hpp"
+#include "../include/detail/input/cjson_batch_parser.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+TEST_CASE("Parsers can be reset onto a new input") {
+    auto parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{
+        std::string_view{"[1, 2"}};
+    REQUIRE_THROWS_AS(parser.parse(), cjson::detail::input::json_input_error);
+    parser.reset(std::string_view{R"({"a": "b"})"});
+    REQUIRE(parser.parse().dump() == R"({"a": "b"})");
+    REQUIRE(parser.at_end());
+    parser.reset(std::string_view{"\n  @"});
+    try {
+        parser.parse();
+        FAIL("invalid input was accepted");
+    } catch (const cjson::detail::input::json_input_error& error) {
+        REQUIRE(error.pos_.line_start_ == 1);
+        REQUIRE(error.pos_.char_start_ == 3);
+    }
+}
+
+TEST_CASE("Many documents are parsed with per-item errors") {
+    const auto inputs = std::vector<std::string_view>{R"({"id": 1})", "[1, 2, 3]", R"({"id": })", "\"s\"", "", "true"};
+    const auto result = cjson::detail::input::parse_many<cjson::json>(inputs);
+    REQUIRE(result.values.size() == 6);
+    REQUIRE(result.values[0].at("id") == cjson::json{1});
+    REQUIRE(result.values[1].is_number_array());
+    REQUIRE(result.values[2].is_null());
+    REQUIRE(result.values[3] == cjson::json{"s"});
+    REQUIRE(result.values[5] == cjson::json{true});
+    REQUIRE(result.errors.size() == 2);
+    REQUIRE(result.errors[0].first == 2);
+    REQUIRE(std::string{result.errors[0].second.what()} == "Expecting json value: got \"}\" instead");
+    REQUIRE(result.errors[1].first == 4);
+}
+
+TEST_CASE("Parsing many documents on a pool keeps their order") {
+    auto texts = std::vector<std::string>{};
+    for (int i = 0; i < 1000; ++i) {
+        texts.push_back(i % 97 == 0 ? "{bad" : R"({"id": )" + std::to_string(i) + R"(, "tags": ["a"]})");
+    }
+    const auto inputs = std::vector<std::string_view>(texts.begin(), texts.end());
+    auto pool = cjson::detail::thread_pool{3};
+    const auto result = cjson::detail::input::parse_many<cjson::json>(inputs, pool, {.shared_shapes = true});
+    const auto sequential = cjson::detail::input::parse_many<cjson::json>(inputs);
+    REQUIRE(result.values == sequential.values);
+    REQUIRE(result.values[998].is_shaped_object());
+    REQUIRE(result.errors.size() == 11);
+    for (std::size_t i = 0; i < result.errors.size(); ++i) {
+        REQUIRE(result.errors[i].first == i * 97);
+    }
+    REQUIRE(cjson::detail::input::parse_many<cjson::json>(std::vector<std::string_view>{}, pool).values.empty());
+}
+
+TEST_CASE("Content after an item's value is that item's error") {
+    const auto inputs = std::vector<std::string_view>{"[1,2]]", "1 2", "[3] \n", R"({"a": 1}})"};
+    auto pool = cjson::detail::thread_pool{2};
+    for (const auto& result : {cjson::detail::input::parse_many<cjson::json>(inputs),
+        cjson::detail::input::parse_many<cjson::json>(inputs, pool)}) {
+        REQUIRE(result.errors.size() == 3);
+        REQUIRE(result.errors[0].first == 0);
+        REQUIRE(std::string{result.errors[0].second.what()} == R"(Expecting end of input after the json value: got "]" instead)");
+        REQUIRE(result.errors[0].second.pos_.char_start_ == 5);
+        REQUIRE(result.errors[1].first == 1);
+        REQUIRE(std::string{result.errors[1].second.what()} == R"(Expecting end of input after the json value: got "2" instead)");
+        REQUIRE(result.errors[2].first == 3);
+        REQUIRE(result.values[0].is_null());
+        REQUIRE(result.values[2].dump() == "[3]");
+    }
+}
@@ -0,0 +1,206 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_cbor_parser.hpp"
+#include "../include/detail/output/cjson_cbor_encoder.hpp"
+
+auto encode(const cjson::json& js, const bool canonical = false) -> std::string {
+    auto bytes = std::string{};
+    auto sink = cjson::detail::output::string_sink{bytes};
+    cjson::detail::output::cbor_encoder{sink, {.canonical = canonical}}.dump(js);
+    return bytes;
+}
+
+auto decode(std::string_view bytes) -> cjson::json {
+    return cjson::detail::input::cbor_parser<cjson::json>{bytes}.parse();
+}
+
+auto hex(std::string_view str) -> std::string {
+    auto bytes = std::string{};
+    for (std::size_t i = 0; i + 1 < str.size(); i += 2) {
+        bytes.push_back(static_cast<char>(std::stoi(std::string{str.substr(i, 2)}, nullptr, 16)));
+    }
+    return bytes;
+}
+
+TEST_CASE("Encoding matches the rfc 8949 examples") {
+    REQUIRE(encode(cjson::json{0}) == hex("00"));
+    REQUIRE(encode(cjson::json{23}) == hex("17"));
+    REQUIRE(encode(cjson::json{24}) == hex("1818"));
+    REQUIRE(encode(cjson::json{1000}) == hex("1903e8"));
+    REQUIRE(encode(cjson::json{1000000}) == hex("1a000f4240"));
+    REQUIRE(encode(cjson::json{1e12}) == hex("1b000000e8d4a51000"));
+    REQUIRE(encode(cjson::json{-1}) == hex("20"));
+    REQUIRE(encode(cjson::json{-1000}) == hex("3903e7"));
+    REQUIRE(encode(cjson::json{-4.1}) == hex("fbc010666666666666"));
+    REQUIRE(encode(cjson::json{1.0e300}) == hex("fb7e37e43c8800759c"));
+    REQUIRE(encode(cjson::json{false}) == hex("f4"));
+    REQUIRE(encode(cjson::json{nullptr}) == hex("f6"));
+    REQUIRE(encode(cjson::json{"IETF"}) == hex("6449455446"));
+    REQUIRE(encode(cjson::json{"\xC3\xBC"}) == hex("62c3bc"));
+    REQUIRE(encode(cjson::json{cjson::json::array{}}) == hex("80"));
+    auto object = cjson::json{cjson::json::object{}};
+    object.emplace("a", cjson::json{1});
+    object.emplace("b", cjson::json{cjson::json{2}, cjson::json{3}});
+    REQUIRE(encode(object) == hex("a26161016162820203"));
+}
+
+TEST_CASE("Canonical mode uses the shortest float and sorted keys") {
+    REQUIRE(encode(cjson::json{1.5}, true) == hex("f93e00"));
+    REQUIRE(encode(cjson::json{65504.5}, true) == hex("fa477fe080"));
+    REQUIRE(encode(cjson::json{5.960464477539063e-8}, true) == hex("f90001"));
+    REQUIRE(encode(cjson::json{0.00006103515625}, true) == hex("f90400"));
+    REQUIRE(encode(cjson::json{3.4028234663852886e+38}, true) == hex("fa7f7fffff"));
+    REQUIRE(encode(cjson::json{std::numeric_limits<double>::infinity()}, true) == hex("f97c00"));
+    REQUIRE(encode(cjson::json{-std::numeric_limits<double>::infinity()}, true) == hex("f9fc00"));
+    REQUIRE(encode(cjson::json{std::nan("")}, true) == hex("f97e00"));
+    REQUIRE(encode(cjson::json{-0.0}, true) == hex("f98000"));
+    REQUIRE(encode(cjson::json{-4.1}, true) == hex("fbc010666666666666"));
+    auto object = cjson::json{cjson::json::object{}};
+    object.emplace("aa", cjson::json{1});
+    object.emplace("b", cjson::json{2});
+    REQUIRE(encode(object, true) == hex("a26162026261610" "1"));
+}
+
+TEST_CASE("Decoding handles every major type") {
+    REQUIRE(static_cast<double>(decode(hex("1b000000e8d4a51000"))) == 1e12);
+    REQUIRE(static_cast<double>(decode(hex("3863"))) == -100);
+    REQUIRE(static_cast<double>(decode(hex("f97bff"))) == 65504.0);
+    REQUIRE(static_cast<double>(decode(hex("f90001"))) == 5.960464477539063e-8);
+    REQUIRE(std::isnan(static_cast<double>(decode(hex("f97e00")))));
+    REQUIRE(static_cast<double>(decode(hex("fa47c35000"))) == 100000.0);
+    REQUIRE(decode(hex("f7")).is_null());
+    REQUIRE(decode(hex("62225c")) == cjson::json{"\"\\"});
+    REQUIRE(decode(hex("4401020304")) == cjson::json{hex("01020304")});
+    REQUIRE(decode(hex("83010203")).dump() == "[1, 2, 3]");
+    REQUIRE(decode(hex("a26161016162820203")).dump() == R"({"a": 1, "b": [2, 3]})");
+}
+
+TEST_CASE("Indefinite-length items are concatenated") {
+    REQUIRE(decode(hex("5f42010243030405ff")) == cjson::json{hex("0102030405")});
+    REQUIRE(decode(hex("7f657374726561646d696e67ff")) == cjson::json{"streaming"});
+    REQUIRE(decode(hex("9fff")).dump() == "[]");
+    REQUIRE(decode(hex("9f018202039f0405ffff")).dump() == "[1, [2, 3], [4, 5]]");
+    REQUIRE(decode(hex("bf61610161629f0203ffff")).dump() == R"({"a": 1, "b": [2, 3]})");
+    REQUIRE(decode(hex("bf6346756ef563416d7421ff")).dump() == R"({"Amt": -2, "Fun": true})");
+}
+
+TEST_CASE("Tags are skipped and bignums become numbers") {
+    REQUIRE(decode(hex("c074323031332d30332d32315432303a30343a30305a")) == cjson::json{"2013-03-21T20:04:00Z"});
+    REQUIRE(static_cast<double>(decode(hex("c11a514b67b0"))) == 1363896240);
+    REQUIRE(static_cast<double>(decode(hex("c249010000000000000000"))) == 18446744073709551616.0);
+    REQUIRE(static_cast<double>(decode(hex("c349010000000000000000"))) == -18446744073709551617.0);
+    REQUIRE(static_cast<double>(decode(hex("d9d9f7d818c2420100"))) == 256);
+}
+
+TEST_CASE("A sequence of items is decoded one by one") {
+    const auto bytes = hex("01616183f5f6f4");
+    auto parser = cjson::detail::input::cbor_parser<cjson::json>{bytes};
+    REQUIRE(static_cast<double>(parser.parse()) == 1);
+    REQUIRE(parser.parse() == cjson::json{"a"});
+    REQUIRE_FALSE(parser.at_end());
+    REQUIRE(parser.parse().dump() == "[true, null, false]");
+    REQUIRE(parser.at_end());
+}
+
+TEST_CASE("Decoded containers get the representations the text parser gives them") {
+    REQUIRE(decode(hex("83010203")).is_number_array());
+    REQUIRE(decode(hex("9f0102ff")).is_number_array());
+    REQUIRE_FALSE(decode(hex("82016161")).is_number_array());
+    REQUIRE_FALSE(decode(hex("a2616201616102")).is_shaped_object());
+
+    const auto bytes = hex("a2616201616102a2616203616104bf616205616106ffa2616105616106");
+    auto parser = cjson::detail::input::cbor_parser<cjson::json>{bytes, {.shared_shapes = true}};
+    const auto first = parser.parse();
+    const auto second = parser.parse();
+    const auto third = parser.parse();
+    REQUIRE(first.is_shaped_object());
+    REQUIRE(second.is_shaped_object());
+    REQUIRE(third.is_shaped_object());
+    REQUIRE(second.dump() == R"({"a": 4, "b": 3})");
+    REQUIRE(third.dump() == R"({"a": 6, "b": 5})");
+    const auto duplicates = parser.parse();
+    REQUIRE_FALSE(duplicates.is_shaped_object());
+    REQUIRE(duplicates.dump() == R"({"a": 5})");
+    REQUIRE(decode(hex("a2616105616106")).dump() == R"({"a": 5})");
+    REQUIRE(parser.at_end());
+}
+
+TEST_CASE("Malformed cbor is rejected") {
+    using cjson::detail::input::json_input_error;
+    for (const auto* bytes : {"1c", "ff", "f8", "1a0001", "6261", "9f01", "5f6161ff", "a10102", "9b7fffffffffffffff"}) {
+        REQUIRE_THROWS_AS(decode(hex(bytes)), json_input_error);
+    }
+    REQUIRE_THROWS_AS(decode(std::string(1000, static_cast<char>(0x81))), json_input_error);
+}
+
+auto random_json(std::mt19937& rng, const int depth) -> cjson::json {
+    const auto kind = std::uniform_int_distribution<int>{0, depth > 0 ? 7 : 5}(rng);
+    switch (kind) {
+        case 0:
+            return cjson::json{nullptr};
+        case 1:
+            return cjson::json{rng() % 2 == 0};
+        case 2:
+            return cjson::json{static_cast<double>(static_cast<std::int64_t>(rng() % 2'000'001) - 1'000'000)};
+        case 3: {
+            const auto exponent = std::uniform_int_distribution<int>{-40, 80}(rng);
+            return cjson::json{std::ldexp(std::uniform_real_distribution<double>{-1, 1}(rng), exponent)};
+        }
+        case 4:
+            return cjson::json{std::ldexp(static_cast<double>(rng() % 2048), static_cast<int>(rng() % 30) - 15)};
+        case 5: {
+            auto str = std::string(rng() % 40, '\0');
+            for (auto& c : str) {
+                c = static_cast<char>(rng());
+            }
+            return cjson::json{std::move(str)};
+        }
+        case 6: {
+            auto js = cjson::json{cjson::json::array{}};
+            for (auto n = rng() % 6; n > 0; --n) {
+                js.push_back(random_json(rng, depth - 1));
+            }
+            return js;
+        }
+        default: {
+            auto js = cjson::json{cjson::json::object{}};
+            for (auto n = rng() % 6; n > 0; --n) {
+                js.emplace(std::string(1 + rng() % 4, static_cast<char>('a' + rng() % 3)), random_json(rng, depth - 1));
+            }
+            return js;
+        }
+    }
+}
+
+TEST_CASE("Random documents round-trip in both modes") {
+    auto rng = std::mt19937{20261019};
+    for (int i = 0; i < 2000; ++i) {
+        const auto js = random_json(rng, 4);
+        REQUIRE(decode(encode(js)) == js);
+        const auto canonical = encode(js, true);
+        REQUIRE(decode(canonical) == js);
+        REQUIRE(encode(decode(canonical), true) == canonical);
+        REQUIRE(canonical.size() <= encode(js).size());
+    }
+}
+
+TEST_CASE("Corrupted input either decodes or throws an input error") {
+    auto rng = std::mt19937{7};
+    for (int i = 0; i < 2000; ++i) {
+        auto bytes = encode(random_json(rng, 3), i % 2 == 0);
+        for (auto flips = 1 + rng() % 3; flips > 0; --flips) {
+            bytes[rng() % bytes.size()] = static_cast<char>(rng());
+        }
+        bytes.resize(bytes.size() - rng() % (bytes.size() / 4 + 1));
+        try {
+            static_cast<void>(decode(bytes));
+        } catch (const cjson::detail::input::json_input_error&) {
+        }
+    }
+}
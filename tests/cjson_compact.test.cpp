@@ -0,0 +1,110 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+auto parse(std::string_view str) -> cjson::json {
+    return cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{std::move(str)}.parse();
+}
+
+template <typename Json>
+auto dump(const Json& js) -> std::string {
+    auto os = std::ostringstream{};
+    os << js;
+    return os.str();
+}
+
+TEST_CASE("Compact values are 8 bytes") {
+    REQUIRE(sizeof(cjson::compact_json) == 8);
+    REQUIRE(sizeof(cjson::compact_json) * 2 == sizeof(cjson::json));
+}
+
+TEST_CASE("Compact scalars keep their type") {
+    const auto null_value = cjson::compact_json{nullptr};
+    const auto number_value = cjson::compact_json{-2.5};
+    const auto integer_value = cjson::compact_json{7};
+    const auto bool_value = cjson::compact_json{true};
+    const auto string_value = cjson::compact_json{"hello"};
+    REQUIRE(null_value.is_null());
+    REQUIRE(cjson::compact_json{}.is_null());
+    REQUIRE(number_value.is_number());
+    REQUIRE(static_cast<double>(number_value) == -2.5);
+    REQUIRE(static_cast<double>(integer_value) == 7.0);
+    REQUIRE(bool_value.is_boolean());
+    REQUIRE(static_cast<bool>(bool_value));
+    REQUIRE_FALSE(static_cast<bool>(cjson::compact_json{false}));
+    REQUIRE(string_value.is_string());
+    REQUIRE(static_cast<const std::string&>(string_value) == "hello");
+    REQUIRE_THROWS_AS(static_cast<double>(string_value), cjson::detail::json_type_error);
+    REQUIRE_FALSE(bool_value == cjson::compact_json{1});
+
+    const auto nan_value = cjson::compact_json{-std::numeric_limits<double>::quiet_NaN()};
+    REQUIRE(nan_value.is_number());
+    REQUIRE(std::isnan(static_cast<double>(nan_value)));
+    REQUIRE(cjson::compact_json{-std::numeric_limits<double>::infinity()}.is_number());
+    REQUIRE(cjson::compact_json{0.0} == cjson::compact_json{-0.0});
+}
+
+TEST_CASE("Compact containers support the basic_json API") {
+    auto js = cjson::compact_json{cjson::compact_json{1}, cjson::compact_json{"two"}, cjson::compact_json{false}};
+    REQUIRE(js.is_array());
+    REQUIRE(js.size() == 3);
+    js.push_back(cjson::compact_json{nullptr});
+    js.emplace_back(4.5);
+    REQUIRE(js.size() == 5);
+    REQUIRE(js[1] == cjson::compact_json{"two"});
+    REQUIRE(js.back() == cjson::compact_json{4.5});
+    REQUIRE_THROWS_AS(js.at(5), std::out_of_range);
+    REQUIRE(dump(js) == R"([1, "two", false, null, 4.5])");
+
+    cjson::compact_json& first = js[0];
+    cjson::compact_json& front = js.front();
+    cjson::compact_json& element = *js.begin();
+    REQUIRE(&first == &front);
+    REQUIRE(&first == &element);
+    REQUIRE(&js.back() == &*std::prev(js.end()));
+    REQUIRE(&std::as_const(js).back() == &*js.crbegin());
+    *std::next(js.begin()) = cjson::compact_json{2};
+    REQUIRE(js[1] == cjson::compact_json{2});
+    auto total = 0.0;
+    for (const auto& val : std::as_const(js)) {
+        total += val.is_number() ? static_cast<double>(val) : 0.0;
+    }
+    REQUIRE(total == 7.5);
+
+    auto obj = cjson::compact_json{cjson::compact_json::object{}};
+    obj.emplace("b", cjson::compact_json{2});
+    obj.insert({"a", js});
+    REQUIRE(obj.contains("a"));
+    REQUIRE(obj.at("b") == cjson::compact_json{2});
+    REQUIRE(obj.erase("b") == 1);
+    REQUIRE(obj.size() == 1);
+
+    const auto copy = obj;
+    REQUIRE(copy == obj);
+    auto moved = std::move(obj);
+    REQUIRE(moved == copy);
+    REQUIRE(obj.is_null());
+}
+
+TEST_CASE("Compact values convert to and from basic_json") {
+    const auto text = R"({"id": 42, "tags": ["a", "b"], "point": [1.5, -2], "nested": {"ok": true, "none": null}})";
+    const auto js = parse(text);
+    const auto compact = cjson::compact_json{js};
+    REQUIRE(compact.is_object());
+    REQUIRE(compact.at("point").is_array());
+    REQUIRE(compact.at("point")[1] == cjson::compact_json{-2});
+    REQUIRE(dump(compact) == dump(js));
+    REQUIRE(compact.to_json<cjson::json>() == js);
+
+    auto shaped_parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{
+        cjson::detail::input::parse_options{.shared_shapes = true}, std::string_view{text}};
+    REQUIRE(cjson::compact_json{shaped_parser.parse()} == compact);
+}
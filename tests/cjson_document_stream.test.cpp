@@ -0,0 +1,49 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_document_stream.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+using document_stream = cjson::detail::input::json_document_stream<cjson::detail::input::string_reader, cjson::json>;
+
+TEST_CASE("Concatenated documents are read one after another") {
+    auto stream = document_stream{std::string_view{R"({"a": 1}{"b": [2, 3]}[4, "x"] 5 "six"true
+null)"}};
+    auto dumps = std::vector<std::string>{};
+    for (const auto& js : stream) {
+        dumps.push_back(js.dump());
+    }
+    REQUIRE(dumps == std::vector<std::string>{R"({"a": 1})", R"({"b": [2, 3]})", R"([4, "x"])", "5", R"("six")",
+                                              "true", "null"});
+    REQUIRE(stream.count() == 7);
+    REQUIRE(stream.at_end());
+    REQUIRE_FALSE(stream.next());
+}
+
+TEST_CASE("Documents can be read in batches") {
+    auto text = std::string{};
+    for (int i = 0; i < 10; ++i) {
+        text += R"({"id": )" + std::to_string(i) + "}";
+    }
+    auto stream = document_stream{std::string_view{text}};
+    REQUIRE(stream.next_batch(4).size() == 4);
+    REQUIRE(stream.next_batch(4).back().at("id") == cjson::json{7});
+    REQUIRE(stream.next_batch(4).size() == 2);
+    REQUIRE(stream.next_batch(4).empty());
+    REQUIRE(stream.count() == 10);
+}
+
+TEST_CASE("Empty streams and bad documents") {
+    auto empty = document_stream{std::string_view{"  \n "}};
+    REQUIRE(empty.at_end());
+    REQUIRE(empty.begin() == empty.end());
+
+    auto stream = document_stream{cjson::detail::input::parse_options{.shared_shapes = true},
+                                  std::string_view{R"({"a": 1} {"a": 2} {"a": ] )"}};
+    REQUIRE(stream.next()->is_shaped_object());
+    REQUIRE(stream.next()->at("a") == cjson::json{2});
+    REQUIRE_THROWS_AS(stream.next(), cjson::detail::input::json_input_error);
+}
@@ -0,0 +1,188 @@
+#include <catch2/catch.hpp>
+#include <coroutine>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_event_parser.hpp"
+
+using cjson::detail::input::async_event_reader;
+using cjson::detail::input::event_type;
+using cjson::detail::input::json_event;
+using cjson::detail::input::string_reader;
+
+auto describe(const json_event& event) -> std::string {
+    switch (event.type_) {
+        case event_type::START_OBJECT:
+            return "{";
+        case event_type::END_OBJECT:
+            return "}";
+        case event_type::START_ARRAY:
+            return "[";
+        case event_type::END_ARRAY:
+            return "]";
+        case event_type::KEY:
+            return "key " + std::string{event.spelling_};
+        case event_type::STRING:
+            return "string " + std::string{event.spelling_};
+        case event_type::NUMBER:
+            return "number " + std::to_string(event.number());
+        case event_type::TRUE:
+            return "true";
+        case event_type::FALSE:
+            return "false";
+        case event_type::NULL_VALUE:
+            return "null";
+        case event_type::NEED_INPUT:
+            break;
+    }
+    return "need input";
+}
+
+auto sync_events(const std::string_view text) -> std::vector<std::string> {
+    auto result = std::vector<std::string>{};
+    for (const auto& event : cjson::detail::input::parse_events<string_reader>(std::string_view{text})) {
+        result.push_back(describe(event));
+    }
+    return result;
+}
+
+// starts running right away and frees itself when done, like a handler on an event loop
+struct task {
+    struct promise_type {
+        auto get_return_object() const noexcept -> task {
+            return {};
+        }
+
+        auto initial_suspend() const noexcept -> std::suspend_never {
+            return {};
+        }
+
+        auto final_suspend() const noexcept -> std::suspend_never {
+            return {};
+        }
+
+        auto return_void() const noexcept -> void {}
+
+        auto unhandled_exception() const noexcept -> void {
+            std::terminate();
+        }
+    };
+};
+
+auto collect(async_event_reader& reader, std::vector<std::string>& out) -> task {
+    try {
+        while (const auto event = co_await reader.next()) {
+            out.push_back(describe(*event));
+        }
+        out.push_back("done");
+    } catch (const cjson::detail::input::json_input_error& error) {
+        out.push_back(error.what());
+    }
+}
+
+TEST_CASE("A document is read as a sequence of events") {
+    const auto events = sync_events(R"({"a": [1, -2.5e1, {}], "b\n": {"c": [true, false, null, []]}, "d": "e"})");
+    REQUIRE(events == std::vector<std::string>{
+        "{", "key a", "[", "number 1.000000", "number -25.000000", "{", "}", "]", "key b\n", "{", "key c", "[",
+        "true", "false", "null", "[", "]", "]", "}", "key d", "string e", "}"});
+    REQUIRE(sync_events(" 42 ") == std::vector<std::string>{"number 42.000000"});
+}
+
+TEST_CASE("Events are produced lazily") {
+    auto events = cjson::detail::input::parse_events<string_reader>(std::string_view{R"([{"id": 1}, @])"});
+    auto iter = events.begin();
+    REQUIRE(iter->type_ == event_type::START_ARRAY);
+    ++iter;
+    REQUIRE(iter->type_ == event_type::START_OBJECT);
+    ++iter;
+    REQUIRE(iter->spelling_ == "id");
+    for (int i = 0; i < 2; ++i) {
+        ++iter;
+    }
+    REQUIRE(iter->type_ == event_type::END_OBJECT);
+    REQUIRE_THROWS_MATCHES(++iter, cjson::detail::input::json_input_error, Catch::Message("Invalid character: '@'"));
+}
+
+TEST_CASE("Malformed documents throw from the generator") {
+    REQUIRE_THROWS_MATCHES(sync_events(R"({"a" 1})"), cjson::detail::input::json_input_error,
+                           Catch::Message("Expecting a ':' between key-value pair: got \"1\" instead"));
+    REQUIRE_THROWS_MATCHES(sync_events("[1, 2"), cjson::detail::input::json_input_error,
+                           Catch::Message("Expecting ']' at the end of a json array: got \"\" instead"));
+    REQUIRE_THROWS_MATCHES(sync_events(R"({"a": 1])"), cjson::detail::input::json_input_error,
+                           Catch::Message("Expecting '}' at the end of a json object: got \"]\" instead"));
+    REQUIRE_THROWS_MATCHES(sync_events("{1: 2}"), cjson::detail::input::json_input_error,
+                           Catch::Message("Expecting a string for key: got \"1\" instead"));
+}
+
+TEST_CASE("Interleaved async parses see the same events as the generator") {
+    const auto texts = std::vector<std::string_view>{
+        R"({"name": "a \"quoted\" \\ value", "values": [12345, -0.5e-3, true, false, null], "nested": {"x": []}})",
+        R"([{"id": 1, "tags": ["alpha", "beta"]}, {"id": 22, "tags": []}, "tailA"] )",
+    };
+    for (const auto chunk : {std::size_t{1}, std::size_t{2}, std::size_t{7}}) {
+        auto readers = std::vector<std::unique_ptr<async_event_reader>>{};
+        auto outputs = std::vector<std::vector<std::string>>(texts.size());
+        for (std::size_t i = 0; i < texts.size(); ++i) {
+            readers.push_back(std::make_unique<async_event_reader>());
+            collect(*readers[i], outputs[i]);
+            REQUIRE(outputs[i].empty());
+        }
+        // the event loop: a few bytes for each parse in turn
+        for (std::size_t first = 0; first < texts[0].size() or first < texts[1].size(); first += chunk) {
+            for (std::size_t i = 0; i < texts.size(); ++i) {
+                if (first < texts[i].size()) {
+                    readers[i]->feed(texts[i].substr(first, chunk));
+                }
+            }
+        }
+        for (std::size_t i = 0; i < texts.size(); ++i) {
+            readers[i]->finish();
+            auto expected = sync_events(texts[i]);
+            expected.push_back("done");
+            REQUIRE(outputs[i] == expected);
+        }
+    }
+}
+
+TEST_CASE("A literal at the end of the input waits for finish") {
+    auto reader = async_event_reader{};
+    auto out = std::vector<std::string>{};
+    collect(reader, out);
+    reader.feed("12");
+    REQUIRE(out.empty());
+    reader.feed("34");
+    REQUIRE(out.empty());
+    reader.finish();
+    REQUIRE(out == std::vector<std::string>{"number 1234.000000", "done"});
+}
+
+TEST_CASE("Async errors are thrown in the awaiting coroutine") {
+    auto reader = async_event_reader{};
+    auto out = std::vector<std::string>{};
+    collect(reader, out);
+    reader.feed(R"({"a": [1, 2)");
+    REQUIRE(out == std::vector<std::string>{"{", "key a", "[", "number 1.000000"});
+    reader.feed(" }");
+    REQUIRE(out.back() == "Expecting ']' at the end of a json array: got \"}\" instead");
+}
+
+TEST_CASE("Brackets, colons and strings are delivered as soon as they are fed") {
+    auto reader = async_event_reader{};
+    auto out = std::vector<std::string>{};
+    collect(reader, out);
+    reader.feed(R"({"a":1})");
+    REQUIRE(out == std::vector<std::string>{"{", "key a", "number 1.000000", "}", "done"});
+
+    auto chunked = async_event_reader{};
+    auto chunked_out = std::vector<std::string>{};
+    collect(chunked, chunked_out);
+    for (const auto c : std::string_view{R"([{"b": "x"}, [])"}) {
+        chunked.feed(std::string_view{&c, 1});
+    }
+    REQUIRE(chunked_out == std::vector<std::string>{"[", "{", "key b", "string x", "}", "[", "]"});
+    chunked.feed("]");
+    REQUIRE(chunked_out == std::vector<std::string>{"[", "{", "key b", "string x", "}", "[", "]", "]", "done"});
+}
@@ -0,0 +1,185 @@
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_document_stream.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+// allocations made anywhere in the program while counting is on
+namespace heap {
+    inline auto counting = false;
+    inline auto allocations = std::size_t{0};
+}
+
+auto operator new(const std::size_t size, const std::nothrow_t&) noexcept -> void* {
+    if (heap::counting) {
+        ++heap::allocations;
+    }
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+auto operator new(const std::size_t size) -> void* {
+    if (const auto ptr = operator new(size, std::nothrow)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+auto operator delete(void* ptr) noexcept -> void {
+    std::free(ptr);
+}
+
+auto operator delete(void* ptr, const std::nothrow_t&) noexcept -> void {
+    std::free(ptr);
+}
+
+auto operator delete(void* ptr, std::size_t) noexcept -> void {
+    std::free(ptr);
+}
+
+// copying a container asks its allocator for the copy's allocator, so counting those requests
+// counts the deep copies of every array and object
+inline auto container_copies = std::size_t{0};
+
+// blocks handed out by the allocator and not yet given back
+inline auto live_blocks = std::ptrdiff_t{0};
+
+template <typename T>
+struct counting_allocator {
+    using value_type = T;
+
+    counting_allocator() noexcept = default;
+
+    template <typename U>
+    counting_allocator(const counting_allocator<U>&) noexcept {}
+
+    auto allocate(const std::size_t n) -> T* {
+        const auto ptr = std::allocator<T>{}.allocate(n);
+        ++live_blocks;
+        return ptr;
+    }
+
+    auto deallocate(T* ptr, const std::size_t n) noexcept -> void {
+        --live_blocks;
+        std::allocator<T>{}.deallocate(ptr, n);
+    }
+
+    auto select_on_container_copy_construction() const noexcept -> counting_allocator {
+        ++container_copies;
+        return {};
+    }
+
+    template <typename U>
+    friend auto operator==(const counting_allocator&, const counting_allocator<U>&) noexcept -> bool {
+        return true;
+    }
+};
+
+using counted_json = cjson::basic_json<cjson::json_types, counting_allocator>;
+using cjson::detail::input::parse_options;
+using cjson::detail::input::string_reader;
+using parser = cjson::detail::input::json_parser<string_reader, counted_json>;
+
+template <typename Run>
+auto copies_during(Run run) -> std::size_t {
+    container_copies = 0;
+    run();
+    return container_copies;
+}
+
+template <typename Run>
+auto allocations_during(Run run) -> std::size_t {
+    heap::allocations = 0;
+    heap::counting = true;
+    run();
+    heap::counting = false;
+    return heap::allocations;
+}
+
+TEST_CASE("Copies are counted") {
+    const auto js = parser{std::string_view{R"({"a": [1, "b"]})"}}.parse();
+    REQUIRE(copies_during([&] { [[maybe_unused]] const auto copy = js; }) == 2);
+}
+
+TEST_CASE("Parsing copies no arrays or objects") {
+    const auto text = std::string_view{R"([{"a": [1, 2], "b": {"c": ["d", [3]]}}, {"a": [4], "b": {"c": [6]}}, [[5], "e"]])"};
+    auto options = parse_options{};
+    for (const auto shared_shapes : {false, true}) {
+        for (const auto presize : {false, true}) {
+            options.shared_shapes = shared_shapes;
+            options.presize = presize;
+            REQUIRE(copies_during([&] { parser{options, std::string_view{text}}.parse(); }) == 0);
+        }
+    }
+    REQUIRE(copies_during([&] { parser{std::string_view{text}}.parse(); }) == 0);
+    REQUIRE(copies_during([&] { parser{std::string_view{R"([{"a": [1, tru]}, [2, "f"]])"}}.parse_recovering(); }) == 0);
+    REQUIRE(copies_during([&] {
+        auto stream = cjson::detail::input::json_document_stream<string_reader, counted_json>{std::string_view{text}};
+        for ([[maybe_unused]] const auto& document : stream) {}
+    }) == 0);
+}
+
+TEST_CASE("Parsing allocates a string once for its characters and once for its slot") {
+    const auto long_strings = [](const int count) {
+        auto text = std::string{"["};
+        for (int i = 0; i < count; ++i) {
+            text += (i == 0 ? "\"" : ", \"") + std::string(40, 'x') + "\"";
+        }
+        return text + "]";
+    };
+    const auto small = long_strings(100);
+    const auto large = long_strings(200);
+    auto options = parse_options{};
+    options.presize = true;
+    const auto parse_small = allocations_during([&] { parser{options, std::string_view{small}}.parse(); });
+    const auto parse_large = allocations_during([&] { parser{options, std::string_view{large}}.parse(); });
+    REQUIRE(parse_large - parse_small == 2 * 100);
+}
+
+TEST_CASE("Inserting an rvalue moves it and inserting an lvalue leaves it intact") {
+    auto js = parser{std::string_view{"[1, \"a\"]"}}.parse();
+    auto element = parser{std::string_view{"[2, [3, \"b\"]]"}}.parse();
+    REQUIRE(copies_during([&] { js.insert(js.cbegin(), std::move(element)); }) == 0);
+    REQUIRE(js.size() == 3);
+
+    auto object = parser{std::string_view{R"({"a": 1})"}}.parse();
+    auto member = std::pair{std::string{"b"}, counted_json{counted_json::array{counted_json{2}}}};
+    object.insert(member);
+    REQUIRE(member.first == "b");
+    REQUIRE(member.second.size() == 1);
+    REQUIRE(copies_during([&] { object.insert(std::pair{std::string{"c"}, counted_json{counted_json::array{}}}); }) == 0);
+    REQUIRE(object.size() == 3);
+}
+
+TEST_CASE("Move assignment destroys the value it replaces") {
+    const auto before = live_blocks;
+    {
+        auto js = parser{std::string_view{R"({"a": [1, "b"], "c": {"d": "e"}})"}}.parse();
+        auto other = parser{std::string_view{"[2, \"f\"]"}}.parse();
+        const auto both = live_blocks;
+        js = std::move(other);
+        REQUIRE(live_blocks < both);
+        REQUIRE(js == parser{std::string_view{"[2, \"f\"]"}}.parse());
+
+        auto numbers = parser{std::string_view{"[1, 2, 3]"}}.parse();
+        REQUIRE(std::as_const(numbers)[0] == counted_json{1});
+        auto shaped = parser{parse_options{.shared_shapes = true}, std::string_view{R"({"g": [4, 5]})"}}.parse();
+        REQUIRE(shaped.is_shaped_object());
+        const auto all = live_blocks;
+        numbers = std::move(shaped);
+        REQUIRE(live_blocks < all);
+        REQUIRE(numbers.is_shaped_object());
+        REQUIRE(shaped.is_null());
+
+        auto& self = numbers;
+        numbers = std::move(self);
+        REQUIRE(numbers.is_shaped_object());
+    }
+    REQUIRE(live_blocks == before);
+}
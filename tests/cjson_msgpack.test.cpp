@@ -0,0 +1,131 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_msgpack_parser.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+#include "../include/detail/output/cjson_msgpack_encoder.hpp"
+
+auto parse(std::string_view str) -> cjson::json {
+    return cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{std::move(str)}.parse();
+}
+
+template <typename Json>
+auto encode(const Json& js) -> std::string {
+    auto bytes = std::string{};
+    auto sink = cjson::detail::output::string_sink{bytes};
+    cjson::detail::output::msgpack_encoder{sink}.dump(js);
+    return bytes;
+}
+
+auto decode(std::string_view bytes) -> cjson::json {
+    return cjson::detail::input::msgpack_parser<cjson::json>{bytes}.parse();
+}
+
+auto bytes(std::initializer_list<int> values) -> std::string {
+    auto str = std::string{};
+    for (const auto value : values) {
+        str.push_back(static_cast<char>(value));
+    }
+    return str;
+}
+
+TEST_CASE("Scalars use the smallest msgpack format") {
+    REQUIRE(encode(cjson::json{nullptr}) == bytes({0xC0}));
+    REQUIRE(encode(cjson::json{true}) == bytes({0xC3}));
+    REQUIRE(encode(cjson::json{false}) == bytes({0xC2}));
+    REQUIRE(encode(cjson::json{5}) == bytes({0x05}));
+    REQUIRE(encode(cjson::json{-3}) == bytes({0xFD}));
+    REQUIRE(encode(cjson::json{200}) == bytes({0xCC, 0xC8}));
+    REQUIRE(encode(cjson::json{-200}) == bytes({0xD1, 0xFF, 0x38}));
+    REQUIRE(encode(cjson::json{70000}) == bytes({0xCE, 0x00, 0x01, 0x11, 0x70}));
+    REQUIRE(encode(cjson::json{1.5}) == bytes({0xCB, 0x3F, 0xF8, 0, 0, 0, 0, 0, 0}));
+    REQUIRE(encode(cjson::json{"abc"}) == bytes({0xA3, 'a', 'b', 'c'}));
+    REQUIRE(encode(cjson::json{std::string(40, 'x')}).substr(0, 2) == bytes({0xD9, 40}));
+}
+
+TEST_CASE("Containers round-trip through msgpack") {
+    const auto js = parse(R"({"a": [1, -2, 3.25], "b": {"c": [true, null, "s"]}, "d": -1e300})");
+    const auto encoded = encode(js);
+    REQUIRE(encoded.size() < js.dump().size());
+    REQUIRE(decode(encoded) == js);
+    REQUIRE(decode(encoded).dump() == js.dump());
+}
+
+TEST_CASE("Decoded containers get the representations the text parser gives them") {
+    const auto text = std::string_view{R"([[1, 2, 3], [1, "a", 2], [true], {"b": 1, "a": 2}, {"b": 3, "a": 4}])"};
+    const auto options = cjson::detail::input::parse_options{.shared_shapes = true};
+    const auto parsed = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{
+        options, std::string_view{text}}.parse();
+    const auto encoded = encode(parsed);
+    const auto js = cjson::detail::input::msgpack_parser<cjson::json>{encoded, options}.parse();
+    REQUIRE(js == parsed);
+    REQUIRE(js[0].is_number_array());
+    REQUIRE_FALSE(js[1].is_number_array());
+    REQUIRE(js[1].is_array());
+    REQUIRE(js[3].is_shaped_object());
+    REQUIRE(js[4].is_shaped_object());
+
+    const auto plain = decode(encoded);
+    REQUIRE(plain == parsed);
+    REQUIRE(plain[0].is_number_array());
+    REQUIRE_FALSE(plain[3].is_shaped_object());
+
+    const auto duplicates = bytes({0x82, 0xA1, 'a', 0x05, 0xA1, 'a', 0x06});
+    REQUIRE(decode(duplicates) == parse(R"({"a": 5})"));
+    const auto shaped = cjson::detail::input::msgpack_parser<cjson::json>{duplicates, options}.parse();
+    REQUIRE_FALSE(shaped.is_shaped_object());
+    REQUIRE(shaped == parse(R"({"a": 5})"));
+}
+
+TEST_CASE("Large containers use wide headers") {
+    auto js = cjson::json{cjson::json::array{}};
+    for (int i = 0; i < 70000; ++i) {
+        js.push_back(cjson::json{i % 3 == 0 ? cjson::json{"x"} : cjson::json{i}});
+    }
+    const auto encoded = encode(js);
+    REQUIRE(static_cast<unsigned char>(encoded[0]) == 0xDD);
+    REQUIRE(decode(encoded) == js);
+}
+
+TEST_CASE("Numeric edge cases survive msgpack") {
+    for (const auto n : {0.0, -0.0, 0.1, 1e20, -9007199254740993.0, 18446744073709551615.0,
+                         std::numeric_limits<double>::infinity(), std::numeric_limits<double>::lowest()}) {
+        const auto decoded = static_cast<double>(decode(encode(cjson::json{n})));
+        REQUIRE(decoded == n);
+        REQUIRE(std::signbit(decoded) == std::signbit(n));
+    }
+    REQUIRE(std::isnan(static_cast<double>(decode(encode(cjson::json{std::nan("")})))));
+    REQUIRE(static_cast<double>(decode(bytes({0xCA, 0x3F, 0xC0, 0, 0}))) == 1.5);
+    REQUIRE(static_cast<double>(decode(bytes({0xCF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}))) == 18446744073709551615.0);
+    REQUIRE(static_cast<double>(decode(bytes({0xD3, 0x80, 0, 0, 0, 0, 0, 0, 0}))) == -9223372036854775808.0);
+}
+
+TEST_CASE("Bin and ext map to strings and objects") {
+    REQUIRE(decode(bytes({0xC4, 0x02, 0x00, 0xFF})) == cjson::json{bytes({0x00, 0xFF})});
+    const auto ext = decode(bytes({0xD5, 0x07, 'h', 'i'}));
+    REQUIRE(ext.dump() == R"({"data": "hi", "type": 7})");
+    const auto negative = decode(bytes({0xC7, 0x01, 0xFF, 'z'}));
+    REQUIRE(static_cast<double>(negative.at("type")) == -1);
+}
+
+TEST_CASE("Bin and ext are encoded back as str and map") {
+    const auto bin = decode(bytes({0xC4, 0x02, 'h', 'i'}));
+    REQUIRE(encode(bin) == bytes({0xA2, 'h', 'i'}));
+    const auto ext = decode(bytes({0xD5, 0x07, 'h', 'i'}));
+    REQUIRE(encode(ext) == bytes({0x82, 0xA4, 'd', 'a', 't', 'a', 0xA2, 'h', 'i', 0xA4, 't', 'y', 'p', 'e', 0x07}));
+    REQUIRE(decode(encode(ext)) == ext);
+}
+
+TEST_CASE("Malformed msgpack is rejected") {
+    using cjson::detail::input::json_input_error;
+    REQUIRE_THROWS_AS(decode(bytes({0xC1})), json_input_error);
+    REQUIRE_THROWS_AS(decode(bytes({0xA5, 'a'})), json_input_error);
+    REQUIRE_THROWS_AS(decode(bytes({0xDD, 0xFF, 0xFF, 0xFF, 0xFF})), json_input_error);
+    REQUIRE_THROWS_AS(decode(bytes({0x81, 0x01, 0x02})), json_input_error);
+    REQUIRE_THROWS_AS(decode(std::string(1000, static_cast<char>(0x91))), json_input_error);
+    REQUIRE_THROWS_WITH(decode(bytes({0xC1})), "Invalid type byte 0xc1 at byte 0");
+}
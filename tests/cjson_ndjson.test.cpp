@@ -0,0 +1,124 @@
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/cjson_simd.hpp"
+#include "../include/detail/cjson_thread_pool.hpp"
+#include "../include/detail/input/cjson_ndjson_parser.hpp"
+
+using cjson::detail::input::ndjson_line;
+using cjson::detail::input::parse_ndjson;
+
+TEST_CASE("Newlines are found at every offset") {
+    for (std::size_t size = 0; size < 80; ++size) {
+        for (std::size_t at = 0; at <= size; ++at) {
+            auto str = std::string(size, 'x');
+            if (at < size) {
+                str[at] = '\n';
+            }
+            REQUIRE(cjson::detail::simd::find_newline(str.data(), str.size()) == at);
+        }
+    }
+}
+
+TEST_CASE("Work-stealing pools run every task, including ones submitted by workers") {
+    auto pool = cjson::detail::thread_pool{4};
+    auto count = std::atomic<int>{0};
+    auto outer = std::vector<std::future<std::future<void>>>{};
+    for (int i = 0; i < 200; ++i) {
+        outer.push_back(pool.submit([&] {
+            ++count;
+            return pool.submit([&] {
+                ++count;
+            });
+        }));
+    }
+    for (auto& task : outer) {
+        task.get().get();
+    }
+    REQUIRE(count == 400);
+}
+
+TEST_CASE("Lines are delivered in order with their line numbers") {
+    auto pool = cjson::detail::thread_pool{4};
+    auto text = std::string{};
+    for (int i = 0; i < 5000; ++i) {
+        text += R"({"id": )" + std::to_string(i) + R"(, "tags": ["x", "y"]})" + (i % 7 == 0 ? "\r\n\n" : "\n");
+    }
+    auto lines = std::vector<ndjson_line<cjson::json>>{};
+    const auto delivered = parse_ndjson<cjson::json>(text, pool, [&](ndjson_line<cjson::json>&& line) {
+        lines.push_back(std::move(line));
+    }, {.batch_size = 1000, .batches_per_thread = 1});
+    REQUIRE(delivered == 5000);
+    REQUIRE(lines.size() == 5000);
+    auto line_number = std::size_t{0};
+    for (std::size_t i = 0; i < 5000; ++i) {
+        REQUIRE_FALSE(lines[i].error);
+        REQUIRE(lines[i].line_number == line_number);
+        REQUIRE(lines[i].value.at("id") == cjson::json{i});
+        line_number += (i % 7 == 0 ? 2u : 1u);
+    }
+}
+
+TEST_CASE("Bad lines are reported without stopping the rest") {
+    auto pool = cjson::detail::thread_pool{2};
+    const auto text = std::string_view{"[1, 2]\n\n{\"a\": tru}\n\"ok\"\n  @\n{\"b\": null}"};
+    auto lines = std::vector<ndjson_line<cjson::json>>{};
+    parse_ndjson<cjson::json>(text, pool, [&](ndjson_line<cjson::json>&& line) {
+        lines.push_back(std::move(line));
+    });
+    REQUIRE(lines.size() == 5);
+    REQUIRE(lines[0].value.dump() == "[1, 2]");
+    REQUIRE(lines[1].line_number == 2);
+    REQUIRE(lines[1].error);
+    REQUIRE(lines[1].error->pos_.line_start_ == 2);
+    REQUIRE(lines[2].value == cjson::json{"ok"});
+    REQUIRE(lines[3].error);
+    REQUIRE(std::strcmp(lines[3].error->what(), "Invalid character: '@'") == 0);
+    REQUIRE(lines[3].error->pos_.line_start_ == 4);
+    REQUIRE(lines[3].error->pos_.char_start_ == 2);
+    REQUIRE(lines[4].line_number == 5);
+    REQUIRE(lines[4].value.at("b").is_null());
+}
+
+TEST_CASE("Exceptions from the callback propagate") {
+    auto pool = cjson::detail::thread_pool{2};
+    auto text = std::string{};
+    for (int i = 0; i < 1000; ++i) {
+        text += "[" + std::to_string(i) + "]\n";
+    }
+    auto seen = 0;
+    REQUIRE_THROWS_AS(parse_ndjson<cjson::json>(text, pool, [&](ndjson_line<cjson::json>&&) {
+        if (++seen == 10) {
+            throw std::runtime_error("stop");
+        }
+    }, {.batch_size = 16}), std::runtime_error);
+    REQUIRE(seen == 10);
+}
+
+TEST_CASE("Content after the value on a line is that line's error") {
+    auto pool = cjson::detail::thread_pool{2};
+    const auto text = std::string_view{"1 2\n[1,2]]]\n[3]  \n\"a\" @\n"};
+    auto lines = std::vector<ndjson_line<cjson::json>>{};
+    parse_ndjson<cjson::json>(text, pool, [&](ndjson_line<cjson::json>&& line) {
+        lines.push_back(std::move(line));
+    });
+    REQUIRE(lines.size() == 4);
+    REQUIRE(lines[0].error);
+    REQUIRE(std::strcmp(lines[0].error->what(), R"(Expecting end of input after the json value: got "2" instead)") == 0);
+    REQUIRE(lines[0].error->pos_.char_start_ == 2);
+    REQUIRE(lines[1].error);
+    REQUIRE(std::strcmp(lines[1].error->what(), R"(Expecting end of input after the json value: got "]" instead)") == 0);
+    REQUIRE(lines[1].error->pos_.line_start_ == 1);
+    REQUIRE(lines[1].error->pos_.char_start_ == 5);
+    REQUIRE_FALSE(lines[2].error);
+    REQUIRE(lines[2].value.dump() == "[3]");
+    REQUIRE(lines[3].error);
+    REQUIRE(std::strcmp(lines[3].error->what(), "Invalid character: '@'") == 0);
+}
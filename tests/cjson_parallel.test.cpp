@@ -0,0 +1,145 @@
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/cjson_thread_pool.hpp"
+#include "../include/detail/input/cjson_parallel_parser.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+auto parse(std::string_view str) -> cjson::json {
+    return cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{std::move(str)}.parse();
+}
+
+// records whose strings hold every character the splitter must not cut at
+auto make_records(const int records) -> std::string {
+    auto text = std::string{"[\n"};
+    for (int i = 0; i < records; ++i) {
+        if (i > 0) {
+            text += ",\n";
+        }
+        text += R"(  {"id": )" + std::to_string(i) + R"(, "name": "a, [b] {c} \"d\", \\", "values": [)"
+            + std::to_string(i) + R"(, 1.5, {"nested": [true, null, "]"]}]})";
+    }
+    return text + "\n]";
+}
+
+TEST_CASE("Thread pools run tasks and propagate their exceptions") {
+    auto pool = cjson::detail::thread_pool{3};
+    REQUIRE(pool.size() == 3);
+    auto first = pool.submit([] {
+        return 20;
+    });
+    auto second = pool.submit([] {
+        return std::string{"x"};
+    });
+    auto failing = pool.submit([]() -> int {
+        throw std::runtime_error("task failed");
+    });
+    REQUIRE(first.get() == 20);
+    REQUIRE(second.get() == "x");
+    REQUIRE_THROWS_AS(failing.get(), std::runtime_error);
+}
+
+TEST_CASE("Large arrays parse in parallel to the same value") {
+    auto pool = cjson::detail::thread_pool{4};
+    const auto text = make_records(20000);
+    const auto js = cjson::detail::input::parse_parallel<cjson::json>(text, pool);
+    REQUIRE(js.size() == 20000);
+    REQUIRE(js == parse(text));
+    REQUIRE(js[12345].at("name") == cjson::json{"a, [b] {c} \"d\", \\"});
+
+    const auto shaped = cjson::detail::input::parse_parallel<cjson::json>(text, pool, {.shared_shapes = true});
+    REQUIRE(shaped[19999].is_shaped_object());
+    REQUIRE(shaped == js);
+}
+
+TEST_CASE("Segments that start inside strings are split at top-level commas") {
+    auto pool = cjson::detail::thread_pool{4};
+    auto text = std::string{"["};
+    for (int i = 0; i < 2000; ++i) {
+        text += (i > 0 ? ", [\"" : "[\"");
+        for (int j = 0; j < 500; ++j) {
+            text += R"(\\\", ] } {[\\)";
+        }
+        text += "\", " + std::to_string(i) + "]";
+    }
+    text += "]";
+    const auto chunks = cjson::detail::input::parallel::split_array(text, 0, text.size() / 16, pool);
+    REQUIRE(chunks.size() > 8);
+    for (const auto& chunk : chunks) {
+        REQUIRE(text.substr(chunk.last, 3) == (&chunk == &chunks.back() ? "]" : ", ["));
+    }
+    const auto js = cjson::detail::input::parse_parallel<cjson::json>(text, pool);
+    REQUIRE(js.size() == 2000);
+    REQUIRE(js == parse(text));
+}
+
+TEST_CASE("Arrays of numbers stay number arrays when joined") {
+    auto pool = cjson::detail::thread_pool{4};
+    auto text = std::string{"["};
+    for (int i = 0; i < 100000; ++i) {
+        text += (i > 0 ? ", " : "") + std::to_string(i * 0.5);
+    }
+    text += "]";
+    const auto js = cjson::detail::input::parse_parallel<cjson::json>(text, pool);
+    REQUIRE(js.is_number_array());
+    REQUIRE(js == parse(text));
+}
+
+TEST_CASE("Other values and small arrays are parsed sequentially") {
+    auto pool = cjson::detail::thread_pool{2};
+    REQUIRE(cjson::detail::input::parse_parallel<cjson::json>(R"( {"a": [1, 2]})", pool) == parse(R"({"a": [1, 2]})"));
+    REQUIRE(cjson::detail::input::parse_parallel<cjson::json>("[1, \"x\"]", pool) == parse("[1, \"x\"]"));
+    REQUIRE(cjson::detail::input::parse_parallel<cjson::json>("42", pool) == cjson::json{42});
+}
+
+TEST_CASE("Errors in a chunk report positions in the whole text") {
+    auto pool = cjson::detail::thread_pool{4};
+    auto text = make_records(20000);
+    text.replace(text.find(R"("id": 15000)"), 4, "@id\"");
+
+    auto expected = cjson::detail::input::json_input_error{cjson::detail::input::invalid_character_error{'@'}};
+    try {
+        static_cast<void>(parse(text));
+        FAIL("sequential parse succeeded");
+    } catch (const cjson::detail::input::json_input_error& error) {
+        expected = error;
+    }
+    try {
+        static_cast<void>(cjson::detail::input::parse_parallel<cjson::json>(text, pool));
+        FAIL("parallel parse succeeded");
+    } catch (const cjson::detail::input::json_input_error& error) {
+        REQUIRE(std::string{error.what()} == expected.what());
+        REQUIRE(error.pos_ == expected.pos_);
+        REQUIRE(error.pos_.line_start_ == 15001);
+    }
+
+    const auto unterminated = make_records(20000).substr(0, 500000);
+    REQUIRE_THROWS_AS(cjson::detail::input::parse_parallel<cjson::json>(unterminated, pool),
+        cjson::detail::input::json_input_error);
+}
+
+TEST_CASE("Content after a large array is read as it is sequentially") {
+    auto pool = cjson::detail::thread_pool{4};
+    const auto text = make_records(20000);
+    REQUIRE(cjson::detail::input::parse_parallel<cjson::json>(text + " \n\t", pool).size() == 20000);
+
+    for (const auto* const rest : {" trailing garbage {", "@"}) {
+        auto expected = std::string{};
+        try {
+            static_cast<void>(parse(text + rest));
+            FAIL("sequential parse succeeded");
+        } catch (const cjson::detail::input::json_input_error& error) {
+            expected = error.what();
+        }
+        REQUIRE_THROWS_WITH(cjson::detail::input::parse_parallel<cjson::json>(text + rest, pool), expected);
+    }
+    REQUIRE(cjson::detail::input::parse_parallel<cjson::json>(text + ", 1", pool) == parse(text + ", 1"));
+
+    auto mismatched = text;
+    mismatched.back() = '}';
+    REQUIRE_THROWS_AS(cjson::detail::input::parse_parallel<cjson::json>(mismatched, pool),
+        cjson::detail::input::json_input_error);
+}
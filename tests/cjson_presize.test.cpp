@@ -0,0 +1,69 @@
+#include <catch2/catch.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_document_stream.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+#include "../include/detail/input/cjson_scanner.hpp"
+
+using cjson::detail::input::parse_options;
+using cjson::detail::input::string_reader;
+using parser = cjson::detail::input::json_parser<string_reader, cjson::json>;
+
+auto element_counts(const std::string_view text) -> std::vector<std::size_t> {
+    auto scanner = cjson::detail::input::json_scanner<string_reader>{std::make_unique<string_reader>(std::string_view{text})};
+    scanner.get_token();
+    auto sizes = std::vector<cjson::detail::input::container_size>{};
+    REQUIRE(scanner.count_elements(sizes));
+    auto counts = std::vector<std::size_t>{};
+    for (const auto& size : sizes) {
+        counts.push_back(size.count_);
+    }
+    // the scanner has not moved
+    REQUIRE(scanner.get_token().pos_.char_start_ == 1);
+    return counts;
+}
+
+TEST_CASE("The prepass counts the elements of every container") {
+    REQUIRE(element_counts(R"([1, [2, 3], {"a": [], "b": "x,]"}, [ ], "[,"] 8)")
+        == std::vector<std::size_t>{5, 2, 2, 0, 0});
+    REQUIRE(element_counts(R"({"k": {"l": [1, 2, 3, 4]}} [1, 2])") == std::vector<std::size_t>{1, 1, 4});
+    REQUIRE(element_counts(R"([1, "unterminated, 2)") == std::vector<std::size_t>{2});
+}
+
+TEST_CASE("Presized parsing reads the same values") {
+    auto wide = std::string{"{"};
+    for (int i = 0; i < 40; ++i) {
+        wide += (i == 0 ? "\"" : ", \"") + std::to_string(i % 7) + "_" + std::to_string(i) + "\": [" + std::to_string(i) + "]";
+    }
+    wide += R"(, "0_0": "duplicate"})";
+    const auto texts = {
+        std::string{R"([1, 2.5, "three", [4, 5], {"six": 6}, null, [true, false]])"},
+        std::string{R"({"a": {"b": [[1], [2, 3]]}, "c": [[5], {"d": 6}]})"},
+        wide
+    };
+    auto options = parse_options{};
+    options.presize = true;
+    for (const auto& text : texts) {
+        for (const auto shared_shapes : {false, true}) {
+            options.shared_shapes = shared_shapes;
+            REQUIRE(parser{options, std::string_view{text}}.parse() == parser{std::string_view{text}}.parse());
+        }
+    }
+    REQUIRE(parser{options, std::string_view{wide}}.parse().at("0_0").dump() == "[0]");
+}
+
+TEST_CASE("Each document of a stream gets its own prepass") {
+    auto options = parse_options{};
+    options.presize = true;
+    auto stream = cjson::detail::input::json_document_stream<string_reader, cjson::json>{
+        options, std::string_view{R"([1, 2, 3] ["a", "b"] {"c": [4]})"}};
+    auto sizes = std::vector<std::size_t>{};
+    for (const auto& document : stream) {
+        sizes.push_back(document.size());
+    }
+    REQUIRE(sizes == std::vector<std::size_t>{3, 2, 1});
+}
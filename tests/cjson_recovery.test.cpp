@@ -0,0 +1,86 @@
+#include <catch2/catch.hpp>
+#include <string_view>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+using parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>;
+using cjson::detail::input::error_code;
+
+auto codes(const std::vector<cjson::detail::input::parse_error>& errors) -> std::vector<error_code> {
+    auto result = std::vector<error_code>{};
+    for (const auto& error : errors) {
+        result.push_back(error.code_);
+    }
+    return result;
+}
+
+TEST_CASE("Every error in a document is reported in one pass") {
+    const auto text = std::string_view{R"({
+    "a": 1,
+    "b": tru,
+    "c": [1, 2 3, 4],
+    "d": "bad \q escape",
+    "e": {"f" 5, "g": 6},
+    "h": "ok"
+})"};
+    auto result = parser{std::string_view{text}}.parse_recovering();
+    REQUIRE(codes(result.errors) == std::vector{error_code::INVALID_CHARACTER, error_code::INVALID_ARRAY,
+                                                error_code::ILLEGAL_ESCAPE, error_code::INVALID_COLON});
+    REQUIRE(result.errors[0].pos_.line_start_ == 2);
+    REQUIRE(result.errors[1].pos_ == cjson::detail::input::position{3, 16, 3, 17});
+    REQUIRE(result.errors[2].message() == "Illegal escape character: '\\q'");
+    REQUIRE(result.errors[3].reason_ == "5");
+    REQUIRE(result.value.dump() == R"({"a": 1, "c": [1, 2, 4], "e": {"g": 6}, "h": "ok"})");
+}
+
+TEST_CASE("Valid input is read without errors") {
+    const auto text = std::string_view{R"({"a": [1, {"b": null}], "c": "d"})"};
+    const auto result = parser{std::string_view{text}}.parse_recovering();
+    REQUIRE(result.errors.empty());
+    REQUIRE(result.value == parser{std::string_view{text}}.parse());
+}
+
+TEST_CASE("A closer of the wrong kind ends only the innermost container") {
+    auto result = parser{std::string_view{R"([[1, 2}, {"b": 3]])"}}.parse_recovering();
+    REQUIRE(codes(result.errors) == std::vector{error_code::INVALID_ARRAY, error_code::INVALID_OBJECT});
+    REQUIRE(result.value.dump() == R"([[1, 2], {"b": 3}])");
+
+    auto first = parser{std::string_view{R"({"a": [1, 2}, "b": tru, "c": @})"}};
+    result = first.parse_recovering();
+    REQUIRE(codes(result.errors) == std::vector{error_code::INVALID_ARRAY, error_code::INVALID_CHARACTER,
+                                                error_code::INVALID_CHARACTER});
+    REQUIRE(result.value.dump() == R"({"a": [1, 2]})");
+    REQUIRE(first.at_end());
+
+    auto second = parser{std::string_view{R"({"x": {"a": [1, 2}, "b": tru}, "y": [1 2], "z": nul, "w": 0})"}};
+    result = second.parse_recovering();
+    REQUIRE(codes(result.errors) == std::vector{error_code::INVALID_ARRAY, error_code::INVALID_CHARACTER,
+                                                error_code::INVALID_ARRAY, error_code::INVALID_CHARACTER});
+    REQUIRE(result.value.dump() == R"({"w": 0, "x": {"a": [1, 2]}, "y": [1]})");
+    REQUIRE(second.at_end());
+}
+
+TEST_CASE("Recovery stops at the error cap and at the end of the input") {
+    auto options = cjson::detail::input::parse_options{};
+    options.max_errors = 2;
+    auto result = parser{options, std::string_view{"[tru, fals, nul, 1]"}}.parse_recovering();
+    REQUIRE(result.errors.size() == 2);
+    REQUIRE(result.value.is_null());
+
+    result = parser{std::string_view{R"(["a", "b)"}}.parse_recovering();
+    REQUIRE(codes(result.errors) == std::vector{error_code::UNTERMINATED_STRING});
+    REQUIRE(result.value.is_null());
+
+    result = parser{std::string_view{"@"}}.parse_recovering();
+    REQUIRE(codes(result.errors) == std::vector{error_code::INVALID_CHARACTER});
+}
+
+TEST_CASE("Shared shapes are not used while recovering") {
+    auto options = cjson::detail::input::parse_options{};
+    options.shared_shapes = true;
+    const auto result = parser{options, std::string_view{R"([{"a": 1, "b": 2}, {"a": 3, "b" 4}])"}}.parse_recovering();
+    REQUIRE(result.errors.size() == 1);
+    REQUIRE(result.value.dump() == R"([{"a": 1, "b": 2}, {"a": 3}])");
+}
@@ -792,3 +792,16 @@ TEST_CASE("Json Errors") {
     REQUIRE_THROWS_MATCHES(scanner.get_token(), cjson::detail::input::json_input_error,
                            Catch::Message("Unterminated string: \"\nworld"));
 }
+
+TEST_CASE("Tokens can be read into an existing token") {
+    auto scanner = make_scanner<cjson::detail::input::string_reader>(R"("a long string that does not fit in place" 12)");
+    auto token = cjson::detail::input::json_token{};
+    scanner.get_token(token);
+    REQUIRE(token.tok_ == cjson::detail::input::token::STRING);
+    REQUIRE(token.spelling_ == "a long string that does not fit in place");
+    const auto* buffer = token.spelling_.data();
+    scanner.get_token(token);
+    REQUIRE(token == cjson::detail::input::json_token{cjson::detail::input::token::NUMBER, "12",
+                                                      cjson::detail::input::position{0, 43, 0, 45}});
+    REQUIRE(token.spelling_.data() == buffer);
+}
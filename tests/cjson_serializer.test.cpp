@@ -0,0 +1,356 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <climits>
+#include <charconv>
+#include <cstdio>
+#include <limits>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <unistd.h>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+#include "../include/detail/output/cjson_fd_sink.hpp"
+#include "../include/detail/output/cjson_iovec_sink.hpp"
+
+auto parse(std::string_view str) -> cjson::json {
+    return cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{std::move(str)}.parse();
+}
+
+auto parse_tracked(std::string_view str) -> cjson::tracked_json {
+    return cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::tracked_json>{std::move(str)}.parse();
+}
+
+TEST_CASE("Compact dump matches stream output") {
+    const auto js = parse(R"({"a": [1, 2, 3], "b": {"c": true, "d": null}, "e": "text"})");
+    auto os = std::ostringstream{};
+    os << js;
+    REQUIRE(js.dump() == os.str());
+    REQUIRE(js.dump() == R"({"a": [1, 2, 3], "b": {"c": true, "d": null}, "e": "text"})");
+}
+
+TEST_CASE("Indented dump") {
+    const auto js = parse(R"({"a": [1, "x"], "b": {"c": false}})");
+    REQUIRE(js.dump(2) ==
+            "{\n"
+            "  \"a\": [\n"
+            "    1,\n"
+            "    \"x\"\n"
+            "  ],\n"
+            "  \"b\": {\n"
+            "    \"c\": false\n"
+            "  }\n"
+            "}");
+}
+
+TEST_CASE("Empty containers dump without newlines") {
+    REQUIRE(cjson::json{cjson::json::object{}}.dump(4) == "{}");
+    REQUIRE(cjson::json{cjson::json::array{}}.dump(4) == "[]");
+}
+
+TEST_CASE("Number arrays and shaped objects dump like generic values") {
+    const auto options = cjson::detail::input::parse_options{.shared_shapes = true};
+    const auto text = std::string_view{R"([{"b": [1, 2], "a": 3}, {"b": [4], "a": 5}])"};
+    auto shaped = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{options, std::string_view{text}}.parse();
+    auto generic = parse(text);
+    REQUIRE(shaped.dump(2) == generic.dump(2));
+    REQUIRE(shaped.dump() == R"([{"a": 3, "b": [1, 2]}, {"a": 5, "b": [4]}])");
+}
+
+TEST_CASE("Compact json dumps through the same serializer") {
+    const auto js = parse(R"({"a": [1, true], "b": "c"})");
+    const auto compact = cjson::compact_json{js};
+    REQUIRE(compact.dump() == js.dump());
+    REQUIRE(compact.dump(1) == js.dump(1));
+}
+
+TEST_CASE("File descriptor sink writes everything on flush") {
+    const auto js = parse(R"({"key": ["value", 1, null]})");
+    auto* file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    const auto fd = ::fileno(file);
+    {
+        auto sink = cjson::detail::output::fd_sink{fd};
+        js.dump_to(sink);
+    }
+    auto contents = std::string(js.dump().size(), '\0');
+    REQUIRE(::pread(fd, contents.data(), contents.size(), 0) == static_cast<ssize_t>(contents.size()));
+    REQUIRE(contents == js.dump());
+    std::fclose(file);
+}
+
+TEST_CASE("Whole numbers are written as integers") {
+    REQUIRE(cjson::json{0}.dump() == "0");
+    REQUIRE(cjson::json{-42}.dump() == "-42");
+    REQUIRE(cjson::json{9007199254740991.0}.dump() == "9007199254740991");
+    REQUIRE(cjson::json{-0.0}.dump() == "-0");
+    REQUIRE(cjson::json{1e300}.dump() == "1e+300");
+}
+
+TEST_CASE("Doubles are written in shortest round-trip form") {
+    REQUIRE(cjson::json{0.1}.dump() == "0.1");
+    REQUIRE(cjson::json{-2.5e-8}.dump() == "-2.5e-08");
+    REQUIRE(cjson::json{1.0 / 3.0}.dump() == "0.3333333333333333");
+    auto value = 1.0;
+    for (int i = 0; i < 1000; ++i) {
+        value = value * 1.37 + 1e-3 / (i + 1);
+        const auto str = cjson::json{value}.dump();
+        auto parsed = 0.0;
+        std::from_chars(str.data(), str.data() + str.size(), parsed);
+        REQUIRE(parsed == value);
+    }
+}
+
+TEST_CASE("Non-finite numbers are written as null") {
+    REQUIRE(cjson::json{std::numeric_limits<double>::infinity()}.dump() == "null");
+    REQUIRE(cjson::json{std::numeric_limits<double>::quiet_NaN()}.dump() == "null");
+}
+
+TEST_CASE("Strings are escaped") {
+    REQUIRE(cjson::json{"say \"hi\"\\"}.dump() == R"("say \"hi\"\\")");
+    REQUIRE(cjson::json{"a\nb\tc\rd\be\f"}.dump() == R"("a\nb\tc\rd\be\f")");
+    REQUIRE(cjson::json{std::string{"\x01\x1f", 2}}.dump() == R"("\u0001\u001f")");
+    REQUIRE(cjson::json{"caf\xC3\xA9"}.dump() == "\"caf\xC3\xA9\"");
+    auto object = cjson::json{cjson::json::object{}};
+    object.emplace("k\"ey", cjson::json{nullptr});
+    REQUIRE(object.dump() == R"({"k\"ey": null})");
+}
+
+TEST_CASE("Escapes are found at every offset of long strings") {
+    for (std::size_t length : {15u, 16u, 31u, 32u, 33u, 70u}) {
+        for (std::size_t pos = 0; pos < length; ++pos) {
+            auto str = std::string(length, 'x');
+            str[pos] = '"';
+            auto expected = std::string(length, 'x');
+            expected.replace(pos, 1, "\\\"");
+            REQUIRE(cjson::json{str}.dump() == "\"" + expected + "\"");
+        }
+    }
+}
+
+TEST_CASE("Ascii-only output escapes non-ascii characters") {
+    const auto options = cjson::detail::output::dump_options{.ascii_only = true};
+    const auto ascii = [&](std::string str) {
+        auto out = std::string{};
+        cjson::json{std::move(str)}.dump_to(cjson::detail::output::string_sink{out}, options);
+        return out;
+    };
+    REQUIRE(ascii("caf\xC3\xA9") == R"("caf\u00e9")");
+    REQUIRE(ascii("\xE2\x82\xAC") == R"("\u20ac")");
+    REQUIRE(ascii("\xF0\x9F\x98\x80!") == R"("\ud83d\ude00!")");
+    REQUIRE(ascii("bad \xFF\xC3") == R"("bad \ufffd\ufffd")");
+    REQUIRE(ascii("\xE0\x80\x80") == R"("\ufffd\ufffd\ufffd")");
+    REQUIRE(ascii(std::string(40, 'a') + "\xC3\xA9") == "\"" + std::string(40, 'a') + R"(\u00e9")");
+}
+
+TEST_CASE("Serialized size is exact") {
+    const auto js = parse(R"({"a": [1, 2.5, -0.125, 1e300], "b": {"c\n": "q\"uote\u0001", "d": null}, "e": [true, false],
+        "f": [0, -0.0, -7, 10, -10, 99, 100, 123456789, -9007199254740991, 9007199254740992, 1e-7], "g": [[["caf\u00e9"]]]})");
+    for (const auto indent : {0u, 1u, 4u}) {
+        for (const auto ascii_only : {false, true}) {
+            const auto options = cjson::detail::output::dump_options{.indent = indent, .ascii_only = ascii_only};
+            auto expected = std::string{};
+            js.dump_to(cjson::detail::output::string_sink{expected}, options);
+            REQUIRE(js.serialized_size(options) == expected.size());
+            REQUIRE(cjson::compact_json{js}.serialized_size(options) == expected.size());
+            auto buffer = std::string(expected.size(), '\0');
+            REQUIRE(js.dump_into(buffer, options) == expected.size());
+            REQUIRE(buffer == expected);
+        }
+    }
+}
+
+TEST_CASE("Dump into a larger buffer leaves the tail untouched") {
+    const auto js = cjson::compact_json{parse(R"(["x", 1])")};
+    auto buffer = std::string(16, '#');
+    const auto written = js.dump_into(buffer);
+    REQUIRE(written == js.serialized_size());
+    REQUIRE(buffer == R"(["x", 1])" + std::string(16 - written, '#'));
+}
+
+TEST_CASE("Dump into a smaller buffer throws instead of writing past it") {
+    const auto js = parse(R"({"key": "a longer string value", "n": [1, 2, 3]})");
+    const auto size = js.serialized_size();
+    for (const auto length : {std::size_t{0}, std::size_t{1}, size / 2, size - 1}) {
+        auto buffer = std::string(size + 8, '#');
+        REQUIRE_THROWS_AS(js.dump_into(std::span{buffer.data(), length}), std::length_error);
+        REQUIRE(buffer.substr(length) == std::string(size + 8 - length, '#'));
+    }
+    auto buffer = std::string(size, '\0');
+    REQUIRE(js.dump_into(buffer) == size);
+    REQUIRE_THROWS_AS(cjson::compact_json{js}.dump_into(std::span{buffer.data(), size - 1}), std::length_error);
+}
+
+auto join(std::span<const iovec> iovecs) -> std::string {
+    auto str = std::string{};
+    for (const auto& iov : iovecs) {
+        str.append(static_cast<const char*>(iov.iov_base), iov.iov_len);
+    }
+    return str;
+}
+
+TEST_CASE("Iovec sink references long strings in place") {
+    auto js = cjson::json{cjson::json::array{}};
+    js.push_back(cjson::json{std::string(4096, 'a')});
+    js.push_back(cjson::json{"short"});
+    js.push_back(cjson::json{std::string(1000, 'b') + "\n" + std::string(1000, 'c')});
+    auto sink = cjson::detail::output::iovec_sink{};
+    js.dump_to(sink);
+    REQUIRE(join(sink.iovecs()) == js.dump());
+    REQUIRE(sink.size() == js.serialized_size());
+    const auto& big = static_cast<const std::string&>(js[0]);
+    const auto referenced = std::any_of(sink.iovecs().begin(), sink.iovecs().end(), [&](const iovec& iov) {
+        return iov.iov_base == big.data() and iov.iov_len == big.size();
+    });
+    REQUIRE(referenced);
+}
+
+TEST_CASE("Iovecs are written to a file descriptor in IOV_MAX batches") {
+    auto js = cjson::json{cjson::json::array{}};
+    for (int i = 0; i < 1500; ++i) {
+        js.push_back(cjson::json{std::string(600, static_cast<char>('a' + i % 26))});
+    }
+    auto sink = cjson::detail::output::iovec_sink{};
+    js.dump_to(sink);
+    REQUIRE(sink.iovecs().size() > IOV_MAX);
+    auto* file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    const auto fd = ::fileno(file);
+    cjson::detail::output::write_iovecs(fd, sink.iovecs());
+    auto contents = std::string(sink.size(), '\0');
+    REQUIRE(::pread(fd, contents.data(), contents.size(), 0) == static_cast<ssize_t>(contents.size()));
+    REQUIRE(contents == js.dump());
+    std::fclose(file);
+}
+
+template <typename Json>
+concept has_revision = requires (const Json& js) { js.revision(); };
+
+TEST_CASE("Only json that tracks revisions carries them") {
+    STATIC_REQUIRE(sizeof(cjson::json) == 16);
+    STATIC_REQUIRE(sizeof(cjson::tracked_json) == 24);
+    STATIC_REQUIRE_FALSE(has_revision<cjson::json>);
+    STATIC_REQUIRE(has_revision<cjson::tracked_json>);
+}
+
+TEST_CASE("Fragment cache reproduces a plain dump") {
+    auto js = parse_tracked(R"({"a": {"b": [1, 2, {"c": "d"}]}, "e": [true, null], "f": "g"})");
+    js.at("a").emplace("long", cjson::tracked_json{std::string(300, 'x')});
+    auto cache = cjson::detail::output::fragment_cache{};
+    REQUIRE(js.dump(cache) == js.dump());
+    REQUIRE(cache.size() == 2);
+    REQUIRE(js.dump(cache) == js.dump());
+    REQUIRE(cache.size() == 2);
+    auto other = cjson::detail::output::fragment_cache{{.indent = 2}};
+    REQUIRE(js.dump(other) == js.dump(2));
+}
+
+TEST_CASE("Mutations re-render only the modified path") {
+    auto js = parse_tracked(R"({"a": {"b": [1, 2]}, "e": {"f": [3, 4]}})");
+    js.at("a").emplace("long", cjson::tracked_json{std::string(300, 'x')});
+    js.at("e").emplace("long", cjson::tracked_json{std::string(300, 'y')});
+    auto cache = cjson::detail::output::fragment_cache{{.indent = 2}};
+    REQUIRE(js.dump(cache) == js.dump(2));
+    REQUIRE(cache.size() == 3);
+    REQUIRE(cache.reused() == 0);
+    REQUIRE(js.dump(cache) == js.dump(2));
+    REQUIRE(cache.reused() == 1);
+
+    const auto revision = js.revision();
+    const auto nested = js.at("a").revision();
+    js.begin();
+    js.at("a").at("b").push_back(cjson::tracked_json{5});
+    REQUIRE(js.revision() == revision);
+    REQUIRE(js.at("a").revision() == nested);
+    REQUIRE(js.dump(cache) == js.dump(2));
+    REQUIRE(cache.reused() == 1);
+    REQUIRE(cache.size() == 3);
+
+    js.at("a").erase("b");
+    REQUIRE(js.dump(cache) == js.dump(2));
+    js.at("e").at("f")[0] = cjson::tracked_json{"three"};
+    REQUIRE(js.dump(cache) == js.dump(2));
+}
+
+TEST_CASE("Writes through references held across a dump are seen") {
+    auto js = parse_tracked(R"({"a": {"n": 1, "m": [1, 2]}, "b": "c"})");
+    js.at("a").emplace("long", cjson::tracked_json{std::string(300, 'x')});
+    auto& n = js.at("a").at("n");
+    auto& m = js.at("a").at("m");
+    auto cache = cjson::detail::output::fragment_cache{};
+    REQUIRE(js.dump(cache) == js.dump());
+    n = cjson::tracked_json{2.0};
+    REQUIRE(js.dump(cache) == js.dump());
+    REQUIRE(js.dump(cache).find(R"("n": 2)") != std::string::npos);
+    m.numbers()[1] = cjson::tracked_json{3};
+    REQUIRE(js.dump(cache) == js.dump());
+    REQUIRE(js.dump(cache).find("[1, 3]") != std::string::npos);
+    auto taken = std::move(m);
+    REQUIRE(js.dump(cache) == js.dump());
+    REQUIRE(js.dump(cache).find(R"("m": null)") != std::string::npos);
+}
+
+TEST_CASE("Writes through references taken after a dump are seen") {
+    const auto padding = std::string(300, 'p');
+    auto js = parse_tracked(R"([{"x": 1}, [1, 2, 3], "s"])");
+    js[0].emplace("pad", cjson::tracked_json{padding});
+    js[1].push_back(cjson::tracked_json{padding});
+    auto cache = cjson::detail::output::fragment_cache{};
+    REQUIRE(js.dump(cache) == js.dump());
+    REQUIRE(cache.size() == 3);
+
+    js[0].at("x") = cjson::tracked_json{2};
+    REQUIRE(js.dump(cache) == js.dump());
+    REQUIRE(js.dump(cache).find(R"("x": 2)") != std::string::npos);
+    static_cast<cjson::tracked_json::array&>(js[1]).pop_back();
+    REQUIRE(js.dump(cache) == R"([{"pad": ")" + padding + R"(", "x": 2}, [1, 2, 3], "s"])");
+    auto moved = std::move(js[0]);
+    REQUIRE(js.dump(cache) == R"([null, [1, 2, 3], "s"])");
+    REQUIRE(moved.dump(cache) == R"({"pad": ")" + padding + R"(", "x": 2})");
+}
+
+TEST_CASE("Fragments the last dump did not reach are dropped") {
+    auto js = parse_tracked(R"([[1], [2]])");
+    js[0].push_back(cjson::tracked_json{std::string(300, 'a')});
+    js[1].push_back(cjson::tracked_json{std::string(300, 'b')});
+    auto cache = cjson::detail::output::fragment_cache{};
+    REQUIRE(js.dump(cache) == js.dump());
+    REQUIRE(cache.size() == 3);
+    js[0].push_back(cjson::tracked_json{1});
+    REQUIRE(js.dump(cache) == js.dump());
+    REQUIRE(cache.size() == 3);
+    js.erase(js.cbegin());
+    REQUIRE(js.dump(cache) == js.dump());
+    REQUIRE(cache.size() == 2);
+}
+
+TEST_CASE("Changes made on another thread are seen") {
+    auto js = parse_tracked(R"({"a": [1, 2], "b": "c"})");
+    js.at("a").push_back(cjson::tracked_json{std::string(300, 'x')});
+    auto cache = cjson::detail::output::fragment_cache{};
+    REQUIRE(js.dump(cache) == js.dump());
+    std::thread{[&] {
+        js.at("a")[0] = cjson::tracked_json{-1};
+    }}.join();
+    REQUIRE(js.dump(cache) == js.dump());
+    REQUIRE(js.dump(cache).find("-1") != std::string::npos);
+}
+
+TEST_CASE("Reallocating an array keeps the dump consistent") {
+    auto js = cjson::tracked_json{cjson::tracked_json::array{}};
+    auto cache = cjson::detail::output::fragment_cache{};
+    for (int i = 0; i < 100; ++i) {
+        auto row = cjson::tracked_json{cjson::tracked_json::object{}};
+        row.emplace("i", cjson::tracked_json{i});
+        row.emplace("pad", cjson::tracked_json{std::string(300, 'p')});
+        js.push_back(std::move(row));
+        REQUIRE(js.dump(cache) == js.dump());
+    }
+    js[50].at("i") = cjson::tracked_json{-1};
+    REQUIRE(js.dump(cache) == js.dump());
+}
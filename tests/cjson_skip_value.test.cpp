@@ -0,0 +1,137 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+#include "../include/detail/input/cjson_scanner.hpp"
+
+using cjson::detail::input::error_code;
+using cjson::detail::input::json_token;
+using cjson::detail::input::parse_options;
+using cjson::detail::input::skip_mode;
+using cjson::detail::input::string_reader;
+using parser = cjson::detail::input::json_parser<string_reader, cjson::json>;
+
+// hands out one character at a time, so the scanner cannot skip in bulk
+class char_reader: cjson::detail::input::json_reader {
+public:
+    char_reader() noexcept = default;
+    char_reader(std::string_view&& str) noexcept
+        : str_{str} {}
+
+    char_reader(char_reader&&) noexcept = default;
+
+    auto operator=(char_reader&&) noexcept -> char_reader& = default;
+
+    ~char_reader() noexcept override = default;
+
+    auto advance() noexcept -> char override {
+        return pos_ < str_.size() ? str_[pos_++] : _CHAR_END;
+    }
+
+private:
+    std::string_view str_;
+    std::size_t pos_ = 0;
+};
+
+template <typename Reader>
+auto skip_then_scan(const std::string_view text, const skip_mode mode) -> std::pair<bool, json_token> {
+    auto scanner = cjson::detail::input::json_scanner<Reader>{std::make_unique<Reader>(std::string_view{text})};
+    auto token = json_token{};
+    const auto skipped = scanner.skip_value(mode);
+    if (skipped) {
+        scanner.get_token(token);
+    }
+    return {skipped, token};
+}
+
+template <typename Reader>
+auto skip_error(const std::string_view text, const skip_mode mode) -> cjson::detail::input::parse_error {
+    auto scanner = cjson::detail::input::json_scanner<Reader>{std::make_unique<Reader>(std::string_view{text})};
+    REQUIRE_FALSE(scanner.skip_value(mode));
+    return scanner.error();
+}
+
+TEST_CASE("Skipping a value leaves the scanner on the token after it") {
+    const auto texts = {
+        std::string_view{R"({"a": [1, 2, {"b": "}]"}],	"c": "\"{"} , 7)"},
+        std::string_view{"[\n\t\"x\",\n  [[], {}],\n\t\t{\"y\": null}\n]\t\t: 1"},
+        std::string_view{R"("plain \\" ] x)"},
+        std::string_view{"  -12.5e3,"},
+        std::string_view{"true}"}
+    };
+    for (const auto text : texts) {
+        for (const auto mode : {skip_mode::BALANCED, skip_mode::MATCHED, skip_mode::VALIDATED}) {
+            const auto bulk = skip_then_scan<string_reader>(text, mode);
+            const auto single = skip_then_scan<char_reader>(text, mode);
+            REQUIRE(bulk.first);
+            REQUIRE(bulk.second == single.second);
+        }
+    }
+    const auto [skipped, token] = skip_then_scan<string_reader>("[\n\t\"x\",\n  [[], {}],\n\t\t{\"y\": null}\n]\t\t: 1",
+        skip_mode::MATCHED);
+    REQUIRE(token.spelling_ == ":");
+    REQUIRE(token.pos_ == cjson::detail::input::position{4, 10, 4, 11});
+}
+
+TEST_CASE("Skipping checks as much as the mode asks for") {
+    REQUIRE(skip_then_scan<string_reader>("[1, 2} 3", skip_mode::BALANCED).first);
+    REQUIRE(skip_then_scan<string_reader>("[tru, 2] 3", skip_mode::MATCHED).first);
+
+    const auto mismatched = skip_error<string_reader>("[1, {\"a\": 2]]", skip_mode::MATCHED);
+    REQUIRE(mismatched.code_ == error_code::INVALID_OBJECT);
+    REQUIRE(mismatched.offset_ == 11);
+    REQUIRE(skip_error<char_reader>("[1, {\"a\": 2]]", skip_mode::MATCHED).offset_ == 11);
+    REQUIRE(skip_error<string_reader>("[1, 2}", skip_mode::VALIDATED).code_ == error_code::INVALID_ARRAY);
+    REQUIRE(skip_error<string_reader>("[tru, 2] 3", skip_mode::VALIDATED).code_ == error_code::INVALID_CHARACTER);
+    REQUIRE(skip_error<string_reader>(", 1", skip_mode::BALANCED).code_ == error_code::INVALID_JSON_VALUE);
+}
+
+TEST_CASE("Skipping reports truncated values") {
+    for (const auto mode : {skip_mode::BALANCED, skip_mode::VALIDATED}) {
+        const auto bulk = skip_error<string_reader>("[1, {\"a\": 2}", mode);
+        REQUIRE(bulk.code_ == error_code::TRUNCATED_INPUT);
+        REQUIRE(bulk.message() == "Unexpected end of input at byte 12");
+        REQUIRE(skip_error<char_reader>("[1, {\"a\": 2}", mode).message() == bulk.message());
+    }
+    REQUIRE(skip_error<string_reader>(R"(["a", "b\")", skip_mode::MATCHED).code_ == error_code::UNTERMINATED_STRING);
+    REQUIRE(skip_error<char_reader>(R"(["a", "b\")", skip_mode::MATCHED).code_ == error_code::UNTERMINATED_STRING);
+    REQUIRE(skip_error<string_reader>("   ", skip_mode::MATCHED).code_ == error_code::TRUNCATED_INPUT);
+}
+
+TEST_CASE("A member filter leaves out the members it rejects") {
+    const auto text = std::string_view{R"({"id": 7, "blob": {"x": [1, 2, "]"]}, "tags": ["a"], "name": {"id": 1, "n": 2}})"};
+    auto options = parse_options{};
+    options.member_filter = [](const std::string_view key, const std::size_t depth) {
+        return depth > 1 ? key == "n" : key == "id" or key == "name";
+    };
+    for (const auto shared_shapes : {false, true}) {
+        options.shared_shapes = shared_shapes;
+        auto json_parser = parser{options, std::string_view{text}};
+        REQUIRE(json_parser.parse().dump() == R"({"id": 7, "name": {"n": 2}})");
+        REQUIRE(json_parser.at_end());
+    }
+
+    options.member_filter = [](const std::string_view, const std::size_t) { return false; };
+    REQUIRE(parser{options, std::string_view{text}}.parse().dump() == "{}");
+}
+
+TEST_CASE("Errors in skipped members are still reported") {
+    auto options = parse_options{};
+    options.member_filter = [](const std::string_view key, const std::size_t) { return key == "a"; };
+    REQUIRE(parser{options, std::string_view{R"({"a": 1, "b": [1, 2})"}}.try_parse().error().code_
+        == error_code::INVALID_ARRAY);
+    REQUIRE(parser{options, std::string_view{R"({"a": 1, "b" [1]})"}}.try_parse().error().code_
+        == error_code::INVALID_COLON);
+
+    options.skip = skip_mode::BALANCED;
+    REQUIRE(parser{options, std::string_view{R"({"a": 1, "b": [1, 2}})"}}.parse().dump() == R"({"a": 1})");
+
+    options.skip = skip_mode::MATCHED;
+    const auto result = parser{options, std::string_view{R"([{"b": [1}, {"a": 1, "b": 0}])"}}.parse_recovering();
+    REQUIRE(result.errors.size() == 1);
+    REQUIRE(result.errors.front().code_ == error_code::INVALID_ARRAY);
+    REQUIRE(result.value.dump() == R"([{}, {"a": 1}])");
+}
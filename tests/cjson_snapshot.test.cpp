@@ -0,0 +1,114 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_mapped_file.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+#include "../include/detail/input/cjson_snapshot_view.hpp"
+#include "../include/detail/output/cjson_snapshot_writer.hpp"
+
+using cjson::detail::input::snapshot_view;
+
+auto parse(std::string_view str) -> cjson::json {
+    return cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>{std::move(str)}.parse();
+}
+
+template <typename Json>
+auto write(const Json& js) -> std::string {
+    auto bytes = std::string{};
+    cjson::detail::output::snapshot_writer{bytes}.dump(js);
+    return bytes;
+}
+
+const auto document = std::string_view{
+    R"({"name": "reference", "version": 3, "enabled": true, "missing": null, )"
+    R"("weights": [0.5, 1.5, -2], "items": [{"id": 1, "tags": ["a", "b"]}, {"id": 2, "tags": ["c"]}]})"};
+
+TEST_CASE("Snapshot views navigate values in place") {
+    const auto bytes = write(parse(document));
+    const auto root = snapshot_view::root(bytes);
+    REQUIRE(root.is_object());
+    REQUIRE(root.size() == 6);
+    REQUIRE(root["name"].string() == "reference");
+    REQUIRE(root["version"].number() == 3);
+    REQUIRE(root["enabled"].boolean());
+    REQUIRE(root["missing"].is_null());
+    REQUIRE(root["weights"].is_array());
+    REQUIRE(root["weights"].size() == 3);
+    REQUIRE(root["weights"][2].number() == -2);
+    REQUIRE(root["items"][1]["id"].number() == 2);
+    REQUIRE(root["items"][0]["tags"][1].string() == "b");
+    REQUIRE(root["items"][1]["tags"].size() == 1);
+    REQUIRE(snapshot_view::root(write(cjson::json{cjson::json::array{}})).empty());
+    REQUIRE(snapshot_view::root(write(cjson::json{cjson::json::object{}})).empty());
+    REQUIRE_FALSE(root.find("absent"));
+    REQUIRE_FALSE(root["items"][0].find("name"));
+    REQUIRE_THROWS_AS(root.at("absent"), std::out_of_range);
+    REQUIRE_THROWS_AS(root["weights"][3], std::out_of_range);
+    REQUIRE_THROWS_AS(root["name"].number(), cjson::detail::json_type_error);
+}
+
+TEST_CASE("Object members are visited in key order") {
+    const auto bytes = write(parse(document));
+    const auto root = snapshot_view::root(bytes);
+    auto keys = std::string{};
+    for (std::size_t i = 0; i < root.size(); ++i) {
+        keys += root.key(i);
+        keys += ' ';
+    }
+    REQUIRE(keys == "enabled items missing name version weights ");
+}
+
+TEST_CASE("Snapshots copy back into equal json values") {
+    const auto js = parse(document);
+    const auto bytes = write(js);
+    REQUIRE(snapshot_view::root(bytes).to_json<cjson::json>() == js);
+    REQUIRE(snapshot_view::root(bytes)["weights"].to_json<cjson::json>().is_number_array());
+    REQUIRE(snapshot_view::root(write(cjson::json{"scalar"})).string() == "scalar");
+
+    using interned_parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::interned_json>;
+    const auto interned = interned_parser{std::string_view{document}}.parse();
+    REQUIRE(write(interned) == bytes);
+    REQUIRE(snapshot_view::root(bytes).to_json<cjson::interned_json>() == interned);
+}
+
+TEST_CASE("Snapshots can be mapped from a file") {
+    auto path = std::string{"/tmp/cjson_snapshot_XXXXXX"};
+    const auto fd = ::mkstemp(path.data());
+    REQUIRE(fd >= 0);
+    ::close(fd);
+    const auto js = parse(document);
+    std::ofstream{path, std::ios::binary} << write(js);
+    {
+        const auto file = cjson::detail::input::mapped_file{path};
+        REQUIRE(snapshot_view::root(file.bytes())["items"][0]["tags"][0].string() == "a");
+        REQUIRE(snapshot_view::root(file.bytes()).to_json<cjson::json>() == js);
+    }
+    std::remove(path.c_str());
+    REQUIRE_THROWS_AS(cjson::detail::input::mapped_file{path}, std::system_error);
+}
+
+TEST_CASE("Corrupt snapshots are rejected") {
+    using cjson::detail::input::json_input_error;
+    auto bytes = write(parse(document));
+    REQUIRE_THROWS_AS(snapshot_view::root(std::string_view{bytes}.substr(0, 20)), json_input_error);
+    REQUIRE_THROWS_AS(snapshot_view::root("not a snapshot at all, but long enough to hold a header"), json_input_error);
+
+    for (std::size_t size = 0; size < bytes.size(); ++size) {
+        REQUIRE_THROWS_AS(snapshot_view::root(std::string_view{bytes}.substr(0, size)), json_input_error);
+    }
+
+    // offsets are checked when followed, so a damaged block fails on access
+    auto head = cjson::detail::snapshot::header{};
+    std::memcpy(&head, bytes.data(), sizeof(head));
+    head.root.payload = bytes.size() - 4;
+    std::memcpy(bytes.data(), &head, sizeof(head));
+    REQUIRE(snapshot_view::root(bytes).is_object());
+    REQUIRE_THROWS_AS(snapshot_view::root(bytes).size(), json_input_error);
+}
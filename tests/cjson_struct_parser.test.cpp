@@ -0,0 +1,136 @@
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/detail/input/cjson_struct_parser.hpp"
+
+namespace records {
+    struct address {
+        std::string city;
+        std::string zip;
+    };
+    CJSON_DESCRIBE(address, city, zip)
+
+    struct user {
+        std::int64_t id = 0;
+        std::string name;
+        double score = 0;
+        bool active = false;
+        std::vector<std::string> tags;
+        address home;
+        std::optional<std::string> nickname;
+        std::map<std::string, int> counters;
+        std::vector<address> previous;
+    };
+    CJSON_DESCRIBE(user, id, name, score, active, tags, home, nickname, counters, previous)
+
+    struct empty {};
+    CJSON_DESCRIBE(empty)
+}
+
+using parser = cjson::detail::input::struct_parser<cjson::detail::input::string_reader>;
+using cjson::detail::input::error_code;
+
+TEST_CASE("Member names hash to slots of their own") {
+    using index = cjson::detail::reflect::key_index<records::user>;
+    STATIC_REQUIRE(index::size == 9);
+    STATIC_REQUIRE(index::find("id") == 0);
+    STATIC_REQUIRE(index::find("previous") == 8);
+    for (std::size_t i = 0; i < index::size; ++i) {
+        REQUIRE(index::find(index::name(i)) == i);
+    }
+    REQUIRE(index::find("") == index::size);
+    REQUIRE(index::find("nick") == index::size);
+    REQUIRE(index::find("previouss") == index::size);
+}
+
+TEST_CASE("A nested object is read into described structs") {
+    const auto text = std::string_view{R"({
+        "id": 42, "name": "ada \"l\"", "score": -1.5e2, "active": true,
+        "tags": ["x", "y\n"], "home": {"city": "london", "zip": "n1"},
+        "nickname": "al", "counters": {"a": 1, "b": -2},
+        "previous": [{"city": "paris", "zip": "75"}, {"zip": "10", "city": "rome"}]
+    })"};
+    const auto value = parser{std::string_view{text}}.parse<records::user>();
+    REQUIRE(value.id == 42);
+    REQUIRE(value.name == "ada \"l\"");
+    REQUIRE(value.score == -150.0);
+    REQUIRE(value.active);
+    REQUIRE(value.tags == std::vector<std::string>{"x", "y\n"});
+    REQUIRE(value.home.city == "london");
+    REQUIRE(value.home.zip == "n1");
+    REQUIRE(value.nickname == "al");
+    REQUIRE(value.counters == std::map<std::string, int>{{"a", 1}, {"b", -2}});
+    REQUIRE(value.previous.size() == 2);
+    REQUIRE(value.previous[1].city == "rome");
+    REQUIRE(value.previous[1].zip == "10");
+}
+
+TEST_CASE("Unknown members are skipped and missing ones keep their defaults") {
+    const auto text = std::string_view{
+        R"({"extra": {"deep": [1, {"id": 7}, "]"]}, "name": "b", "more": null, "nickname": null})"};
+    const auto value = parser{std::string_view{text}}.parse<records::user>();
+    REQUIRE(value.id == 0);
+    REQUIRE(value.name == "b");
+    REQUIRE(not value.nickname);
+    REQUIRE(value.tags.empty());
+}
+
+TEST_CASE("Empty objects and arrays are read") {
+    auto json_parser = parser{std::string_view{R"({"tags": [], "counters": {}, "home": {}} {})"}};
+    const auto value = json_parser.parse<records::user>();
+    REQUIRE(value.tags.empty());
+    REQUIRE(value.counters.empty());
+    json_parser.parse<records::empty>();
+    REQUIRE(json_parser.at_end());
+}
+
+TEST_CASE("Top-level values need not be structs") {
+    REQUIRE(parser{std::string_view{"[1, 2, 3]"}}.parse<std::vector<int>>() == std::vector<int>{1, 2, 3});
+    REQUIRE(parser{std::string_view{"\"s\""}}.parse<std::string>() == "s");
+    REQUIRE(parser{std::string_view{"null"}}.parse<std::optional<int>>() == std::nullopt);
+    REQUIRE(parser{std::string_view{"[[1], [2, 3]]"}}.parse<std::vector<std::vector<std::uint8_t>>>().back().size() == 2);
+}
+
+TEST_CASE("Values that do not fit the target type are reported") {
+    const auto cases = std::vector<std::pair<std::string_view, error_code>>{
+        {R"({"id": "7"})", error_code::TYPE_MISMATCH},
+        {R"({"id": 1.5})", error_code::TYPE_MISMATCH},
+        {R"({"id": 1e3})", error_code::TYPE_MISMATCH},
+        {R"({"id": 99999999999999999999})", error_code::NUMBER_OUT_OF_RANGE},
+        {R"({"name": null})", error_code::TYPE_MISMATCH},
+        {R"({"active": 1})", error_code::TYPE_MISMATCH},
+        {R"({"tags": "x"})", error_code::TYPE_MISMATCH},
+        {R"({"home": []})", error_code::TYPE_MISMATCH},
+        {R"({"counters": {"a": true}})", error_code::TYPE_MISMATCH},
+        {R"([1])", error_code::TYPE_MISMATCH},
+        {R"({"id": ])", error_code::INVALID_JSON_VALUE},
+        {R"({"id": 1 "name": "x"})", error_code::INVALID_OBJECT},
+        {R"({"tags": ["a" "b"]})", error_code::INVALID_ARRAY},
+        {R"({1: 2})", error_code::INVALID_KEY},
+        {R"({"id" 2})", error_code::INVALID_COLON},
+        {R"({"extra": [1, 2})", error_code::INVALID_ARRAY},
+        {R"({"extra": "unterminated)", error_code::UNTERMINATED_STRING},
+        {R"({"name": "bad \q"})", error_code::ILLEGAL_ESCAPE},
+    };
+    for (const auto& [text, code] : cases) {
+        CAPTURE(text);
+        const auto result = parser{std::string_view{text}}.try_parse<records::user>();
+        REQUIRE(not result);
+        REQUIRE(result.error().code_ == code);
+    }
+}
+
+TEST_CASE("The throwing api raises what try_parse reports") {
+    const auto text = std::string_view{R"({"home": {"city": 3}})"};
+    const auto result = parser{std::string_view{text}}.try_parse<records::user>();
+    REQUIRE(not result);
+    REQUIRE(result.error().message() == R"(Unexpected json value for the target type: got "3" instead)");
+    REQUIRE(result.error().pos_.line_start_ == 0);
+    REQUIRE(result.error().pos_.char_start_ == 18);
+    REQUIRE_THROWS_WITH(parser{std::string_view{text}}.parse<records::user>(), result.error().message());
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+#include "../include/detail/input/cjson_struct_parser.hpp"
+#include "../include/detail/output/cjson_struct_serializer.hpp"
+
+// members are declared in key order, the order in which basic_json dumps them
+namespace records {
+    struct address {
+        std::string city;
+        std::string zip;
+
+        friend auto operator==(const address&, const address&) -> bool = default;
+    };
+    CJSON_DESCRIBE(address, city, zip)
+
+    struct user {
+        bool active = false;
+        std::map<std::string, double> counters;
+        address home;
+        std::int64_t id = 0;
+        std::string name;
+        std::optional<std::string> nickname;
+        std::vector<address> previous;
+        double score = 0;
+        std::vector<std::string> tags;
+
+        friend auto operator==(const user&, const user&) -> bool = default;
+    };
+    CJSON_DESCRIBE(user, active, counters, home, id, name, nickname, previous, score, tags)
+
+    struct empty {};
+    CJSON_DESCRIBE(empty)
+
+    struct wrapper {
+        empty nothing;
+        std::vector<int> none;
+    };
+    CJSON_DESCRIBE(wrapper, nothing, none)
+}
+
+using cjson::detail::output::dump_options;
+using cjson::detail::output::string_sink;
+using cjson::detail::output::struct_serializer;
+using dom_parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>;
+using struct_parser = cjson::detail::input::struct_parser<cjson::detail::input::string_reader>;
+
+template <typename T>
+auto dump(const T& value, const dump_options& options = {}) -> std::string {
+    auto str = std::string{};
+    auto sink = string_sink{str};
+    struct_serializer<string_sink>{sink, options}.dump(value);
+    return str;
+}
+
+auto sample() -> records::user {
+    auto value = records::user{};
+    value.active = true;
+    value.counters = {{"a", 1}, {"b", -2.5}};
+    value.home = {"london \"east\"", "n1"};
+    value.id = 42;
+    value.name = "ada\n\x01";
+    value.previous = {{"paris", "75"}, {"rome", "10"}};
+    value.score = 0.1;
+    value.tags = {"x", "y"};
+    return value;
+}
+
+TEST_CASE("A described struct dumps like the equivalent basic_json") {
+    const auto value = sample();
+    const auto text = dump(value);
+    REQUIRE(text == dom_parser{std::string_view{text}}.parse().dump());
+    REQUIRE(text.starts_with(R"({"active": true, "counters": {"a": 1, "b": -2.5}, "home": {"city": "london \"east\"")"));
+    REQUIRE(text.find(R"("name": "ada\n\u0001", "nickname": null)") != std::string::npos);
+    const auto indented = dump(value, dump_options{.indent = 2});
+    REQUIRE(indented == dom_parser{std::string_view{text}}.parse().dump(2));
+}
+
+TEST_CASE("A dumped struct parses back to the same value") {
+    const auto value = sample();
+    REQUIRE(struct_parser{std::string_view{dump(value)}}.parse<records::user>() == value);
+    auto nicknamed = value;
+    nicknamed.nickname = "al";
+    REQUIRE(struct_parser{std::string_view{dump(nicknamed)}}.parse<records::user>() == nicknamed);
+}
+
+TEST_CASE("Empty structs and containers dump without members") {
+    REQUIRE(dump(records::empty{}) == "{}");
+    REQUIRE(dump(records::wrapper{}) == R"({"nothing": {}, "none": []})");
+    REQUIRE(dump(records::wrapper{}, dump_options{.indent = 4}) == "{\n    \"nothing\": {},\n    \"none\": []\n}");
+}
+
+TEST_CASE("Values other than structs dump too") {
+    REQUIRE(dump(std::vector<std::optional<int>>{1, std::nullopt, 3}) == "[1, null, 3]");
+    REQUIRE(dump(std::map<std::string, bool>{{"k", false}}) == R"({"k": false})");
+    REQUIRE(dump(std::string_view{"caf\xc3\xa9"}, dump_options{.ascii_only = true}) == R"("caf\u00e9")");
+    REQUIRE(dump(std::int64_t{9007199254740993}) == "9007199254740993");
+}
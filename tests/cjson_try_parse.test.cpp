@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/cjson_fwd.hpp"
+#include "../include/detail/input/cjson_parser.hpp"
+
+using parser = cjson::detail::input::json_parser<cjson::detail::input::string_reader, cjson::json>;
+using cjson::detail::input::error_code;
+
+TEST_CASE("Valid input gives the same value as the throwing api") {
+    const auto text = std::string_view{R"({"a": [1, 2.5, -3e2], "b": {"c": "d\n", "e": [true, null, "x"]}})"};
+    auto result = parser{std::string_view{text}}.try_parse();
+    REQUIRE(result.has_value());
+    REQUIRE(*result == parser{std::string_view{text}}.parse());
+    REQUIRE(result->at("b").at("c") == cjson::json{"d\n"});
+    REQUIRE(std::move(result).value().size() == 2);
+}
+
+TEST_CASE("Malformed input reports what the exception would have said") {
+    const auto cases = std::vector<std::pair<std::string_view, error_code>>{
+        {"\"hello world", error_code::UNTERMINATED_STRING},
+        {"\"hello \\z world\"", error_code::ILLEGAL_ESCAPE},
+        {"\"\\uXYZA\"", error_code::INVALID_UNICODE_ESCAPE},
+        {"[1, @]", error_code::INVALID_CHARACTER},
+        {"-abc", error_code::INVALID_MINUS},
+        {"3.abc", error_code::INVALID_FRACTION},
+        {"3eabc", error_code::INVALID_EXPONENT},
+        {"3e+abc", error_code::INVALID_EXPONENT_SIGN},
+        {"[1e999]", error_code::NUMBER_OUT_OF_RANGE},
+        {"[1, 2 3]", error_code::INVALID_ARRAY},
+        {"{1: 2}", error_code::INVALID_KEY},
+        {R"({"a" 2})", error_code::INVALID_COLON},
+        {R"({"a": 2 "b"})", error_code::INVALID_OBJECT},
+        {"[1, ]", error_code::INVALID_JSON_VALUE},
+        {"", error_code::INVALID_JSON_VALUE},
+    };
+    for (const auto& [text, code] : cases) {
+        CAPTURE(text);
+        const auto result = parser{std::string_view{text}}.try_parse();
+        REQUIRE_FALSE(result);
+        REQUIRE(result.error().code_ == code);
+        try {
+            parser{std::string_view{text}}.parse();
+            FAIL("invalid input was accepted");
+        } catch (const cjson::detail::input::json_input_error& error) {
+            REQUIRE(result.error().message() == error.what());
+            REQUIRE(result.error().pos_ == error.pos_);
+        }
+        REQUIRE_THROWS_AS(result.value(), cjson::detail::input::json_input_error);
+    }
+}
+
+TEST_CASE("Errors carry the byte offset and position of the failing token") {
+    auto result = parser{std::string_view{"{\"a\": [1,\n\t2, tru]}"}}.try_parse();
+    REQUIRE(result.error().code_ == error_code::INVALID_CHARACTER);
+    REQUIRE(result.error().offset_ == 14);
+    REQUIRE(result.error().pos_ == cjson::detail::input::position{1, 9, 1, 12});
+    REQUIRE(result.error().message() == "Invalid character: 't'");
+
+    result = parser{std::string_view{R"({"a": 1, "b" "c"})"}}.try_parse();
+    REQUIRE(result.error().code_ == error_code::INVALID_COLON);
+    REQUIRE(result.error().offset_ == 13);
+    REQUIRE(result.error().reason_ == "c");
+}
+
+TEST_CASE("A failed parser keeps reporting its error until reset") {
+    auto json_parser = parser{std::string_view{"[1, 2] @ [3]"}};
+    REQUIRE_FALSE(json_parser.try_parse());
+    REQUIRE_FALSE(json_parser.at_end());
+    REQUIRE(json_parser.try_parse().error().code_ == error_code::INVALID_CHARACTER);
+    json_parser.reset(std::string_view{"[3, 4]"});
+    REQUIRE(json_parser.try_parse().value().dump() == "[3, 4]");
+    REQUIRE(json_parser.at_end());
+}